@@ -0,0 +1,90 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <boost/program_options.hpp>
+#include <hoibase/file/asset_archive.hpp>
+#include <hoibase/file/asset_archive_builder.hpp>
+#include <hoibase/file/file_access.hpp>
+#include <hoibase/openhoi.hpp>
+#include <iostream>
+
+#define TITLE OPENHOI_GAME_NAME " asset packer v" OPENHOI_GAME_VERSION
+
+namespace po = boost::program_options;
+
+using namespace openhoi;
+
+// Main entry point of program
+int main(int argc, const char* argv[]) {
+  // Print out header
+  std::cout << TITLE << std::endl;
+  std::cout << "Copyright (c) the openhoi authors" << std::endl;
+  std::cout << OPENHOI_GIT_URL << std::endl << std::endl;
+
+  // Parse program options
+  filesystem::path inputDirectory, outputFile;
+  int level;
+  po::options_description desc("Options");
+  desc.add_options()("help", "Produce help message")(
+      "input", po::value<filesystem::path>(&inputDirectory),
+      "Path to the asset root directory (defaults to the game asset root "
+      "directory)")(
+      "output", po::value<filesystem::path>(&outputFile),
+      "Path to the asset archive file (defaults to '" OPENHOI_ASSET_ARCHIVE_FILE
+      "' inside the asset root directory)")(
+      "level", po::value<int>(&level)->default_value(6),
+      "zlib compression level from 0 (store only) to 9");
+  po::positional_options_description positional;
+  positional.add("input", 1).add("output", 1);
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv)
+                  .options(desc)
+                  .positional(positional)
+                  .run(),
+              vm);
+    if (vm.count("help")) {
+      std::cout << desc << std::endl;
+      return EXIT_SUCCESS;
+    }
+    po::notify(vm);
+    if (level < 0 || level > 9)
+      throw po::validation_error(po::validation_error::invalid_option_value,
+                                 "level");
+  } catch (po::error const& e) {
+    std::cerr << e.what() << std::endl << std::endl << desc << std::endl;
+    return EXIT_FAILURE;
+  }
+  try {
+    if (inputDirectory.empty())
+      inputDirectory = FileAccess::getAssetRootDirectory();
+  } catch (std::exception const& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (outputFile.empty())
+    outputFile = inputDirectory / OPENHOI_ASSET_ARCHIVE_FILE;
+
+  // Pack the asset root directory
+  if (!AssetArchiveBuilder::build(inputDirectory, outputFile, level)) {
+    std::cerr << "Unable to pack '" << inputDirectory.u8string() << "' into '"
+              << outputFile.u8string() << "'" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Read the archive back to report what was packed
+  AssetArchive archive(outputFile);
+  if (!archive.isOpen()) {
+    std::cerr << "Unable to read asset archive '" << outputFile.u8string()
+              << "'" << std::endl;
+    return EXIT_FAILURE;
+  }
+  size_t compressedCount = 0;
+  for (size_t i = 0; i < archive.getEntryCount(); i++)
+    if (archive.getEntry(i).flags & OPENHOI_ASSET_ARCHIVE_ZLIB)
+      compressedCount++;
+
+  std::cout << "Packed " << archive.getEntryCount() << " files ("
+            << compressedCount << " compressed) into '"
+            << outputFile.u8string() << "'" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,35 @@
+# We want Google Benchmark 1.5.2
+set(GBENCHMARK_VERSION 1.5.2 CACHE STRING "Google benchmark version")
+
+# Do not build the tests of Google Benchmark itself
+set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+
+set(GOOGLE_BENCHMARK_GIT_REPO https://github.com/google/benchmark.git)
+set(GOOGLE_BENCHMARK_GIT_TAG v${GBENCHMARK_VERSION})
+
+# Fetch Google Benchmark
+if(${CMAKE_VERSION} VERSION_LESS 3.11)
+  message(FATAL_ERROR "Building the benchmarks requires CMake 3.11 or newer")
+endif()
+
+# Include FetchContent module
+include(FetchContent)
+
+# see https://cliutils.gitlab.io/modern-cmake/chapters/projects/fetch.html
+if(${CMAKE_VERSION} VERSION_LESS 3.14)
+  macro(FetchContent_MakeAvailable NAME)
+      FetchContent_GetProperties(${NAME})
+      if(NOT ${NAME}_POPULATED)
+          FetchContent_Populate(${NAME})
+          add_subdirectory(${${NAME}_SOURCE_DIR} ${${NAME}_BINARY_DIR})
+      endif()
+  endmacro()
+endif()
+
+FetchContent_Declare(googlebenchmark
+                     GIT_REPOSITORY ${GOOGLE_BENCHMARK_GIT_REPO}
+                     GIT_TAG ${GOOGLE_BENCHMARK_GIT_TAG})
+
+FetchContent_MakeAvailable(googlebenchmark)
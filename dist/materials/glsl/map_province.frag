@@ -0,0 +1,15 @@
+#version 120
+
+// Looks up the province color in the province color table
+
+uniform sampler2D colorTable;
+uniform vec4 colorTableSize;
+
+varying float province;
+
+void main() {
+  float index = floor(province + 0.5);
+  float row = floor(index / colorTableSize.x);
+  vec2 texel = vec2(index - row * colorTableSize.x, row) + 0.5;
+  gl_FragColor = texture2D(colorTable, texel / colorTableSize.xy);
+}
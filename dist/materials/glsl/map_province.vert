@@ -0,0 +1,15 @@
+#version 120
+
+// Transforms the map mesh and passes the province handle on
+
+attribute vec4 vertex;
+attribute float uv0;
+
+uniform mat4 worldViewProj;
+
+varying float province;
+
+void main() {
+  gl_Position = worldViewProj * vertex;
+  province = uv0;
+}
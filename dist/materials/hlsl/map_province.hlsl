@@ -0,0 +1,21 @@
+// Transforms the map mesh and passes the province handle on
+void map_province_vs(float4 position : POSITION, float province : TEXCOORD0,
+                     uniform float4x4 worldViewProj,
+                     out float4 outPosition : SV_POSITION,
+                     out float outProvince : TEXCOORD0) {
+  outPosition = mul(worldViewProj, position);
+  outProvince = province;
+}
+
+// Looks up the province color in the province color table
+Texture2D colorTable : register(t0);
+SamplerState colorTableSampler : register(s0);
+
+float4 map_province_ps(float4 position : SV_POSITION,
+                       float province : TEXCOORD0,
+                       uniform float4 colorTableSize) : SV_TARGET {
+  float index = floor(province + 0.5);
+  float row = floor(index / colorTableSize.x);
+  float2 texel = float2(index - row * colorTableSize.x, row) + 0.5;
+  return colorTable.Sample(colorTableSampler, texel / colorTableSize.xy);
+}
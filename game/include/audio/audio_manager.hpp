@@ -5,18 +5,34 @@
 #include <al.h>
 #include <alc.h>
 
-#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <hoibase/file/filesystem.hpp>
-#include <list>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include "audio_device.hpp"
+#include "music_stream.hpp"
 #include "sound.hpp"
+#include "source_pool.hpp"
 
 namespace openhoi {
 
+// Number of bytes of audio samples that are resident in memory
+struct AudioMemoryUsage {
+  // Samples in the OpenAL buffers of the effects
+  size_t buffers;
+
+  // Decoded samples of the effects that are kept on the CPU side
+  size_t samples;
+
+  // Samples of the background music stream
+  size_t stream;
+};
+
 // Audio manager for openhoi
 class AudioManager final {
  public:
@@ -42,12 +58,14 @@ class AudioManager final {
   // memory and thus makes them playable
   void loadEffects(filesystem::path directory);
 
-  // Play the provided sound with the given volume
-  void playSound(std::shared_ptr<Sound> sound, float volume);
+  // Play the provided sound with the given volume and priority
+  void playSound(std::shared_ptr<Sound> sound, float volume,
+                 SoundPriority priority = SoundPriority::Normal);
 
   // Play the sound effect (no background music) identified by it's name with
-  // the given volume
-  void playSound(std::string sound, float volume);
+  // the given volume and priority
+  void playSound(std::string sound, float volume,
+                 SoundPriority priority = SoundPriority::Normal);
 
   // Play the sound effect (no background music) identified by it's name with
   // the configured effects volume
@@ -56,9 +74,25 @@ class AudioManager final {
   // Update audio stats (e.g. progress of background music)
   void updateStats();
 
+  // Sets if the decoded samples of effects are kept after they were uploaded
+  // to OpenAL, e.g. for CPU-side mixing. By default they are freed right after
+  // the upload. Only affects effects that are loaded afterwards
+  void setKeepSamples(bool keepSamples);
+
+  // Gets the number of bytes of audio samples that are resident in memory
+  AudioMemoryUsage getMemoryUsage() const;
+
  private:
   typedef std::unordered_map<std::string, std::shared_ptr<Sound>> SoundMap;
 
+  // Samples of a sound that was decoded but not uploaded to OpenAL yet
+  struct DecodedSound {
+    filesystem::path audioFile;
+    ALenum format;
+    int sampleRate;
+    std::vector<short> samples;
+  };
+
   // Add audio device to list of possible devices. Returns the newly added
   // device
   std::shared_ptr<AudioDevice> addAudioDevice(std::string name);
@@ -66,33 +100,54 @@ class AudioManager final {
   // Create OpenAL context from the current device
   bool createContext();
 
-  // Loads all background audio tracks in a separate track and starts to play
-  // them as soon as the first file was fully loaded
-  void loadAndPlayBackgroundMusic(filesystem::path directory);
+  // Runs the background music loader thread. It waits until a directory is
+  // requested and collects its tracks, until the audio manager is destroyed
+  void runBackgroundMusicLoader();
+
+  // Collects all background audio tracks of the provided directory. The tracks
+  // are streamed while they are played, so only their headers are checked
+  // here. Stops early once the provided load generation was cancelled
+  void loadBackgroundMusic(filesystem::path directory, uint64_t generation);
+
+  // Checks if the provided background music load generation was cancelled
+  bool isBackgroundMusicLoadCancelled(uint64_t generation);
 
-  // Generate OpenAL source from the provided sound and play it with the given
-  // volume
-  ALuint generateSourceAndPlaySound(std::shared_ptr<Sound> sound, float volume);
+  // Cancels the running background music load and clears the collected tracks.
+  // Does not wait for the loader thread, it drops its results by itself
+  void cancelBackgroundMusicLoad();
 
   // Loads an sound and returns the sound in case the file was loaded
   // successfully
   std::shared_ptr<Sound> loadSound(filesystem::path audioFile);
 
+  // Decodes the samples of an sound. This does not call OpenAL, so it can be
+  // run on any thread. Returns nullptr in case the file could not be decoded
+  std::unique_ptr<DecodedSound> decodeSound(filesystem::path audioFile);
+
+  // Uploads the decoded samples into an OpenAL buffer. This has to be run on
+  // the thread that owns the OpenAL context. Returns the sound in case the
+  // upload was successful
+  std::shared_ptr<Sound> uploadSound(std::unique_ptr<DecodedSound> decoded);
+
   // Stop and remove all currently existing/playing audios
   void stopAllAudio();
 
   std::vector<std::shared_ptr<AudioDevice>> devices;
   std::shared_ptr<AudioDevice> selectedDevice;
   SoundMap effects;
+  bool keepSamples;
   filesystem::path lastEffectsDirectory;
-  std::list<ALuint> playing;
-  SoundMap backgroundMusic;
-  SoundMap::iterator backgroundMusicIt;
-  std::atomic<bool> backgroundMusicThreadRunning;
-  std::atomic<bool> backgroundMusicThreadShouldStop;
-  std::atomic<bool> backgroundMusicThreadFinished;
+  std::unique_ptr<SourcePool> sources;
+  std::vector<filesystem::path> backgroundMusic;
+  size_t backgroundMusicIndex;
+  std::mutex backgroundMusicMutex;
+  std::condition_variable backgroundMusicCondition;
+  std::thread backgroundMusicThread;
+  filesystem::path pendingBackgroundMusicDirectory;
+  uint64_t backgroundMusicGeneration;
+  bool backgroundMusicThreadShouldStop;
   filesystem::path lastBackgroundMusicDirectory;
-  ALuint playingBackgroundMusic;
+  std::unique_ptr<MusicStream> playingBackgroundMusic;
   ALCdevice* device;
   ALCcontext* context;
 };
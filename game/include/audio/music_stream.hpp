@@ -0,0 +1,91 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <al.h>
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <hoibase/file/filesystem.hpp>
+#include <hoibase/file/mapped_file.hpp>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Number of OpenAL buffers a music stream queues on its source
+#define OPENHOI_MUSIC_STREAM_BUFFER_COUNT 4
+
+// Number of sample frames per OpenAL buffer of a music stream (about 190 ms at
+// 44.1 kHz)
+#define OPENHOI_MUSIC_STREAM_CHUNK_FRAMES 8192
+
+// Number of decoded chunks a music stream keeps ready for its buffers
+#define OPENHOI_MUSIC_STREAM_READY_CHUNKS 2
+
+struct stb_vorbis;
+
+namespace openhoi {
+
+// Plays an Ogg Vorbis file without decoding it as a whole. A decode thread
+// keeps a few chunks of samples ahead, which are uploaded into a small ring of
+// OpenAL buffers whenever the source has finished playing one of them. All
+// OpenAL calls are made from the thread that calls update().
+class MusicStream final {
+ public:
+  // Opens the provided Ogg Vorbis file and starts to play it with the given
+  // volume. Use isOpen() to check if the file could be decoded
+  MusicStream(filesystem::path file, float volume);
+
+  // Stops the playback and the decode thread
+  ~MusicStream();
+
+  MusicStream(MusicStream const&) = delete;
+  MusicStream& operator=(MusicStream const&) = delete;
+
+  // Checks if the file could be decoded and the OpenAL objects were created
+  bool isOpen() const;
+
+  // Gets the file name without extension
+  std::string getFileName() const;
+
+  // Refills and queues the buffers that have been played and restarts the
+  // source after a buffer underrun. Returns false as soon as the whole file was
+  // played
+  bool update();
+
+  // Sets the volume
+  void setVolume(float volume);
+
+  // Gets the number of bytes of samples held in the OpenAL buffers and the
+  // decoded chunks
+  size_t getMemorySize() const;
+
+ private:
+  // Decodes chunks until enough are ready, the file has ended or the stream is
+  // stopped
+  void decode();
+
+  // Decodes the next chunk. Returns false at the end of the file
+  bool decodeChunk(std::vector<short>& chunk);
+
+  filesystem::path file;
+  std::unique_ptr<MappedFile> mapping;
+  stb_vorbis* vorbis;
+  int channels;
+  int sampleRate;
+  ALenum format;
+  ALuint source;
+  std::array<ALuint, OPENHOI_MUSIC_STREAM_BUFFER_COUNT> buffers;
+  std::vector<ALuint> idleBuffers;
+  std::deque<std::vector<short>> readyChunks;
+  std::vector<std::vector<short>> spareChunks;
+  bool stopping;
+  bool finished;
+  mutable std::mutex mutex;
+  std::condition_variable condition;
+  std::thread decoder;
+};
+
+}  // namespace openhoi
@@ -5,14 +5,18 @@
 #include <al.h>
 
 #include <string>
+#include <vector>
 
 namespace openhoi {
 
-// Represents an loaded sound that can be played at any time
+// Represents an loaded sound that can be played at any time. OpenAL holds its
+// own copy of the samples, so the decoded samples are only kept if they are
+// needed on the CPU side, e.g. for mixing.
 class Sound final {
  public:
-  // Sound constructor
-  Sound(std::string fileName, ALuint buffer, short* samples);
+  // Sound constructor. The samples may be empty if they are not kept
+  Sound(std::string fileName, ALuint buffer, size_t bufferSize,
+        std::vector<short> samples);
 
   // Sound destructor
   ~Sound();
@@ -23,10 +27,23 @@ class Sound final {
   // Gets the OpenAL sound buffer
   ALuint const& getBuffer() const;
 
+  // Gets the number of bytes of samples in the OpenAL buffer
+  size_t getBufferSize() const;
+
+  // Checks if the decoded samples are kept
+  bool hasSamples() const;
+
+  // Gets the kept decoded samples, interleaved by channel
+  std::vector<short> const& getSamples() const;
+
+  // Gets the number of bytes of the kept decoded samples
+  size_t getSampleMemorySize() const;
+
  private:
   std::string fileName;
   ALuint buffer;
-  short* samples;
+  size_t bufferSize;
+  std::vector<short> samples;
 };
 
 }  // namespace openhoi
\ No newline at end of file
@@ -0,0 +1,76 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <al.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "sound.hpp"
+
+// Maximum number of sound effects that are played at the same time
+#define OPENHOI_AUDIO_MAX_VOICES 32
+
+namespace openhoi {
+
+// Priority of a sound effect. When all voices are in use, a new sound steals
+// the voice of a sound with the same or a lower priority
+enum class SoundPriority { Low = 0, Normal = 1, High = 2 };
+
+// Fixed pool of preallocated OpenAL sources (voices) for sound effects, so that
+// playing a sound neither generates a source nor allocates memory
+class SourcePool final {
+ public:
+  // Generates the provided number of sources in the current OpenAL context
+  explicit SourcePool(size_t maxVoices);
+
+  // Stops and deletes all sources
+  ~SourcePool();
+
+  SourcePool(SourcePool const&) = delete;
+  SourcePool& operator=(SourcePool const&) = delete;
+
+  // Plays the provided sound with the given volume on a free voice. If all
+  // voices are in use, the voice with the lowest priority is stolen, the
+  // quietest and then the oldest one first. Returns false in case all voices
+  // play sounds with a higher priority
+  bool play(std::shared_ptr<Sound> sound, float volume,
+            SoundPriority priority);
+
+  // Frees the voices of finished sounds and sets the volume of all others
+  void update(float volume);
+
+  // Stops all sounds and frees their voices
+  void stopAll();
+
+  // Gets the number of voices that are playing
+  size_t getActiveCount() const;
+
+  // Gets the number of voices
+  size_t getVoiceCount() const;
+
+ private:
+  // Source and the sound it plays
+  struct Voice {
+    ALuint source;
+    std::shared_ptr<Sound> sound;
+    float volume;
+    SoundPriority priority;
+    uint64_t sequence;
+  };
+
+  // Finds the voice to steal for a sound with the provided priority. Returns
+  // the number of voices in case there is none
+  size_t findVictim(SoundPriority priority) const;
+
+  // Stops the voice and detaches its sound, so that its buffer can be deleted
+  void release(size_t index);
+
+  std::vector<Voice> voices;
+  std::vector<size_t> freeVoices;
+  uint64_t nextSequence;
+};
+
+}  // namespace openhoi
@@ -10,7 +10,9 @@
 #include <OgreSceneManager.h>
 
 #include <array>
+#include <hoibase/file/file_read_service.hpp>
 #include <hoibase/file/filesystem.hpp>
+#include <hoibase/file/ogre_asset_archive.hpp>
 #include <hoibase/helper/os.hpp>
 #include <map>
 #include <string>
@@ -52,6 +54,9 @@ class GameManager final : public Ogre::FrameListener,
   // Gets the audio manager
   std::shared_ptr<AudioManager> const& getAudioManager() const;
 
+  // Gets the service for reading asset files in the background
+  std::unique_ptr<FileReadService> const& getFileReadService() const;
+
   // Gets the OGRE root
   Ogre::Root* const& getRoot() const;
 
@@ -170,6 +175,8 @@ class GameManager final : public Ogre::FrameListener,
   std::unique_ptr<StateManager> stateManager;
   std::shared_ptr<AudioManager> audioManager;
   std::unique_ptr<GuiManager> guiManager;
+  std::unique_ptr<FileReadService> fileReadService;
+  std::unique_ptr<OgreAssetArchiveFactory> assetArchiveFactory;
   Ogre::OverlaySystem* overlaySystem;
   Ogre::LogManager* logManager;
   Ogre::Root* root;
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <hoibase/map/mesh_quality.hpp>
 #include <hoibase/openhoi.hpp>
 #include <string>
 
@@ -61,6 +62,12 @@ class Options final {
   // Sets the effects volume
   void setEffectsVolume(float const& effectsVolume);
 
+  // Gets the mesh quality of the map provinces
+  MeshQuality const& getMeshQuality() const;
+
+  // Sets the mesh quality of the map provinces
+  void setMeshQuality(MeshQuality const& meshQuality);
+
   std::string videoMode;
   byte fullScreenAntiAliasing;
   WindowMode windowMode;
@@ -68,6 +75,7 @@ class Options final {
   std::string audioDevice;
   int musicVolume;
   int effectsVolume;
+  MeshQuality meshQuality;
 
  private:
   // Load options from file
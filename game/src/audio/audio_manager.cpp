@@ -7,7 +7,9 @@
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
+#include <chrono>
 #include <hoibase/file/file_access.hpp>
+#include <hoibase/helper/parallel.hpp>
 #include <random>
 #include <stb_vorbis.c>
 #include <thread>
@@ -18,10 +20,10 @@ namespace openhoi {
 
 // Initializes the audio manager
 AudioManager::AudioManager()
-    : backgroundMusicThreadRunning(false),
+    : keepSamples(false),
+      backgroundMusicIndex(0),
+      backgroundMusicGeneration(0),
       backgroundMusicThreadShouldStop(false),
-      backgroundMusicThreadFinished(false),
-      playingBackgroundMusic(0),
       device(0),
       context(0) {
   // Try to open the default device. Returns NULL in case no device was found
@@ -107,18 +109,23 @@ AudioManager::AudioManager()
     Ogre::LogManager::getSingletonPtr()->logMessage(
         "*** No audio devices found! ***", Ogre::LogMessageLevel::LML_CRITICAL);
   }
-
-  // Initialize iterators
-  backgroundMusicIt = backgroundMusic.begin();
 }
 
 // Destroys the audio manager
 AudioManager::~AudioManager() {
+  // Stop the background music loader. It checks for cancellation after every
+  // track, so this only waits for the header check of a single track
+  {
+    std::lock_guard<std::mutex> lock(backgroundMusicMutex);
+    backgroundMusicThreadShouldStop = true;
+    backgroundMusicGeneration++;
+  }
+  backgroundMusicCondition.notify_all();
+  if (backgroundMusicThread.joinable()) backgroundMusicThread.join();
+
   if (context) {
-    for (const auto& audioSource : playing) {
-      alDeleteSources(1, &audioSource);
-    }
-    if (playingBackgroundMusic) alDeleteSources(1, &playingBackgroundMusic);
+    sources.reset();
+    playingBackgroundMusic.reset();
 
     alcMakeContextCurrent(NULL);
     alcDestroyContext(context);
@@ -154,6 +161,9 @@ bool AudioManager::createContext() {
     // Set distance attenuation model
     alDistanceModel(AL_INVERSE_DISTANCE_CLAMPED);
 
+    // Generate the voices for sound effects
+    sources = std::make_unique<SourcePool>(OPENHOI_AUDIO_MAX_VOICES);
+
     // Log and return success
     Ogre::LogManager::getSingletonPtr()->logMessage("Audio context created");
     return true;
@@ -231,31 +241,55 @@ void AudioManager::loadBackgroundMusicAsync(filesystem::path directory) {
   // Set last background music directory
   lastBackgroundMusicDirectory = directory;
 
-  // Reset flags
-  backgroundMusicThreadShouldStop = false;
-  backgroundMusicThreadFinished = false;
-
-  // Invoke the function `loadAndPlayBackgroundMusic` in a separate thread
-  std::thread{&AudioManager::loadAndPlayBackgroundMusic, this, directory}
-      .detach();
+  // Cancel the load that may still be running and hand the directory to the
+  // loader thread, which is started on first use
+  {
+    std::lock_guard<std::mutex> lock(backgroundMusicMutex);
+    backgroundMusicGeneration++;
+    backgroundMusic.clear();
+    backgroundMusicIndex = 0;
+    pendingBackgroundMusicDirectory = directory;
+    if (!backgroundMusicThread.joinable()) {
+      backgroundMusicThread =
+          std::thread{&AudioManager::runBackgroundMusicLoader, this};
+    }
+  }
+  backgroundMusicCondition.notify_one();
 }
 
-// Loads all background audio tracks in a separate track and starts to play them
-// as soon as the first file was fully loaded
-void AudioManager::loadAndPlayBackgroundMusic(filesystem::path directory) {
-  // Check if we have to existing the thread now
-  if (backgroundMusicThreadShouldStop) {
-    backgroundMusicThreadFinished = true;
-    return;
+// Runs the background music loader thread. It waits until a directory is
+// requested and collects its tracks, until the audio manager is destroyed
+void AudioManager::runBackgroundMusicLoader() {
+  std::unique_lock<std::mutex> lock(backgroundMusicMutex);
+  while (true) {
+    backgroundMusicCondition.wait(lock, [this] {
+      return backgroundMusicThreadShouldStop ||
+             !pendingBackgroundMusicDirectory.empty();
+    });
+    if (backgroundMusicThreadShouldStop) return;
+
+    filesystem::path directory = pendingBackgroundMusicDirectory;
+    pendingBackgroundMusicDirectory.clear();
+    uint64_t generation = backgroundMusicGeneration;
+
+    lock.unlock();
+    loadBackgroundMusic(directory, generation);
+    lock.lock();
   }
+}
 
-  // Set 'thread running' flag
-  backgroundMusicThreadRunning = true;
-
+// Collects all background audio tracks of the provided directory. The tracks
+// are streamed while they are played, so only their headers are checked here.
+// Stops early once the provided load generation was cancelled
+void AudioManager::loadBackgroundMusic(filesystem::path directory,
+                                       uint64_t generation) {
   // Iterate through all files in directory
   std::vector<filesystem::path> files;
-  for (const auto& entry : filesystem::directory_iterator(directory)) {
-    files.push_back(entry.path());
+  std::error_code error;
+  for (filesystem::directory_iterator it(directory, error), end;
+       !error && it != end; it.increment(error)) {
+    if (isBackgroundMusicLoadCancelled(generation)) return;
+    files.push_back(it->path());
   }
 
   // Shuffle file list
@@ -263,39 +297,51 @@ void AudioManager::loadAndPlayBackgroundMusic(filesystem::path directory) {
   std::mt19937 twister(rd());
   std::shuffle(files.begin(), files.end(), twister);
 
-  // Move smallest file to the beginning to decrease loading time for music on
-  // startup
-  auto smallestFileSize = UINTMAX_MAX;
-  for (auto it = files.begin(); it != files.end(); ++it) {
-    auto fileSize = filesystem::file_size(*it);
-    if (fileSize < smallestFileSize) smallestFileSize = fileSize;
-  }
-  for (auto it = files.begin(); it != files.end(); ++it) {
-    auto file = *it;
-    auto fileSize = filesystem::file_size(file);
-    if (fileSize <= smallestFileSize && it != files.begin()) {
-      files.erase(it);
-      files.insert(files.begin(), file);
-      break;
-    }
-  }
-
-  // Load all music files
+  // Check all music files
   for (const auto& file : files) {
-    // Check if we have to existing the thread now
-    if (backgroundMusicThreadShouldStop) {
-      backgroundMusicThreadFinished = true;
-      return;
+    if (isBackgroundMusicLoadCancelled(generation)) return;
+
+    // Check that the file is an Ogg Vorbis file that can be decoded
+    std::string extension =
+        boost::algorithm::to_lower_copy(file.extension().u8string());
+    if (extension != ".ogg") continue;
+    auto mapping = FileAccess::mapFile(file, MappedFileAccess::Sequential);
+    if (!mapping) continue;
+    auto* vorbis = stb_vorbis_open_memory(
+        mapping->getData(), (int)mapping->getSize(), NULL, NULL);
+    if (!vorbis) {
+      Ogre::LogManager::getSingletonPtr()->logMessage(
+          (boost::format("Audio file '%s' could not be decoded") %
+           file.filename().u8string())
+              .str(),
+          Ogre::LogMessageLevel::LML_CRITICAL);
+      continue;
     }
+    stb_vorbis_close(vorbis);
 
-    // Load the sound file
-    auto soundPtr = loadSound(file);
-    if (soundPtr) backgroundMusic.insert({soundPtr->getFileName(), soundPtr});
+    // Only add the track if the load was not cancelled in the meantime, as the
+    // list then already belongs to a newer load
+    std::lock_guard<std::mutex> lock(backgroundMusicMutex);
+    if (backgroundMusicGeneration != generation) return;
+    backgroundMusic.push_back(file);
   }
+}
+
+// Checks if the provided background music load generation was cancelled
+bool AudioManager::isBackgroundMusicLoadCancelled(uint64_t generation) {
+  std::lock_guard<std::mutex> lock(backgroundMusicMutex);
+  return backgroundMusicThreadShouldStop ||
+         backgroundMusicGeneration != generation;
+}
 
-  // Mark thread as 'finished'
-  backgroundMusicThreadFinished = true;
-  backgroundMusicThreadRunning = false;
+// Cancels the running background music load and clears the collected tracks.
+// Does not wait for the loader thread, it drops its results by itself
+void AudioManager::cancelBackgroundMusicLoad() {
+  std::lock_guard<std::mutex> lock(backgroundMusicMutex);
+  backgroundMusicGeneration++;
+  backgroundMusic.clear();
+  backgroundMusicIndex = 0;
+  pendingBackgroundMusicDirectory.clear();
 }
 
 // Loads all audio effect files found in the the provided directory into memory
@@ -305,27 +351,54 @@ void AudioManager::loadEffects(filesystem::path directory) {
   lastEffectsDirectory = directory;
 
   // Iterate through all files in directory
+  auto start = std::chrono::steady_clock::now();
+  std::vector<filesystem::path> files;
   for (const auto& entry : filesystem::directory_iterator(directory)) {
-    auto soundPtr = loadSound(entry.path());
-    if (soundPtr) effects.insert({soundPtr->getFileName(), soundPtr});
+    files.push_back(entry.path());
   }
-}
 
-// Play the provided sound with the given volume
-void AudioManager::playSound(std::shared_ptr<Sound> sound, float volume) {
-  // Generate source and play audio from it
-  ALuint source = generateSourceAndPlaySound(sound, volume);
+  // Decode all files on the worker pool
+  std::vector<std::unique_ptr<DecodedSound>> decoded(files.size());
+  Parallel::forEach(files.size(),
+                    [&](size_t i) { decoded[i] = decodeSound(files[i]); });
+  auto decodeDuration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  // Upload the samples on this thread, as it owns the OpenAL context
+  size_t count = 0;
+  for (auto& sound : decoded) {
+    if (!sound) continue;
+    auto soundPtr = uploadSound(std::move(sound));
+    if (soundPtr) {
+      effects.insert({soundPtr->getFileName(), soundPtr});
+      count++;
+    }
+  }
 
-  // Add source to list of playing sources
-  playing.push_back(source);
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  Ogre::LogManager::getSingletonPtr()->logMessage(
+      (boost::format("Loaded %d audio effects in %d ms (decoding took %d ms "
+                     "using %d threads)") %
+       count % duration.count() % decodeDuration.count() %
+       std::min<size_t>(Parallel::getDefaultThreadCount(), files.size()))
+          .str());
+}
+
+// Play the provided sound with the given volume and priority
+void AudioManager::playSound(std::shared_ptr<Sound> sound, float volume,
+                             SoundPriority priority) {
+  // Play the sound on a pooled voice
+  if (sources) sources->play(sound, volume, priority);
 }
 
 // Play the sound effect (no background music) identified by it's name with the
-// given volume
-void AudioManager::playSound(std::string sound, float volume) {
-  auto soundPtr = effects[sound];
-  if (soundPtr) {
-    playSound(soundPtr, volume);
+// given volume and priority
+void AudioManager::playSound(std::string sound, float volume,
+                             SoundPriority priority) {
+  auto it = effects.find(sound);
+  if (it != effects.end() && it->second) {
+    playSound(it->second, volume, priority);
   } else {
     Ogre::LogManager::getSingletonPtr()->logMessage(
         (boost::format("Unable to play sound effect '%s' as it was not found") %
@@ -340,139 +413,75 @@ void AudioManager::playSound(std::string sound) {
   playSound(sound, GameManager::getInstance().getOptions()->getEffectsVolume());
 }
 
-// Generate OpenAL source from the provided sound and play it with the given
-// volume
-ALuint AudioManager::generateSourceAndPlaySound(std::shared_ptr<Sound> sound,
-                                                float volume) {
-  // Create audio source object
-  ALuint source;
-  alGenSources(1, &source);
-  assert(source > 0);
-
-  alSourcei(source, AL_LOOPING, AL_FALSE);
-  alSourcei(source, AL_SOURCE_RELATIVE, AL_FALSE);
-  alSourcei(source, AL_BUFFER, sound->getBuffer());
-  alSourcef(source, AL_GAIN, volume);
-
-  // Play audio from source
-  alSourcePlay(source);
-
-  // Return source
-  return source;
-}
-
 // Update audio stats (e.g. progress of background music)
 void AudioManager::updateStats() {
   std::shared_ptr<Options> options = GameManager::getInstance().getOptions();
-  ALint state;
-
-  // Check background audio status
-  if (backgroundMusic.size() > 0) {
-    bool backgroundMusicPlaying = false;
-    if (backgroundMusicIt != backgroundMusic.end()) {
-      // Get sound pointer
-      std::shared_ptr<Sound> soundPtr = backgroundMusicIt->second;
-
-      // Check sound state (if it is still playing)
-      if (alIsSource(playingBackgroundMusic)) {
-        alGetSourcei(playingBackgroundMusic, AL_SOURCE_STATE, &state);
-        backgroundMusicPlaying = state == AL_INITIAL || state == AL_PLAYING;
-      }
-    }
 
-    const float backgroundMusicVolume = options->getMusicVolume();
-    if (!backgroundMusicPlaying) {
-      // Delete audio source if required
-      if (playingBackgroundMusic) {
-        alDeleteSources(1, &playingBackgroundMusic);
-        playingBackgroundMusic = 0;
+  // Check background audio status. The playing track is refilled from its
+  // decode thread and the next track is started as soon as it has ended
+  const float backgroundMusicVolume = options->getMusicVolume();
+  if (playingBackgroundMusic && playingBackgroundMusic->update()) {
+    playingBackgroundMusic->setVolume(backgroundMusicVolume);
+  } else {
+    playingBackgroundMusic.reset();
+
+    // Switch to next background audio track
+    filesystem::path track;
+    {
+      std::lock_guard<std::mutex> lock(backgroundMusicMutex);
+      if (!backgroundMusic.empty()) {
+        track = backgroundMusic[backgroundMusicIndex % backgroundMusic.size()];
+        backgroundMusicIndex++;
       }
+    }
 
-      // Switch to next background audio track
-      if (backgroundMusicIt != backgroundMusic.end() &&
-          std::next(backgroundMusicIt) != backgroundMusic.end())
-        backgroundMusicIt++;
-      else
-        backgroundMusicIt = backgroundMusic.begin();
-
-      // Play the next track
-      playingBackgroundMusic = generateSourceAndPlaySound(
-          backgroundMusicIt->second, backgroundMusicVolume);
-    } else {
-      alSourcef(playingBackgroundMusic, AL_GAIN, backgroundMusicVolume);
+    // Play the next track
+    if (!track.empty()) {
+      playingBackgroundMusic =
+          std::make_unique<MusicStream>(track, backgroundMusicVolume);
+      if (!playingBackgroundMusic->isOpen()) playingBackgroundMusic.reset();
     }
   }
 
-  // Check for finished audio effects and deletes their sources
-  ALuint source;
-  const float effectsVolume = options->getEffectsVolume();
-  for (auto it = playing.begin(); it != playing.end();) {
-    // Get source from iterator
-    source = *it;
-
-    // Check sound state (if it is still playing) and handle it
-    if (alIsSource(source)) {
-      alGetSourcei(source, AL_SOURCE_STATE, &state);
-      if (state == AL_STOPPED) {
-        // Audio has stopped, so we can delete it
-        alDeleteSources(1, &source);
-        it = playing.erase(it);
-      } else {
-        // Adjust volume if required
-        alSourcef(source, AL_GAIN, effectsVolume);
+  // Free the voices of finished audio effects
+  if (sources) sources->update(options->getEffectsVolume());
+}
 
-        // Switch to next element in list
-        it++;
-      }
-    } else {
-      // Drop no more existing source from list
-      it = playing.erase(it);
-    }
+// Sets if the decoded samples of effects are kept after they were uploaded to
+// OpenAL, e.g. for CPU-side mixing. By default they are freed right after the
+// upload. Only affects effects that are loaded afterwards
+void AudioManager::setKeepSamples(bool keepSamples) {
+  this->keepSamples = keepSamples;
+}
+
+// Gets the number of bytes of audio samples that are resident in memory
+AudioMemoryUsage AudioManager::getMemoryUsage() const {
+  AudioMemoryUsage usage = {0, 0, 0};
+  for (auto const& effect : effects) {
+    if (!effect.second) continue;
+    usage.buffers += effect.second->getBufferSize();
+    usage.samples += effect.second->getSampleMemorySize();
   }
+  if (playingBackgroundMusic)
+    usage.stream = playingBackgroundMusic->getMemorySize();
+  return usage;
 }
 
 // Stop and remove all currently existing/playing audios
 void AudioManager::stopAllAudio() {
-  ALint state;
-
-  // Ask background music loading thread to stop
-  backgroundMusicThreadShouldStop = true;
-
-  // Check if there is some background music running. If yes, stop + delete it
-  if (backgroundMusic.size() > 0) {
-    if (backgroundMusicIt != backgroundMusic.end()) {
-      // Stop and delete source
-      alGetSourcei(playingBackgroundMusic, AL_SOURCE_STATE, &state);
-      if (state != AL_STOPPED) alSourceStop(playingBackgroundMusic);
-      alDeleteSources(1, &playingBackgroundMusic);
-      playingBackgroundMusic = 0;
-    }
-  }
+  // Stop the background music stream
+  playingBackgroundMusic.reset();
 
-  // Clear all buffered background music
-  if (backgroundMusicThreadRunning) {
-    while (!backgroundMusicThreadFinished) {
-      // Oh no! Busy waiting!
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
-  }
-  backgroundMusic.clear();
-  backgroundMusicIt = backgroundMusic.begin();
+  // Clear all collected background music and restart its loading. The loader
+  // thread notices the cancellation by itself, so there is no need to wait
   if (filesystem::is_directory(lastBackgroundMusicDirectory))
     loadBackgroundMusicAsync(lastBackgroundMusicDirectory);
+  else
+    cancelBackgroundMusicLoad();
 
-  // Check for other audio effects and stop + delete them, too
-  ALuint source;
-  for (auto it = playing.begin(); it != playing.end();) {
-    // Get source from iterator
-    source = *it;
-
-    // Check sound state (if it is still playing) and handle it
-    alGetSourcei(source, AL_SOURCE_STATE, &state);
-    if (state != AL_STOPPED) alSourceStop(source);
-    alDeleteSources(1, &source);
-    it = playing.erase(it);
-  }
+  // Stop all other audio effects and delete their voices, as they belong to the
+  // context of the current device
+  sources.reset();
 
   // Clear all buffered effects
   effects.clear();
@@ -481,6 +490,15 @@ void AudioManager::stopAllAudio() {
 // Loads an sound and returns the sound in case the file was loaded
 // successfully
 std::shared_ptr<Sound> AudioManager::loadSound(filesystem::path audioFile) {
+  auto decoded = decodeSound(audioFile);
+  if (!decoded) return nullptr;
+  return uploadSound(std::move(decoded));
+}
+
+// Decodes the samples of an sound. This does not call OpenAL, so it can be run
+// on any thread. Returns nullptr in case the file could not be decoded
+std::unique_ptr<AudioManager::DecodedSound> AudioManager::decodeSound(
+    filesystem::path audioFile) {
   if (!filesystem::is_regular_file(audioFile)) return nullptr;
 
   // Check for OGG file type
@@ -488,44 +506,49 @@ std::shared_ptr<Sound> AudioManager::loadSound(filesystem::path audioFile) {
       boost::algorithm::to_lower_copy(audioFile.extension().u8string());
   if (extension != ".ogg") return nullptr;
 
-  // Read file and check result
-  unsigned char* data = nullptr;
-  int fileSize = (int)FileAccess::readFile(audioFile, &data);
-  if (fileSize < 1) return nullptr;
-
-  // Clear OpenAL error flag
-  alGetError();
+  // Map the file into memory, so that it is decoded in place without copying
+  // it first
+  std::unique_ptr<MappedFile> file =
+      FileAccess::mapFile(audioFile, MappedFileAccess::Sequential);
+  if (!file) return nullptr;
 
   // Open Vorbis stream and decode data
-  auto* vorbis = stb_vorbis_open_memory(data, fileSize, NULL, NULL);
+  auto* vorbis = stb_vorbis_open_memory(file->getData(), (int)file->getSize(),
+                                        NULL, NULL);
   if (!vorbis) {
     Ogre::LogManager::getSingletonPtr()->logMessage(
         (boost::format("Audio file '%s' could not be decoded") %
          audioFile.filename().u8string())
             .str(),
         Ogre::LogMessageLevel::LML_CRITICAL);
-
-    // Free the data malloc'd in FileAccess::readFile!
-    free(data);
-
     return nullptr;
   }
 
   // Get audio information
+  auto decoded = std::make_unique<DecodedSound>();
   auto info = stb_vorbis_get_info(vorbis);
-  ALenum format = info.channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
-  int sampleRate = info.sample_rate;
+  decoded->audioFile = audioFile;
+  decoded->format = info.channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+  decoded->sampleRate = info.sample_rate;
   int size = stb_vorbis_stream_length_in_samples(vorbis) * info.channels;
-  short* samples = new short[size];
-  stb_vorbis_get_samples_short_interleaved(vorbis, info.channels, samples,
-                                           size);
-  size *= sizeof(short);
+  decoded->samples.resize(size);
+  stb_vorbis_get_samples_short_interleaved(vorbis, info.channels,
+                                           decoded->samples.data(), size);
 
-  // Close Vorbis stream
+  // Close Vorbis stream and unmap the file
   stb_vorbis_close(vorbis);
+  return decoded;
+}
 
-  // Free the data malloc'd in FileAccess::readFile!
-  free(data);
+// Uploads the decoded samples into an OpenAL buffer. This has to be run on the
+// thread that owns the OpenAL context. Returns the sound in case the upload was
+// successful
+std::shared_ptr<Sound> AudioManager::uploadSound(
+    std::unique_ptr<DecodedSound> decoded) {
+  filesystem::path const& audioFile = decoded->audioFile;
+
+  // Clear OpenAL error flag
+  alGetError();
 
   // Generate buffers
   ALuint buffer;
@@ -539,7 +562,9 @@ std::shared_ptr<Sound> AudioManager::loadSound(filesystem::path audioFile) {
         Ogre::LogMessageLevel::LML_CRITICAL);
     return nullptr;
   }
-  alBufferData(buffer, format, samples, size, sampleRate);
+  size_t size = decoded->samples.size() * sizeof(short);
+  alBufferData(buffer, decoded->format, decoded->samples.data(), (ALsizei)size,
+               decoded->sampleRate);
   if ((error = alGetError()) != AL_NO_ERROR) {
     Ogre::LogManager::getSingletonPtr()->logMessage(
         (boost::format(
@@ -551,9 +576,13 @@ std::shared_ptr<Sound> AudioManager::loadSound(filesystem::path audioFile) {
     return nullptr;
   }
 
-  // Create sound object
+  // Create sound object. OpenAL has copied the samples, so they are freed
+  // together with the decoded sound unless they should be kept
   std::string fileName = audioFile.stem().u8string();
-  std::shared_ptr<Sound> sound(new Sound(fileName, buffer, samples));
+  std::vector<short> samples;
+  if (keepSamples) samples = std::move(decoded->samples);
+  std::shared_ptr<Sound> sound(
+      new Sound(fileName, buffer, size, std::move(samples)));
 
   Ogre::LogManager::getSingletonPtr()->logMessage(
       (boost::format("Audio file '%s' loaded") %
@@ -0,0 +1,222 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "audio/music_stream.hpp"
+
+#include <OgreLogManager.h>
+
+#include <boost/format.hpp>
+#include <hoibase/file/file_access.hpp>
+#include <utility>
+
+// The implementation is compiled with the audio manager
+#define STB_VORBIS_HEADER_ONLY
+#include <stb_vorbis.c>
+
+namespace openhoi {
+
+// Opens the provided Ogg Vorbis file and starts to play it with the given
+// volume. Use isOpen() to check if the file could be decoded
+MusicStream::MusicStream(filesystem::path file, float volume)
+    : file(file),
+      vorbis(nullptr),
+      channels(0),
+      sampleRate(0),
+      format(AL_NONE),
+      source(0),
+      buffers(),
+      stopping(false),
+      finished(false) {
+  // Map the file into memory, so that it is decoded in place while playing
+  mapping = FileAccess::mapFile(file, MappedFileAccess::Sequential);
+  if (mapping)
+    vorbis = stb_vorbis_open_memory(mapping->getData(),
+                                    (int)mapping->getSize(), NULL, NULL);
+  if (!vorbis) {
+    Ogre::LogManager::getSingletonPtr()->logMessage(
+        (boost::format("Audio file '%s' could not be decoded") %
+         file.filename().u8string())
+            .str(),
+        Ogre::LogMessageLevel::LML_CRITICAL);
+    mapping.reset();
+    return;
+  }
+  auto info = stb_vorbis_get_info(vorbis);
+  channels = info.channels == 1 ? 1 : 2;
+  sampleRate = info.sample_rate;
+  format = channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+
+  // Generate the source and the ring of buffers
+  ALenum error;
+  alGetError();
+  alGenSources(1, &source);
+  alGenBuffers((ALsizei)buffers.size(), buffers.data());
+  if ((error = alGetError()) != AL_NO_ERROR) {
+    Ogre::LogManager::getSingletonPtr()->logMessage(
+        (boost::format("Unable to generate OpenAL stream for file '%s': %d") %
+         file.filename().u8string() % error)
+            .str(),
+        Ogre::LogMessageLevel::LML_CRITICAL);
+    if (alIsSource(source)) alDeleteSources(1, &source);
+    source = 0;
+    stb_vorbis_close(vorbis);
+    vorbis = nullptr;
+    mapping.reset();
+    return;
+  }
+  alSourcei(source, AL_LOOPING, AL_FALSE);
+  alSourcei(source, AL_SOURCE_RELATIVE, AL_FALSE);
+  alSourcef(source, AL_GAIN, volume);
+
+  // Fill all buffers right away, so that the playback starts immediately
+  std::vector<short> chunk;
+  for (ALuint buffer : buffers) {
+    if (finished || !decodeChunk(chunk)) {
+      finished = true;
+      idleBuffers.push_back(buffer);
+      continue;
+    }
+    alBufferData(buffer, format, chunk.data(),
+                 (ALsizei)(chunk.size() * sizeof(short)), sampleRate);
+    alSourceQueueBuffers(source, 1, &buffer);
+  }
+  spareChunks.push_back(std::move(chunk));
+  alSourcePlay(source);
+
+  // Decode ahead on a separate thread
+  if (!finished) decoder = std::thread(&MusicStream::decode, this);
+
+  Ogre::LogManager::getSingletonPtr()->logMessage(
+      (boost::format("Audio file '%s' streaming") % file.filename().u8string())
+          .str());
+}
+
+// Stops the playback and the decode thread
+MusicStream::~MusicStream() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  condition.notify_all();
+  if (decoder.joinable()) decoder.join();
+
+  if (source) {
+    alSourceStop(source);
+    alDeleteSources(1, &source);
+    alDeleteBuffers((ALsizei)buffers.size(), buffers.data());
+  }
+  if (vorbis) stb_vorbis_close(vorbis);
+}
+
+// Checks if the file could be decoded and the OpenAL objects were created
+bool MusicStream::isOpen() const { return source != 0; }
+
+// Gets the file name without extension
+std::string MusicStream::getFileName() const { return file.stem().u8string(); }
+
+// Refills and queues the buffers that have been played and restarts the source
+// after a buffer underrun. Returns false as soon as the whole file was played
+bool MusicStream::update() {
+  if (!isOpen()) return false;
+
+  // Take back the buffers that have been played
+  ALint processed = 0;
+  alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+  while (processed-- > 0) {
+    ALuint buffer;
+    alSourceUnqueueBuffers(source, 1, &buffer);
+    idleBuffers.push_back(buffer);
+  }
+
+  // Upload the decoded chunks into them. The upload happens outside of the
+  // lock, so that the decode thread is never blocked by OpenAL
+  bool ended = false;
+  while (!idleBuffers.empty()) {
+    std::vector<short> chunk;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (readyChunks.empty()) {
+        ended = finished;
+        break;
+      }
+      chunk = std::move(readyChunks.front());
+      readyChunks.pop_front();
+    }
+    condition.notify_one();
+
+    ALuint buffer = idleBuffers.back();
+    idleBuffers.pop_back();
+    alBufferData(buffer, format, chunk.data(),
+                 (ALsizei)(chunk.size() * sizeof(short)), sampleRate);
+    alSourceQueueBuffers(source, 1, &buffer);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    spareChunks.push_back(std::move(chunk));
+  }
+
+  // A source that ran out of buffers stops, so restart it as long as there is
+  // something queued
+  ALint queued = 0, state;
+  alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+  alGetSourcei(source, AL_SOURCE_STATE, &state);
+  if (queued > 0 && state != AL_PLAYING) alSourcePlay(source);
+  return queued > 0 || !ended;
+}
+
+// Sets the volume
+void MusicStream::setVolume(float volume) {
+  if (isOpen()) alSourcef(source, AL_GAIN, volume);
+}
+
+// Gets the number of bytes of samples held in the OpenAL buffers and the
+// decoded chunks
+size_t MusicStream::getMemorySize() const {
+  size_t size = buffers.size() * OPENHOI_MUSIC_STREAM_CHUNK_FRAMES *
+                (size_t)channels * sizeof(short);
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto const& chunk : readyChunks)
+    size += chunk.capacity() * sizeof(short);
+  for (auto const& chunk : spareChunks)
+    size += chunk.capacity() * sizeof(short);
+  return size;
+}
+
+// Decodes chunks until enough are ready, the file has ended or the stream is
+// stopped
+void MusicStream::decode() {
+  std::unique_lock<std::mutex> lock(mutex);
+  for (;;) {
+    condition.wait(lock, [this] {
+      return stopping ||
+             readyChunks.size() < OPENHOI_MUSIC_STREAM_READY_CHUNKS;
+    });
+    if (stopping) return;
+
+    // Reuse the memory of uploaded chunks
+    std::vector<short> chunk;
+    if (!spareChunks.empty()) {
+      chunk = std::move(spareChunks.back());
+      spareChunks.pop_back();
+    }
+
+    lock.unlock();
+    bool decoded = decodeChunk(chunk);
+    lock.lock();
+    if (!decoded) {
+      finished = true;
+      return;
+    }
+    readyChunks.push_back(std::move(chunk));
+  }
+}
+
+// Decodes the next chunk. Returns false at the end of the file
+bool MusicStream::decodeChunk(std::vector<short>& chunk) {
+  chunk.resize((size_t)OPENHOI_MUSIC_STREAM_CHUNK_FRAMES * channels);
+  int frames = stb_vorbis_get_samples_short_interleaved(
+      vorbis, channels, chunk.data(), (int)chunk.size());
+  if (frames <= 0) return false;
+  chunk.resize((size_t)frames * channels);
+  return true;
+}
+
+}  // namespace openhoi
@@ -2,17 +2,20 @@
 
 #include "audio/sound.hpp"
 
+#include <utility>
+
 namespace openhoi {
 
-// Sound constructor
-Sound::Sound(std::string fileName, ALuint buffer, short* samples)
-    : fileName(fileName), buffer(buffer), samples(samples) {}
+// Sound constructor. The samples may be empty if they are not kept
+Sound::Sound(std::string fileName, ALuint buffer, size_t bufferSize,
+             std::vector<short> samples)
+    : fileName(fileName),
+      buffer(buffer),
+      bufferSize(bufferSize),
+      samples(std::move(samples)) {}
 
 // Sound destructor
-Sound::~Sound() {
-  alDeleteBuffers(1, &buffer);
-  delete[] samples;
-}
+Sound::~Sound() { alDeleteBuffers(1, &buffer); }
 
 // Gets the sound file name
 std::string const& Sound::getFileName() const { return fileName; }
@@ -20,4 +23,18 @@ std::string const& Sound::getFileName() const { return fileName; }
 // Gets the OpenAL sound buffer
 ALuint const& Sound::getBuffer() const { return buffer; }
 
+// Gets the number of bytes of samples in the OpenAL buffer
+size_t Sound::getBufferSize() const { return bufferSize; }
+
+// Checks if the decoded samples are kept
+bool Sound::hasSamples() const { return !samples.empty(); }
+
+// Gets the kept decoded samples, interleaved by channel
+std::vector<short> const& Sound::getSamples() const { return samples; }
+
+// Gets the number of bytes of the kept decoded samples
+size_t Sound::getSampleMemorySize() const {
+  return samples.capacity() * sizeof(short);
+}
+
 }  // namespace openhoi
\ No newline at end of file
@@ -0,0 +1,137 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "audio/source_pool.hpp"
+
+#include <OgreLogManager.h>
+
+#include <boost/format.hpp>
+
+namespace openhoi {
+
+// Generates the provided number of sources in the current OpenAL context
+SourcePool::SourcePool(size_t maxVoices) : nextSequence(0) {
+  // Generate the sources one by one, as the device may support less than
+  // requested
+  alGetError();
+  voices.reserve(maxVoices);
+  for (size_t i = 0; i < maxVoices; i++) {
+    ALuint source;
+    alGenSources(1, &source);
+    if (alGetError() != AL_NO_ERROR) break;
+    alSourcei(source, AL_LOOPING, AL_FALSE);
+    alSourcei(source, AL_SOURCE_RELATIVE, AL_FALSE);
+    voices.push_back({source, nullptr, 0.0f, SoundPriority::Low, 0});
+  }
+  if (voices.size() < maxVoices) {
+    Ogre::LogManager::getSingletonPtr()->logMessage(
+        (boost::format("Only %d of %d audio voices could be generated") %
+         voices.size() % maxVoices)
+            .str(),
+        Ogre::LogMessageLevel::LML_WARNING);
+  }
+
+  // Hand out the voices from the back of the free list
+  freeVoices.reserve(voices.size());
+  for (size_t i = voices.size(); i > 0; i--) freeVoices.push_back(i - 1);
+}
+
+// Stops and deletes all sources
+SourcePool::~SourcePool() {
+  stopAll();
+  for (auto const& voice : voices) alDeleteSources(1, &voice.source);
+}
+
+// Plays the provided sound with the given volume on a free voice. If all voices
+// are in use, the voice with the lowest priority is stolen, the quietest and
+// then the oldest one first. Returns false in case all voices play sounds with
+// a higher priority
+bool SourcePool::play(std::shared_ptr<Sound> sound, float volume,
+                      SoundPriority priority) {
+  // Take a free voice. Only if there is none, search for one to steal, which is
+  // bounded by the fixed number of voices
+  size_t index;
+  if (!freeVoices.empty()) {
+    index = freeVoices.back();
+    freeVoices.pop_back();
+  } else {
+    index = findVictim(priority);
+    if (index == voices.size()) return false;
+    release(index);
+  }
+
+  Voice& voice = voices[index];
+  alSourcei(voice.source, AL_BUFFER, sound->getBuffer());
+  alSourcef(voice.source, AL_GAIN, volume);
+  alSourcePlay(voice.source);
+  voice.sound = std::move(sound);
+  voice.volume = volume;
+  voice.priority = priority;
+  voice.sequence = nextSequence++;
+  return true;
+}
+
+// Frees the voices of finished sounds and sets the volume of all others
+void SourcePool::update(float volume) {
+  ALint state;
+  for (size_t i = 0; i < voices.size(); i++) {
+    Voice& voice = voices[i];
+    if (!voice.sound) continue;
+    alGetSourcei(voice.source, AL_SOURCE_STATE, &state);
+    if (state == AL_STOPPED) {
+      release(i);
+      freeVoices.push_back(i);
+    } else {
+      alSourcef(voice.source, AL_GAIN, volume);
+    }
+  }
+}
+
+// Stops all sounds and frees their voices
+void SourcePool::stopAll() {
+  for (size_t i = 0; i < voices.size(); i++) {
+    if (!voices[i].sound) continue;
+    release(i);
+    freeVoices.push_back(i);
+  }
+}
+
+// Gets the number of voices that are playing
+size_t SourcePool::getActiveCount() const {
+  return voices.size() - freeVoices.size();
+}
+
+// Gets the number of voices
+size_t SourcePool::getVoiceCount() const { return voices.size(); }
+
+// Finds the voice to steal for a sound with the provided priority. Returns the
+// number of voices in case there is none
+size_t SourcePool::findVictim(SoundPriority priority) const {
+  size_t victim = voices.size();
+  for (size_t i = 0; i < voices.size(); i++) {
+    Voice const& voice = voices[i];
+    if (!voice.sound || voice.priority > priority) continue;
+    if (victim == voices.size()) {
+      victim = i;
+      continue;
+    }
+    Voice const& best = voices[victim];
+    if (voice.priority != best.priority) {
+      if (voice.priority < best.priority) victim = i;
+    } else if (voice.volume != best.volume) {
+      if (voice.volume < best.volume) victim = i;
+    } else if (voice.sequence < best.sequence) {
+      victim = i;
+    }
+  }
+  return victim;
+}
+
+// Stops the voice and detaches its sound, so that its buffer can be deleted
+void SourcePool::release(size_t index) {
+  Voice& voice = voices[index];
+  alSourceStop(voice.source);
+  alSourcei(voice.source, AL_BUFFER, 0);
+  voice.sound.reset();
+}
+
+}  // namespace openhoi
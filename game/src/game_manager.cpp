@@ -32,6 +32,9 @@ GameManager::GameManager() {
   // Create options instance and load options from file
   options = std::make_unique<Options>();
 
+  // Start the I/O threads for reading asset files in the background
+  fileReadService = std::make_unique<FileReadService>();
+
   // Initialize logging
   logManager = OGRE_NEW Ogre::LogManager();
   std::string logFile = (FileAccess::getUserGameConfigDirectory() /
@@ -55,6 +58,12 @@ GameManager::GameManager() {
   // Load the ParticleFX plugin
   root->loadPlugin(getPluginPath(OGRE_PLUGIN_PARTICLEFX));
 
+  // Register the asset archive type, so that resources can be located inside
+  // the packed asset archive
+  assetArchiveFactory = std::make_unique<OgreAssetArchiveFactory>();
+  Ogre::ArchiveManager::getSingleton().addArchiveFactory(
+      assetArchiveFactory.get());
+
   // Initialize root
   root->initialise(false);
 
@@ -143,6 +152,12 @@ std::shared_ptr<AudioManager> const& GameManager::getAudioManager() const {
   return audioManager;
 }
 
+// Gets the service for reading asset files in the background
+std::unique_ptr<FileReadService> const& GameManager::getFileReadService()
+    const {
+  return fileReadService;
+}
+
 // Gets the OGRE root
 Ogre::Root* const& GameManager::getRoot() const { return root; }
 
@@ -443,42 +458,51 @@ void GameManager::destroyWindow() {
 // Locate resources
 void GameManager::locateResources() {
   filesystem::path assetRoot = FileAccess::getAssetRootDirectory();
+  std::string assetType = "FileSystem";
+
+  // Locate the assets inside the packed asset archive if there is one, so that
+  // they are read from a single file
+  auto assetArchive = FileAccess::getAssetArchive();
+  if (assetArchive) {
+    assetRoot = assetArchive->getPath();
+    assetType = OPENHOI_OGRE_ASSET_ARCHIVE_TYPE;
+  }
 #ifndef OPENHOI_OS_WINDOWS
   filesystem::path mediaRoot = FileAccess::getOgreMediaRootDirectory();
 #endif
 
   // Declare all font resources
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-      (assetRoot / "fonts").u8string(), "FileSystem", Ogre::RGN_DEFAULT);
+      (assetRoot / "fonts").u8string(), assetType, Ogre::RGN_DEFAULT);
 
   // Declare all texture resources
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-      (assetRoot / "graphics").u8string(), "FileSystem", Ogre::RGN_DEFAULT);
+      (assetRoot / "graphics").u8string(), assetType, Ogre::RGN_DEFAULT);
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-      (assetRoot / "graphics" / "coat_of_arms").u8string(), "FileSystem",
+      (assetRoot / "graphics" / "coat_of_arms").u8string(), assetType,
       OPENHOI_RSG_COA_TEXTURES);
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-      (assetRoot / "graphics" / "flags").u8string(), "FileSystem",
+      (assetRoot / "graphics" / "flags").u8string(), assetType,
       OPENHOI_RSG_FLAG_TEXTURES);
 
   // Declare all material/shader resources
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-      (assetRoot / "materials").u8string(), "FileSystem", Ogre::RGN_DEFAULT);
+      (assetRoot / "materials").u8string(), assetType, Ogre::RGN_DEFAULT);
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-      (assetRoot / "materials" / "glsl").u8string(), "FileSystem",
+      (assetRoot / "materials" / "glsl").u8string(), assetType,
       Ogre::RGN_DEFAULT);
 #ifdef OPENHOI_OS_WINDOWS
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-      (assetRoot / "materials" / "glsl" / "win64").u8string(), "FileSystem",
+      (assetRoot / "materials" / "glsl" / "win64").u8string(), assetType,
       Ogre::RGN_DEFAULT);
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-      (assetRoot / "materials" / "hlsl").u8string(), "FileSystem",
+      (assetRoot / "materials" / "hlsl").u8string(), assetType,
       Ogre::RGN_DEFAULT);
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-      (assetRoot / "materials" / "hlsl" / "win64").u8string(), "FileSystem",
+      (assetRoot / "materials" / "hlsl" / "win64").u8string(), assetType,
       Ogre::RGN_DEFAULT);
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-      (assetRoot / "materials" / "win64").u8string(), "FileSystem",
+      (assetRoot / "materials" / "win64").u8string(), assetType,
       Ogre::RGN_DEFAULT);
 #elif defined(OPENHOI_OS_LINUX) || defined(OPENHOI_OS_BSD)
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
@@ -488,11 +512,11 @@ void GameManager::locateResources() {
 
   // Declare all particle resources
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-      (assetRoot / "particles").u8string(), "FileSystem", Ogre::RGN_DEFAULT);
+      (assetRoot / "particles").u8string(), assetType, Ogre::RGN_DEFAULT);
 
   // Declare all mesh resources
   Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-      (assetRoot / "meshes").u8string(), "FileSystem", Ogre::RGN_DEFAULT);
+      (assetRoot / "meshes").u8string(), assetType, Ogre::RGN_DEFAULT);
 }
 
 // Load resources
@@ -630,6 +654,9 @@ bool GameManager::frameStarted(const Ogre::FrameEvent& evt) {
   // Refresh audio status
   audioManager->updateStats();
 
+  // Hand over asset files that were read in the background
+  fileReadService->dispatch();
+
   return true;
 }
 
@@ -4,6 +4,8 @@
 
 #include <hoibase/helper/unique_id.hpp>
 
+#include "game_manager.hpp"
+
 namespace openhoi {
 
 // Creates the debug console
@@ -57,6 +59,17 @@ void DebugConsole::draw() {
       "along with extra data such as timestamp, emitter, etc.");
   ImGui::Separator();
 
+  // Show the audio samples that are resident in memory
+  auto const& audioManager = GameManager::getInstance().getAudioManager();
+  if (audioManager) {
+    AudioMemoryUsage usage = audioManager->getMemoryUsage();
+    ImGui::Text(
+        "Audio memory: %zu KB effect buffers, %zu KB effect samples, %zu KB "
+        "music stream",
+        usage.buffers / 1024, usage.samples / 1024, usage.stream / 1024);
+    ImGui::Separator();
+  }
+
   filter.Draw("Filter (\"incl,-excl\") (\"error\")", 180);
   ImGui::Separator();
 
@@ -22,6 +22,7 @@
 #define OPTION_KEY_AUDIO_DEVICE audioDevice
 #define OPTION_KEY_MUSIC_VOLUME musicVolume
 #define OPTION_KEY_EFFECTS_VOLUME effectsVolume
+#define OPTION_KEY_MESH_QUALITY meshQuality
 
 namespace openhoi {
 
@@ -33,7 +34,8 @@ Options::Options()
       verticalSync(false),
       audioDevice(""),
       musicVolume(35),
-      effectsVolume(70) {
+      effectsVolume(70),
+      meshQuality(DefaultMeshQuality) {
   // Load options from file, overwriting the defaults set before
   loadFromFile();
 }
@@ -68,6 +70,9 @@ void Options::loadFromFile() {
     musicVolume = doc[TOSTRING(OPTION_KEY_MUSIC_VOLUME)].GetInt();
   if (doc[TOSTRING(OPTION_KEY_EFFECTS_VOLUME)].IsFloat())
     effectsVolume = doc[TOSTRING(OPTION_KEY_EFFECTS_VOLUME)].GetInt();
+  if (doc[TOSTRING(OPTION_KEY_MESH_QUALITY)].IsString())
+    parseMeshQuality(doc[TOSTRING(OPTION_KEY_MESH_QUALITY)].GetString(),
+                     meshQuality);
 }
 
 // Save options to file
@@ -85,6 +90,8 @@ void Options::saveToFile() {
   doc.AddMember(TOSTRING(OPTION_KEY_AUDIO_DEVICE), audioDevice, allocator);
   doc.AddMember(TOSTRING(OPTION_KEY_MUSIC_VOLUME), musicVolume, allocator);
   doc.AddMember(TOSTRING(OPTION_KEY_EFFECTS_VOLUME), effectsVolume, allocator);
+  rapidjson::Value meshQualityName(getMeshQualityName(meshQuality), allocator);
+  doc.AddMember(TOSTRING(OPTION_KEY_MESH_QUALITY), meshQualityName, allocator);
 
   // Open output stream
   std::ofstream ofs(FileAccess::getUserGameConfigDirectory() /
@@ -156,4 +163,12 @@ void Options::setEffectsVolume(float const& effectsVolume) {
       effectsVolume > 1.0f ? 100 : (int)(std::max(effectsVolume, 0.0f) * 100);
 }
 
+// Gets the mesh quality of the map provinces
+MeshQuality const& Options::getMeshQuality() const { return meshQuality; }
+
+// Sets the mesh quality of the map provinces
+void Options::setMeshQuality(MeshQuality const& meshQuality) {
+  this->meshQuality = meshQuality;
+}
+
 }  // namespace openhoi
\ No newline at end of file
@@ -0,0 +1,63 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "helper/memory.hpp"
+
+#include <hoibase/helper/os.hpp>
+
+#include <fstream>
+#include <string>
+
+#ifdef OPENHOI_OS_LINUX
+#  include <malloc.h>
+#endif
+
+namespace openhoi {
+
+#ifdef OPENHOI_OS_LINUX
+// Reads a memory field (in kB) out of the process status
+static size_t readStatusField(std::string const& field) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, field.size(), field) == 0 &&
+        line.size() > field.size() && line[field.size()] == ':')
+      return std::stoull(line.substr(field.size() + 1)) * 1024;
+  }
+  return 0;
+}
+#endif
+
+// Resets the peak resident set size of the process to its current resident set
+// size, so that the next peak only covers the code that runs afterwards
+void resetPeakMemory() {
+#ifdef OPENHOI_OS_LINUX
+  // Hand freed heap memory back to the system first, otherwise it still counts
+  // towards the current resident set size
+#  ifdef __GLIBC__
+  malloc_trim(0);
+#  endif
+  std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+// Gets the peak resident set size of the process in bytes since the last reset.
+// Returns 0 if the platform does not report it
+size_t getPeakMemory() {
+#ifdef OPENHOI_OS_LINUX
+  return readStatusField("VmHWM");
+#else
+  return 0;
+#endif
+}
+
+// Gets the current resident set size of the process in bytes. Returns 0 if the
+// platform does not report it
+size_t getCurrentMemory() {
+#ifdef OPENHOI_OS_LINUX
+  return readStatusField("VmRSS");
+#else
+  return 0;
+#endif
+}
+
+}  // namespace openhoi
@@ -0,0 +1,21 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+
+namespace openhoi {
+
+// Resets the peak resident set size of the process to its current resident set
+// size, so that the next peak only covers the code that runs afterwards
+void resetPeakMemory();
+
+// Gets the peak resident set size of the process in bytes since the last reset.
+// Returns 0 if the platform does not report it
+size_t getPeakMemory();
+
+// Gets the current resident set size of the process in bytes. Returns 0 if the
+// platform does not report it
+size_t getCurrentMemory();
+
+}  // namespace openhoi
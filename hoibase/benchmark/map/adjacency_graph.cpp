@@ -0,0 +1,75 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <hoibase/map/adjacency_graph.hpp>
+
+namespace openhoi {
+
+// Fills a province store with a grid of square provinces. Every side of a
+// square has the provided number of points, so neighbouring squares share all
+// points of their common side
+static void fillGrid(ProvinceStore& store, size_t provinceCount,
+                     size_t pointsPerSide) {
+  // Points are computed from integer lattice coordinates, so both provinces
+  // along a side get exactly the same values
+  size_t columns = (size_t)std::ceil(std::sqrt((double)provinceCount));
+  Ogre::Real step = 10.0f / (Ogre::Real)pointsPerSide;
+  auto point = [step](size_t x, size_t y) {
+    return Ogre::Vector2((Ogre::Real)x * step, (Ogre::Real)y * step);
+  };
+
+  std::vector<Ogre::Vector2> ring;
+  for (size_t i = 0; i < provinceCount; i++) {
+    size_t x = (i % columns) * pointsPerSide;
+    size_t y = (i / columns) * pointsPerSide;
+    size_t n = pointsPerSide;
+    ring.clear();
+    for (size_t j = 0; j < n; j++) ring.push_back(point(x + j, y));
+    for (size_t j = 0; j < n; j++) ring.push_back(point(x + n, y + j));
+    for (size_t j = 0; j < n; j++) ring.push_back(point(x + n - j, y + n));
+    for (size_t j = 0; j < n; j++) ring.push_back(point(x, y + n - j));
+    std::vector<ArrayView<Ogre::Vector2>> rings = {ring};
+    store.add("P" + std::to_string(i), rings, Ogre::Vector2(0, 0));
+  }
+}
+
+// Builds the adjacency graph of a grid of provinces with 64 points each
+static void BM_MapAdjacencyGraphBuild(benchmark::State& state) {
+  ProvinceStore store;
+  fillGrid(store, (size_t)state.range(0), 16);
+
+  size_t edges = 0;
+  for (auto _ : state) {
+    AdjacencyGraph graph(store);
+    edges = graph.getEdgeCount();
+  }
+  state.SetItemsProcessed((int64_t)state.iterations() *
+                          (int64_t)store.getPointCount());
+  state.counters["neighbour_pairs"] = (double)edges;
+}
+BENCHMARK(BM_MapAdjacencyGraphBuild)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(50000)
+    ->Unit(benchmark::kMillisecond);
+
+// Sums up the neighbour counts of all provinces
+static void BM_MapAdjacencyGraphNeighbours(benchmark::State& state) {
+  ProvinceStore store;
+  fillGrid(store, (size_t)state.range(0), 16);
+  AdjacencyGraph graph(store);
+
+  for (auto _ : state) {
+    size_t count = 0;
+    for (ProvinceHandle province = 0; province < graph.size(); province++)
+      for (ProvinceHandle neighbour : graph.getNeighbours(province))
+        count += neighbour & 1;
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)graph.size());
+}
+BENCHMARK(BM_MapAdjacencyGraphNeighbours)->Arg(10000)->Arg(50000);
+
+}  // namespace openhoi
@@ -0,0 +1,68 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <hoibase/map/map_factory.hpp>
+
+#include "helper/memory.hpp"
+#include "map/synthetic_map.hpp"
+
+namespace openhoi {
+
+// Parses a synthetic GeoJSON map with the provided parser and reports the wall
+// time as well as the peak resident set size above the generated input
+template <typename Parser>
+static void benchmarkGeoJSON(benchmark::State& state, Parser parser) {
+  std::string geoJSON = generateSyntheticGeoJSON((size_t)state.range(0));
+
+  size_t peak = 0;
+  size_t provinces = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    resetPeakMemory();
+    size_t base = getCurrentMemory();
+    state.ResumeTiming();
+
+    std::unique_ptr<Map> map = parser(geoJSON.data(), geoJSON.size());
+    provinces = map->getProvinces().size();
+
+    state.PauseTiming();
+    size_t iterationPeak = getPeakMemory();
+    if (iterationPeak > base) peak = std::max(peak, iterationPeak - base);
+    map.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetBytesProcessed((int64_t)state.iterations() *
+                          (int64_t)geoJSON.size());
+  state.counters["provinces"] = (double)provinces;
+  state.counters["peak_rss"] = benchmark::Counter(
+      (double)peak, benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+}
+
+// Builds the whole document tree before walking the features
+static void BM_MapParseGeoJSONDocument(benchmark::State& state) {
+  benchmarkGeoJSON(state, [](char const* data, size_t size) {
+    return MapFactory::parseGeoJSON(data, size);
+  });
+}
+BENCHMARK(BM_MapParseGeoJSONDocument)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Reads the features one by one without a document tree
+static void BM_MapParseGeoJSONStream(benchmark::State& state) {
+  benchmarkGeoJSON(state, [](char const* data, size_t size) {
+    return MapFactory::streamGeoJSON(data, size);
+  });
+}
+BENCHMARK(BM_MapParseGeoJSONStream)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace openhoi
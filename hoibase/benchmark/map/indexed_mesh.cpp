@@ -0,0 +1,47 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <benchmark/benchmark.h>
+
+#include <hoibase/map/indexed_mesh.hpp>
+#include <hoibase/map/map_factory.hpp>
+
+#include "map/synthetic_map.hpp"
+
+namespace openhoi {
+
+// Expands the kept indexed meshes of all provinces of a synthetic map into
+// triangle lists and reports the memory used by both representations
+static void BM_MapIndexedMesh(benchmark::State& state) {
+  std::string geoJSON = generateSyntheticGeoJSON((size_t)state.range(0));
+  std::unique_ptr<Map> map =
+      MapFactory::streamGeoJSON(geoJSON.data(), geoJSON.size());
+  auto const& provinces = map->getProvinces();
+  for (ProvinceHandle i = 0; i < provinces.size(); i++)
+    provinces.getIndexedMesh(i);
+
+  size_t triangleBytes = 0;
+  size_t indexedBytes = 0;
+  for (auto _ : state) {
+    triangleBytes = 0;
+    indexedBytes = 0;
+    for (ProvinceHandle i = 0; i < provinces.size(); i++) {
+      auto const& mesh = provinces.getIndexedMesh(i);
+      auto triangles = mesh.toTriangles();
+      triangleBytes += triangles.size() * sizeof(Ogre::Real);
+      indexedBytes += mesh.getMemorySize();
+    }
+  }
+
+  state.SetItemsProcessed((int64_t)state.iterations() *
+                          (int64_t)provinces.size());
+  state.counters["triangle_bytes"] = (double)triangleBytes;
+  state.counters["indexed_bytes"] = (double)indexedBytes;
+  state.counters["saving"] =
+      triangleBytes ? 1.0 - (double)indexedBytes / (double)triangleBytes : 0.0;
+}
+BENCHMARK(BM_MapIndexedMesh)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace openhoi
@@ -0,0 +1,165 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <benchmark/benchmark.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
+
+#include <hoibase/map/map_factory.hpp>
+#include <hoibase/map/map_triangulator.hpp>
+
+#include "map/synthetic_map.hpp"
+
+// The map loading benchmarks time every phase of loading a map on its own, so
+// that a regression shows up in the phase that caused it. They all run on
+// synthetic maps with the number of provinces and the number of points per
+// province as arguments.
+
+namespace openhoi {
+
+// Registers the map sizes and point counts of the map loading benchmarks
+static void mapLoadingArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->Args({1000, 64})
+      ->Args({10000, 64})
+      ->Args({50000, 64})
+      ->Args({10000, 16})
+      ->Args({10000, 256})
+      ->Unit(benchmark::kMillisecond)
+      ->UseRealTime();
+}
+
+// Generates the synthetic map of the benchmark arguments
+static std::string generateMap(benchmark::State& state) {
+  return generateSyntheticGeoJSON((size_t)state.range(0),
+                                  (size_t)state.range(1));
+}
+
+// Reads the provinces of the synthetic map of the benchmark arguments
+static std::vector<Province> readProvinces(benchmark::State& state) {
+  std::string geoJSON = generateMap(state);
+  std::vector<Province> provinces;
+  MapFactory::streamGeoJSON(
+      geoJSON.data(), geoJSON.size(),
+      [&provinces](Province province) {
+        provinces.push_back(std::move(province));
+      });
+  return provinces;
+}
+
+// Copies the provided provinces, which are move-only
+static std::vector<Province> copyProvinces(
+    std::vector<Province> const& source) {
+  std::vector<Province> provinces;
+  provinces.reserve(source.size());
+  for (auto const& province : source)
+    provinces.emplace_back(province.getID(), province.getCoordinates(),
+                           province.getCenter());
+  return provinces;
+}
+
+// Sets the counters shared by all map loading benchmarks
+static void setCounters(benchmark::State& state, size_t provinces) {
+  state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)provinces);
+  state.counters["provinces"] = (double)provinces;
+  state.counters["points"] = (double)state.range(1);
+}
+
+// Tokenizes the GeoJSON data without handling any of it, which is the lower
+// bound for reading the map file
+static void BM_MapLoadParse(benchmark::State& state) {
+  std::string geoJSON = generateMap(state);
+  for (auto _ : state) {
+    rapidjson::Reader reader;
+    rapidjson::BaseReaderHandler<> handler;
+    rapidjson::MemoryStream stream(geoJSON.data(), geoJSON.size());
+    benchmark::DoNotOptimize(reader.Parse(stream, handler).IsError());
+  }
+  state.SetBytesProcessed((int64_t)state.iterations() *
+                          (int64_t)geoJSON.size());
+  setCounters(state, (size_t)state.range(0));
+}
+BENCHMARK(BM_MapLoadParse)->Apply(mapLoadingArgs);
+
+// Reads the GeoJSON features into provinces, without adding them to a map
+static void BM_MapLoadFeatures(benchmark::State& state) {
+  std::string geoJSON = generateMap(state);
+  size_t provinces = 0;
+  for (auto _ : state) {
+    provinces = 0;
+    MapFactory::streamGeoJSON(geoJSON.data(), geoJSON.size(),
+                              [&provinces](Province province) {
+                                benchmark::DoNotOptimize(province);
+                                provinces++;
+                              });
+  }
+  state.SetBytesProcessed((int64_t)state.iterations() *
+                          (int64_t)geoJSON.size());
+  setCounters(state, provinces);
+}
+BENCHMARK(BM_MapLoadFeatures)->Apply(mapLoadingArgs);
+
+// Constructs the provinces out of their already read coordinates
+static void BM_MapLoadProvinces(benchmark::State& state) {
+  std::vector<Province> source = readProvinces(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<std::vector<std::vector<Ogre::Vector2>>> coordinates;
+    coordinates.reserve(source.size());
+    for (auto const& province : source)
+      coordinates.push_back(province.getCoordinates());
+    std::vector<Province> provinces;
+    provinces.reserve(source.size());
+    state.ResumeTiming();
+
+    for (size_t i = 0; i < source.size(); i++)
+      provinces.emplace_back(source[i].getID(), std::move(coordinates[i]),
+                             source[i].getCenter());
+    benchmark::DoNotOptimize(provinces.data());
+
+    state.PauseTiming();
+    provinces.clear();
+    state.ResumeTiming();
+  }
+  setCounters(state, source.size());
+}
+BENCHMARK(BM_MapLoadProvinces)->Apply(mapLoadingArgs);
+
+// Inserts the already constructed provinces into a map
+static void BM_MapLoadInsert(benchmark::State& state) {
+  std::vector<Province> source = readProvinces(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<Province> provinces = copyProvinces(source);
+    state.ResumeTiming();
+
+    std::unique_ptr<Map> map = std::make_unique<Map>(6378137);
+    for (auto& province : provinces) map->addProvince(std::move(province));
+    benchmark::DoNotOptimize(map->getProvinces().size());
+
+    state.PauseTiming();
+    map.reset();
+    state.ResumeTiming();
+  }
+  setCounters(state, source.size());
+}
+BENCHMARK(BM_MapLoadInsert)->Apply(mapLoadingArgs);
+
+// Triangulates all provinces of the map with the default triangulator on all
+// hardware threads
+static void BM_MapLoadTriangulate(benchmark::State& state) {
+  std::string geoJSON = generateMap(state);
+  std::unique_ptr<Map> map =
+      MapFactory::streamGeoJSON(geoJSON.data(), geoJSON.size());
+  ProvinceStore& provinces = map->getProvinces();
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (ProvinceHandle i = 0; i < provinces.size(); i++)
+      provinces.invalidateTriangulation(i);
+    state.ResumeTiming();
+
+    MapTriangulator::triangulateProvinces(*map);
+  }
+  setCounters(state, provinces.size());
+}
+BENCHMARK(BM_MapLoadTriangulate)->Apply(mapLoadingArgs);
+
+}  // namespace openhoi
@@ -0,0 +1,45 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <hoibase/map/map_factory.hpp>
+#include <hoibase/map/map_lod.hpp>
+
+#include "map/synthetic_map.hpp"
+
+namespace openhoi {
+
+// Builds all levels of detail of a synthetic map and reports the number of
+// points that remain on every level
+static void BM_MapLODBuild(benchmark::State& state) {
+  std::string geoJSON = generateSyntheticGeoJSON((size_t)state.range(0));
+  std::unique_ptr<Map> map =
+      MapFactory::streamGeoJSON(geoJSON.data(), geoJSON.size());
+  auto const& bounds = map->getSpatialIndex().getBounds();
+  Ogre::Real width = bounds.max.x - bounds.min.x;
+  Ogre::Real height = bounds.max.y - bounds.min.y;
+  auto tolerances = MapLOD::getDefaultTolerances(
+      std::sqrt(width * width + height * height));
+
+  std::vector<size_t> pointCounts;
+  for (auto _ : state) {
+    MapLOD lod(map->getProvinces(), tolerances);
+    pointCounts.clear();
+    for (size_t level = 0; level < lod.getLevelCount(); level++)
+      pointCounts.push_back(lod.getPointCount(level));
+  }
+
+  state.SetItemsProcessed((int64_t)state.iterations() *
+                          (int64_t)map->getProvinces().getPointCount());
+  for (size_t level = 0; level < pointCounts.size(); level++)
+    state.counters["points_lod" + std::to_string(level)] =
+        (double)pointCounts[level];
+}
+BENCHMARK(BM_MapLODBuild)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(50000)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace openhoi
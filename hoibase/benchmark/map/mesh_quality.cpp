@@ -0,0 +1,40 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <benchmark/benchmark.h>
+
+#include <hoibase/map/map_factory.hpp>
+#include <hoibase/map/mesh_quality.hpp>
+
+#include "map/synthetic_map.hpp"
+
+namespace openhoi {
+
+// Triangulates all provinces of a synthetic map with one mesh quality preset
+// and reports the number of triangles produced
+static void BM_MapTriangulateQuality(benchmark::State& state) {
+  MeshQuality quality = (MeshQuality)state.range(0);
+  std::string geoJSON = generateSyntheticGeoJSON((size_t)state.range(1));
+  std::unique_ptr<Map> map =
+      MapFactory::streamGeoJSON(geoJSON.data(), geoJSON.size());
+  auto const& provinces = map->getProvinces();
+
+  size_t triangles = 0;
+  for (auto _ : state) {
+    triangles = 0;
+    for (ProvinceHandle i = 0; i < provinces.size(); i++)
+      triangles += Province::triangulate(provinces.getRings(i), quality).size();
+  }
+  triangles /= 9;
+
+  state.SetLabel(getMeshQualityName(quality));
+  state.SetItemsProcessed((int64_t)state.iterations() *
+                          (int64_t)provinces.size());
+  state.counters["triangles"] = (double)triangles;
+}
+BENCHMARK(BM_MapTriangulateQuality)
+    ->Args({(int)MeshQuality::ConstrainedOnly, 1000})
+    ->Args({(int)MeshQuality::Refined, 1000})
+    ->Args({(int)MeshQuality::RefinedLloyd, 1000})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace openhoi
@@ -0,0 +1,33 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <benchmark/benchmark.h>
+
+#include <hoibase/map/map_factory.hpp>
+#include <hoibase/map/province_center.hpp>
+
+#include "map/synthetic_map.hpp"
+
+namespace openhoi {
+
+// Computes the centers of all provinces of a synthetic map with the provided
+// number of threads
+static void BM_MapProvinceCenters(benchmark::State& state) {
+  std::string geoJSON = generateSyntheticGeoJSON((size_t)state.range(0));
+  std::unique_ptr<Map> map =
+      MapFactory::streamGeoJSON(geoJSON.data(), geoJSON.size());
+  ProvinceStore& provinces = map->getProvinces();
+
+  for (auto _ : state)
+    ProvinceCenter::computeCenters(provinces, (unsigned int)state.range(1));
+
+  state.SetItemsProcessed((int64_t)state.iterations() *
+                          (int64_t)provinces.size());
+}
+BENCHMARK(BM_MapProvinceCenters)
+    ->Args({1000, 1})
+    ->Args({10000, 1})
+    ->Args({10000, 0})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace openhoi
@@ -0,0 +1,105 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <benchmark/benchmark.h>
+
+#include <hoibase/map/map_factory.hpp>
+#include <hoibase/map/spatial_index.hpp>
+#include <random>
+
+#include "map/synthetic_map.hpp"
+
+namespace openhoi {
+
+// Generates random points inside of the map bounds. A fixed seed keeps the
+// points the same between runs
+static std::vector<Ogre::Vector2> generatePoints(BoundingBox const& bounds,
+                                                 size_t count) {
+  std::mt19937 random(42);
+  std::uniform_real_distribution<Ogre::Real> x(bounds.min.x, bounds.max.x);
+  std::uniform_real_distribution<Ogre::Real> y(bounds.min.y, bounds.max.y);
+  std::vector<Ogre::Vector2> points;
+  points.reserve(count);
+  for (size_t i = 0; i < count; i++)
+    points.push_back(Ogre::Vector2(x(random), y(random)));
+  return points;
+}
+
+// Loads a synthetic map with the provided number of provinces
+static std::unique_ptr<Map> loadSyntheticMap(benchmark::State& state) {
+  std::string geoJSON = generateSyntheticGeoJSON((size_t)state.range(0));
+  return MapFactory::streamGeoJSON(geoJSON.data(), geoJSON.size());
+}
+
+// Builds the spatial index of the whole map
+static void BM_MapSpatialIndexBuild(benchmark::State& state) {
+  std::unique_ptr<Map> map = loadSyntheticMap(state);
+  for (auto _ : state) {
+    SpatialIndex index(map->getProvinces());
+    benchmark::DoNotOptimize(index.getBounds());
+  }
+  state.counters["provinces"] = (double)map->getProvinces().size();
+}
+BENCHMARK(BM_MapSpatialIndexBuild)
+    ->Arg(10000)
+    ->Arg(50000)
+    ->Unit(benchmark::kMillisecond);
+
+// Picks the provinces below random points through the spatial index
+static void BM_MapSpatialIndexPick(benchmark::State& state) {
+  std::unique_ptr<Map> map = loadSyntheticMap(state);
+  SpatialIndex const& index = map->getSpatialIndex();
+  auto points = generatePoints(index.getBounds(), 4096);
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(index.pick(points[i++ & 4095]));
+  }
+  state.SetItemsProcessed((int64_t)state.iterations());
+}
+BENCHMARK(BM_MapSpatialIndexPick)->Arg(10000)->Arg(50000);
+
+// Picks the provinces below random points by testing every province, which is
+// what the spatial index is measured against
+static void BM_MapSpatialIndexPickLinear(benchmark::State& state) {
+  std::unique_ptr<Map> map = loadSyntheticMap(state);
+  ProvinceStore const& provinces = map->getProvinces();
+  auto points = generatePoints(map->getSpatialIndex().getBounds(), 4096);
+
+  size_t i = 0;
+  for (auto _ : state) {
+    Ogre::Vector2 const& point = points[i++ & 4095];
+    ProvinceHandle result = InvalidProvinceHandle;
+    for (ProvinceHandle province = 0; province < provinces.size(); province++) {
+      if (SpatialIndex::contains(provinces, province, point)) {
+        result = province;
+        break;
+      }
+    }
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed((int64_t)state.iterations());
+}
+BENCHMARK(BM_MapSpatialIndexPickLinear)->Arg(10000)->Arg(50000);
+
+// Collects the provinces inside of a view sized rectangle at random positions
+static void BM_MapSpatialIndexQuery(benchmark::State& state) {
+  std::unique_ptr<Map> map = loadSyntheticMap(state);
+  SpatialIndex const& index = map->getSpatialIndex();
+  auto points = generatePoints(index.getBounds(), 4096);
+  const Ogre::Vector2 viewSize(200.0f, 100.0f);
+
+  size_t i = 0;
+  size_t found = 0;
+  for (auto _ : state) {
+    Ogre::Vector2 const& point = points[i++ & 4095];
+    auto result = index.query(point, point + viewSize);
+    found += result.size();
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed((int64_t)state.iterations());
+  state.counters["provinces_per_query"] =
+      (double)found / (double)state.iterations();
+}
+BENCHMARK(BM_MapSpatialIndexQuery)->Arg(10000)->Arg(50000);
+
+}  // namespace openhoi
@@ -0,0 +1,47 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "map/synthetic_map.hpp"
+
+#include <boost/format.hpp>
+#include <cmath>
+
+namespace openhoi {
+
+// Generates a GeoJSON feature collection with the provided number of
+// provinces. Every province is a closed ring with the provided number of points
+// on a square grid, so the output is deterministic for the same arguments
+std::string generateSyntheticGeoJSON(size_t provinceCount,
+                                     size_t pointsPerProvince) {
+  const double pi = 3.14159265358979323846;
+  size_t columns = (size_t)std::ceil(std::sqrt((double)provinceCount));
+
+  std::string geoJSON = "{\"type\":\"FeatureCollection\",\"features\":[";
+  for (size_t i = 0; i < provinceCount; i++) {
+    if (i > 0) geoJSON += ",";
+    geoJSON += (boost::format("{\"type\":\"Feature\",\"properties\":"
+                              "{\"name\":\"P%d\"},\"geometry\":{\"type\":"
+                              "\"LineString\",\"coordinates\":[") %
+                i)
+                   .str();
+
+    // Place a wobbly circle into the grid cell of the province. The last point
+    // closes the ring
+    double centerX = (double)(i % columns) * 10.0 + 5.0;
+    double centerY = (double)(i / columns) * 10.0 + 5.0;
+    for (size_t j = 0; j <= pointsPerProvince; j++) {
+      double angle = 2.0 * pi * (double)(j % pointsPerProvince) /
+                     (double)pointsPerProvince;
+      double radius = 4.0 + 0.5 * std::sin(7.0 * angle + (double)i);
+      if (j > 0) geoJSON += ",";
+      geoJSON += (boost::format("[%.6f,%.6f]") %
+                  (centerX + radius * std::cos(angle)) %
+                  (centerY + radius * std::sin(angle)))
+                     .str();
+    }
+    geoJSON += "]}}";
+  }
+  geoJSON += "]}";
+  return geoJSON;
+}
+
+}  // namespace openhoi
@@ -0,0 +1,16 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace openhoi {
+
+// Generates a GeoJSON feature collection with the provided number of
+// provinces. Every province is a closed ring with the provided number of points
+// on a square grid, so the output is deterministic for the same arguments
+std::string generateSyntheticGeoJSON(size_t provinceCount,
+                                     size_t pointsPerProvince = 64);
+
+}  // namespace openhoi
@@ -0,0 +1,55 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <benchmark/benchmark.h>
+
+#include <hoibase/map/cgal_triangulator.hpp>
+#include <hoibase/map/ear_clip_triangulator.hpp>
+#include <hoibase/map/map_factory.hpp>
+
+#include "map/synthetic_map.hpp"
+
+namespace openhoi {
+
+// Triangulates all provinces of a synthetic map with the provided triangulator
+// and reports the number of triangles produced
+static void benchmarkTriangulator(benchmark::State& state,
+                                  Triangulator const& triangulator) {
+  std::string geoJSON = generateSyntheticGeoJSON((size_t)state.range(0));
+  std::unique_ptr<Map> map =
+      MapFactory::streamGeoJSON(geoJSON.data(), geoJSON.size());
+  auto const& provinces = map->getProvinces();
+
+  size_t triangles = 0;
+  for (auto _ : state) {
+    triangles = 0;
+    for (ProvinceHandle i = 0; i < provinces.size(); i++)
+      triangles += triangulator.triangulate(provinces.getRings(i)).size();
+  }
+  triangles /= 9;
+
+  state.SetItemsProcessed((int64_t)state.iterations() *
+                          (int64_t)provinces.size());
+  state.counters["triangles"] = (double)triangles;
+}
+
+// Triangulates a synthetic map with the constrained Delaunay triangulation of
+// CGAL
+static void BM_MapTriangulateCGAL(benchmark::State& state) {
+  benchmarkTriangulator(state,
+                        CGALTriangulator(MeshQuality::ConstrainedOnly));
+}
+BENCHMARK(BM_MapTriangulateCGAL)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+// Triangulates a synthetic map by ear clipping
+static void BM_MapTriangulateEarClip(benchmark::State& state) {
+  benchmarkTriangulator(state, EarClipTriangulator());
+}
+BENCHMARK(BM_MapTriangulateEarClip)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace openhoi
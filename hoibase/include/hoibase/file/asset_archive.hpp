@@ -0,0 +1,83 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hoibase/file/asset_archive_format.hpp"
+#include "hoibase/file/filesystem.hpp"
+#include "hoibase/file/mapped_file.hpp"
+#include "hoibase/helper/library.hpp"
+
+namespace openhoi {
+
+// Read access to an asset archive file (see asset_archive_format.hpp). The
+// file is mapped into memory, entries are looked up by a binary search in the
+// index and stored entries can be used in place.
+class OPENHOI_LIB_EXPORT AssetArchive final {
+ public:
+  // Opens the provided archive file. Use isOpen() to check if it is a valid
+  // archive
+  explicit AssetArchive(filesystem::path file);
+
+  // Opens the provided archive file and shares it between all callers as long
+  // as any of them holds it. Once the last holder releases it, the file is
+  // unmapped and the next call opens it again, e.g. after it was rebuilt.
+  // Returns nullptr in case it is no valid archive
+  static std::shared_ptr<AssetArchive> open(filesystem::path file);
+
+  // Checks if the archive was opened and its index is valid
+  bool isOpen() const;
+
+  // Gets the path of the archive file
+  filesystem::path const& getPath() const;
+
+  // Gets the number of entries
+  size_t getEntryCount() const;
+
+  // Gets the entry at the provided index position
+  AssetArchiveEntry const& getEntry(size_t index) const;
+
+  // Gets the name of the provided entry
+  std::string getName(AssetArchiveEntry const& entry) const;
+
+  // Finds the entry with the provided name. Returns nullptr in case there is
+  // no such entry
+  AssetArchiveEntry const* find(std::string const& name) const;
+
+  // Gets the data of the provided entry in place or nullptr in case it is
+  // compressed
+  unsigned char const* getStoredData(AssetArchiveEntry const& entry) const;
+
+  // Reads the uncompressed data of the provided entry into the provided buffer,
+  // which must hold at least entry.size bytes. Returns false in case the data
+  // is corrupt
+  bool read(AssetArchiveEntry const& entry, unsigned char* data) const;
+
+  // Reads the uncompressed data of the entry with the provided name. Returns
+  // false in case there is no such entry or its data is corrupt
+  bool read(std::string const& name, std::vector<unsigned char>& data) const;
+
+  // Lists the names of all entries inside the provided directory, e.g.
+  // "graphics/flags", or of all entries if the directory is empty. Entries in
+  // subdirectories are only listed if recursive is set
+  std::vector<std::string> list(std::string const& directory,
+                                bool recursive) const;
+
+ private:
+  // Gets the first entry whose name is not less than the provided name
+  AssetArchiveEntry const* lowerBound(std::string const& name) const;
+
+  // Checks that the header, index and name pool are within the file
+  bool validate() const;
+
+  filesystem::path path;
+  MappedFile file;
+  AssetArchiveHeader const* header;
+  AssetArchiveEntry const* entries;
+  char const* namePool;
+};
+
+}  // namespace openhoi
@@ -0,0 +1,22 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include "hoibase/file/filesystem.hpp"
+#include "hoibase/helper/library.hpp"
+
+namespace openhoi {
+
+class AssetArchiveBuilder final {
+ public:
+  // Packs all regular files below the provided asset root directory into an
+  // asset archive file (see asset_archive_format.hpp). Every entry is
+  // compressed with zlib at the provided level (1 to 9) if that makes it
+  // smaller, level 0 stores all entries as is. Returns false in case a file
+  // could not be read or the archive could not be written.
+  OPENHOI_LIB_EXPORT static bool build(filesystem::path root,
+                                       filesystem::path file,
+                                       int compressionLevel = 6);
+};
+
+}  // namespace openhoi
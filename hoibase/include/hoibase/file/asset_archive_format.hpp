@@ -0,0 +1,60 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+
+// Magic bytes at the beginning of every asset archive file
+#define OPENHOI_ASSET_ARCHIVE_MAGIC "OHPK"
+
+// Version of the asset archive file layout. Increase it whenever the layout
+// changes
+#define OPENHOI_ASSET_ARCHIVE_VERSION 1
+
+// Name of the asset archive file inside the asset root directory
+#define OPENHOI_ASSET_ARCHIVE_FILE "assets.ohpk"
+
+// Extension of asset archive files
+#define OPENHOI_ASSET_ARCHIVE_EXTENSION ".ohpk"
+
+// Entry flag for data that is compressed with zlib
+#define OPENHOI_ASSET_ARCHIVE_ZLIB 0x1
+
+// An asset archive packs all asset files into one file, so that they can be
+// located and read with a single open. All integers are stored in native byte
+// order:
+//
+//   AssetArchiveHeader
+//   AssetArchiveEntry[entryCount]  index, sorted bytewise by entry name
+//   char[namePoolSize]             entry names (not null terminated)
+//   data of all entries, either stored as is or compressed with zlib
+//
+// Entry names are the paths relative to the asset root directory with '/' as
+// separator, e.g. "graphics/flags/ger.png".
+
+namespace openhoi {
+
+// Header of an asset archive file
+struct AssetArchiveHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t entryCount;
+  uint32_t namePoolSize;
+};
+static_assert(sizeof(AssetArchiveHeader) == 16,
+              "Unexpected asset archive header size");
+
+// Entry of the index of an asset archive file
+struct AssetArchiveEntry {
+  uint32_t nameOffset;
+  uint32_t nameLength;
+  uint32_t flags;
+  uint32_t reserved;
+  uint64_t dataOffset;
+  uint64_t storedSize;
+  uint64_t size;
+};
+static_assert(sizeof(AssetArchiveEntry) == 40,
+              "Unexpected asset archive entry size");
+
+}  // namespace openhoi
@@ -2,7 +2,11 @@
 
 #pragma once
 
+#include <memory>
+
+#include "hoibase/file/asset_archive.hpp"
 #include "hoibase/file/filesystem.hpp"
+#include "hoibase/file/mapped_file.hpp"
 #include "hoibase/helper/library.hpp"
 #include "hoibase/openhoi.hpp"
 
@@ -44,6 +48,11 @@ class OPENHOI_LIB_EXPORT FileAccess final {
   // be thrown.
   static filesystem::path getAssetRootDirectory();
 
+  // Gets the asset archive inside the game asset root directory (see
+  // asset_archive_format.hpp) or nullptr if there is none. The archive is
+  // shared while it is in use.
+  static std::shared_ptr<AssetArchive> getAssetArchive();
+
   // Gets the OGRE plugin directory. In case the plugins should be located
   // relatively to the executables, an empty path is returned.
   static filesystem::path getOgrePluginDirectory();
@@ -62,6 +71,13 @@ class OPENHOI_LIB_EXPORT FileAccess final {
   // returned or -1 in case the file could not be read.
   static long readFile(filesystem::path file, unsigned char** data);
 
+  // Maps the provided file into memory instead of copying it, so that it can
+  // be parsed in place. Returns nullptr in case the file could not be mapped,
+  // e.g. because it does not exist or is empty.
+  static std::unique_ptr<MappedFile> mapFile(
+      filesystem::path file,
+      MappedFileAccess access = MappedFileAccess::Sequential);
+
   // Custom fopen function for Windows compatibility
   static FILE* fopen(char const* fileName, char const* mode);
 
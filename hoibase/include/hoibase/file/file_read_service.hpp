@@ -0,0 +1,108 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "hoibase/file/filesystem.hpp"
+#include "hoibase/file/mapped_file.hpp"
+#include "hoibase/helper/library.hpp"
+
+namespace openhoi {
+
+// Priority of an asynchronous file read. Queued reads with a higher priority
+// are started first, reads with the same priority in the order they were
+// queued
+enum class FileReadPriority { Low = 0, Normal = 1, High = 2 };
+
+// Receives the file of an asynchronous read or nullptr if the file could not be
+// read
+typedef std::function<void(std::unique_ptr<MappedFile>)> FileReadCallback;
+
+// Reads files on a small pool of I/O threads, so that loading assets does not
+// stall the render thread. Files are mapped into memory and all their pages are
+// read in on the I/O thread, so that parsing them afterwards does not block on
+// the disk.
+class OPENHOI_LIB_EXPORT FileReadService final {
+ public:
+  // Starts the provided number of I/O threads
+  explicit FileReadService(unsigned int threadCount = 2);
+
+  // Stops the I/O threads after their current read. Reads that have not been
+  // started yet are dropped: their futures report a broken promise and their
+  // callbacks are never invoked
+  ~FileReadService();
+
+  FileReadService(FileReadService const&) = delete;
+  FileReadService& operator=(FileReadService const&) = delete;
+
+  // Queues the file for reading. The future receives the file or nullptr if it
+  // could not be read
+  std::future<std::unique_ptr<MappedFile>> read(
+      filesystem::path file,
+      FileReadPriority priority = FileReadPriority::Normal);
+
+  // Queues the file for reading. The callback receives the file or nullptr if
+  // it could not be read during the next dispatch after the read finished
+  void read(filesystem::path file, FileReadCallback callback,
+            FileReadPriority priority = FileReadPriority::Normal);
+
+  // Stops the I/O threads from starting further reads until resume is called.
+  // Reads that are running are finished. This allows queueing a batch of reads
+  // that are started in priority order as a whole
+  void pause();
+
+  // Lets the I/O threads start queued reads again after pause was called
+  void resume();
+
+  // Invokes the callbacks of all finished reads on the calling thread, e.g.
+  // once per frame on the render thread. Returns the number of invoked
+  // callbacks
+  size_t dispatch();
+
+  // Gets the number of reads that are queued or running
+  size_t getPendingCount() const;
+
+ private:
+  // Queued read
+  struct Request {
+    filesystem::path file;
+    FileReadPriority priority;
+    uint64_t sequence;
+    std::shared_ptr<std::promise<std::unique_ptr<MappedFile>>> promise;
+    FileReadCallback callback;
+
+    // Orders the requests by priority first and by queue order second
+    bool operator<(Request const& other) const;
+  };
+
+  // Queues the request and wakes up one I/O thread
+  void enqueue(Request request);
+
+  // Runs one I/O thread until the service is stopped
+  void work();
+
+  std::priority_queue<Request> queue;
+  uint64_t nextSequence;
+  bool stopping;
+  bool paused;
+  std::mutex queueMutex;
+  std::condition_variable queueCondition;
+  std::vector<std::pair<FileReadCallback, std::unique_ptr<MappedFile>>>
+      completed;
+  std::mutex completedMutex;
+  std::atomic<size_t> pendingCount;
+  std::vector<std::thread> threads;
+};
+
+}  // namespace openhoi
@@ -0,0 +1,46 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include "hoibase/file/filesystem.hpp"
+#include "hoibase/helper/library.hpp"
+#include "hoibase/openhoi.hpp"
+
+namespace openhoi {
+
+// Watches a single file for modifications. On Linux the parent directory is
+// watched with inotify, so that editors which save by renaming a temporary file
+// over the watched file are noticed as well. On other platforms, or if inotify
+// is not available, the modification time of the file is compared on every
+// poll.
+class OPENHOI_LIB_EXPORT FileWatcher final {
+ public:
+  // Starts watching the provided file. The file does not need to exist yet
+  FileWatcher(filesystem::path file);
+
+  // Stops watching the file
+  ~FileWatcher();
+
+  FileWatcher(FileWatcher const&) = delete;
+  FileWatcher& operator=(FileWatcher const&) = delete;
+
+  // Checks without blocking if the file was written, replaced or created since
+  // the last poll
+  bool poll();
+
+  // Gets the watched file
+  filesystem::path const& getPath() const;
+
+ private:
+  // Gets the modification time of the file or the default time if it does not
+  // exist
+  filesystem::file_time_type getLastWriteTime() const;
+
+  filesystem::path file;
+  filesystem::file_time_type lastWriteTime;
+#ifdef OPENHOI_OS_LINUX
+  int inotifyDescriptor;
+#endif
+};
+
+}  // namespace openhoi
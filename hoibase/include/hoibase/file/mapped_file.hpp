@@ -0,0 +1,66 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+
+#include "hoibase/file/filesystem.hpp"
+#include "hoibase/helper/library.hpp"
+#include "hoibase/openhoi.hpp"
+
+namespace openhoi {
+
+// How a mapped file is going to be read. This is passed to the operating
+// system as a hint, e.g. to read ahead aggressively for sequential reads
+enum class MappedFileAccess {
+  // No particular access pattern
+  Normal,
+
+  // The file is read once from start to end, e.g. when parsing it
+  Sequential,
+
+  // The file is read at random positions, e.g. when it contains lookup tables
+  Random
+};
+
+// Read-only view of a file that is mapped into memory. The mapping is released
+// as soon as the object is destroyed
+class OPENHOI_LIB_EXPORT MappedFile final {
+ public:
+  // Maps the provided file into memory and passes the access pattern to the
+  // operating system. Use isOpen() to check if this worked
+  MappedFile(filesystem::path file,
+             MappedFileAccess access = MappedFileAccess::Normal);
+
+  // Unmaps the file
+  ~MappedFile();
+
+  MappedFile(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+
+  // Checks if the file is mapped
+  bool isOpen() const;
+
+  // Gets the mapped file content
+  unsigned char const* getData() const;
+
+  // Gets the size of the mapped file
+  size_t getSize() const;
+
+  // Passes a changed access pattern for the whole file to the operating system
+  void advise(MappedFileAccess access);
+
+  // Reads all pages of the file into memory, so that accessing the content
+  // later on does not block on the disk
+  void load() const;
+
+ private:
+  unsigned char const* data;
+  size_t size;
+#ifdef OPENHOI_OS_WINDOWS
+  HANDLE fileHandle;
+  HANDLE mappingHandle;
+#endif
+};
+
+}  // namespace openhoi
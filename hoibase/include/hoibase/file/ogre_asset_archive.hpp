@@ -0,0 +1,99 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <OgreArchive.h>
+#include <OgreArchiveFactory.h>
+
+#include <memory>
+#include <string>
+
+#include "hoibase/file/asset_archive.hpp"
+#include "hoibase/helper/library.hpp"
+
+// The OGRE archive type of asset archives
+#define OPENHOI_OGRE_ASSET_ARCHIVE_TYPE "OpenhoiAssetArchive"
+
+namespace openhoi {
+
+// Exposes a directory inside an asset archive as OGRE archive. The location
+// name is the path of the archive file followed by the directory, e.g.
+// "dist/assets.ohpk/graphics/flags". All locations of the same archive file
+// share one opened archive.
+class OgreAssetArchive final : public Ogre::Archive {
+ public:
+  // Creates the archive for the provided location name
+  OgreAssetArchive(Ogre::String const& name, Ogre::String const& type);
+
+  // Entry names are case sensitive
+  bool isCaseSensitive() const override;
+
+  // Opens the asset archive file
+  void load() override;
+
+  // Releases the asset archive file. It is unmapped once no other location
+  // uses it anymore
+  void unload() override;
+
+  // Opens the provided file. Stored entries are used in place and keep the
+  // archive mapped while the stream is in use, compressed entries are
+  // decompressed into memory
+  Ogre::DataStreamPtr open(Ogre::String const& filename,
+                           bool readOnly = true) const override;
+
+  // Lists all files of the directory
+  Ogre::StringVectorPtr list(bool recursive = true,
+                             bool dirs = false) const override;
+
+  // Lists all files of the directory with details
+  Ogre::FileInfoListPtr listFileInfo(bool recursive = true,
+                                     bool dirs = false) const override;
+
+  // Finds all files of the directory that match the provided pattern
+  Ogre::StringVectorPtr find(Ogre::String const& pattern, bool recursive = true,
+                             bool dirs = false) const override;
+
+  // Finds all files of the directory with details that match the provided
+  // pattern
+  Ogre::FileInfoListPtr findFileInfo(Ogre::String const& pattern,
+                                     bool recursive = true,
+                                     bool dirs = false) const override;
+
+  // Checks if the provided file exists
+  bool exists(Ogre::String const& filename) const override;
+
+  // Gets the modification time of the asset archive file, as entries carry no
+  // modification time of their own
+  time_t getModifiedTime(Ogre::String const& filename) const override;
+
+ private:
+  // Collects the details of all files of the directory that match the provided
+  // pattern. An empty pattern matches every file
+  Ogre::FileInfoListPtr collect(Ogre::String const& pattern,
+                                bool recursive) const;
+
+  filesystem::path archiveFile;
+  std::string directory;
+  std::shared_ptr<AssetArchive> archive;
+};
+
+// Creates OGRE archives for asset archive locations. Register it with the OGRE
+// archive manager before adding resource locations of the type
+// OPENHOI_OGRE_ASSET_ARCHIVE_TYPE.
+class OPENHOI_LIB_EXPORT OgreAssetArchiveFactory final
+    : public Ogre::ArchiveFactory {
+ public:
+  using Ogre::ArchiveFactory::createInstance;
+
+  // Gets the OGRE archive type
+  Ogre::String const& getType() const override;
+
+  // Creates the archive for the provided location name
+  Ogre::Archive* createInstance(Ogre::String const& name,
+                                bool readOnly) override;
+
+  // Destroys the provided archive
+  void destroyInstance(Ogre::Archive* archive) override;
+};
+
+}  // namespace openhoi
@@ -0,0 +1,49 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace openhoi {
+
+// Non-owning, read-only view of a contiguous range of elements. The viewed
+// memory has to outlive the view
+template <typename T>
+class ArrayView final {
+ public:
+  // Empty array view constructor
+  ArrayView() : data(nullptr), count(0) {}
+
+  // Array view constructor
+  ArrayView(T const* data, size_t count) : data(data), count(count) {}
+
+  // Array view constructor for a whole vector
+  ArrayView(std::vector<T> const& vector)
+      : data(vector.data()), count(vector.size()) {}
+
+  // Gets the pointer to the first element
+  T const* begin() const { return data; }
+
+  // Gets the pointer behind the last element
+  T const* end() const { return data + count; }
+
+  // Gets the number of elements
+  size_t size() const { return count; }
+
+  // Checks if the view has no elements
+  bool empty() const { return count == 0; }
+
+  // Gets the element at the provided index
+  T const& operator[](size_t index) const {
+    assert(index < count);
+    return data[index];
+  }
+
+ private:
+  T const* data;
+  size_t count;
+};
+
+}  // namespace openhoi
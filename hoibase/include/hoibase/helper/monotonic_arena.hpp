@@ -0,0 +1,72 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "hoibase/helper/library.hpp"
+
+namespace openhoi {
+
+// Monotonic arena that hands out memory from a few large blocks. Memory is
+// never released one allocation at a time but only when the arena is destroyed,
+// and allocated memory never moves, so pointers into the arena stay valid for
+// its whole lifetime.
+class MonotonicArena final {
+ public:
+  // Monotonic arena constructor. Blocks are allocated with the provided size
+  // unless a single allocation needs a larger block
+  OPENHOI_LIB_EXPORT explicit MonotonicArena(size_t blockSize = 4 << 20);
+
+  // The arena owns its blocks, so it can be moved but not copied
+  MonotonicArena(MonotonicArena const&) = delete;
+  MonotonicArena& operator=(MonotonicArena const&) = delete;
+  OPENHOI_LIB_EXPORT MonotonicArena(MonotonicArena&& other) noexcept;
+  OPENHOI_LIB_EXPORT MonotonicArena& operator=(MonotonicArena&& other) noexcept;
+
+  // Allocates uninitialized memory with the provided size and alignment
+  OPENHOI_LIB_EXPORT void* allocate(size_t size, size_t alignment);
+
+  // Allocates uninitialized memory for the provided number of objects. As the
+  // arena never runs destructors, only trivially destructible types are allowed
+  template <typename T>
+  T* allocate(size_t count) {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "Arena objects must be trivially destructible");
+    return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+  }
+
+  // Makes sure that the next allocations with a total of the provided size are
+  // served from a single block
+  OPENHOI_LIB_EXPORT void reserve(size_t size);
+
+  // Gets the number of blocks allocated from the system
+  OPENHOI_LIB_EXPORT size_t getBlockCount() const;
+
+  // Gets the number of bytes handed out by the arena
+  OPENHOI_LIB_EXPORT size_t getAllocatedSize() const;
+
+  // Gets the number of bytes allocated from the system
+  OPENHOI_LIB_EXPORT size_t getCapacity() const;
+
+ private:
+  // Memory block allocated from the system
+  struct Block {
+    std::unique_ptr<unsigned char[]> data;
+    size_t size;
+  };
+
+  // Appends a new block that is at least of the provided size
+  void addBlock(size_t size);
+
+  size_t blockSize;
+  std::vector<Block> blocks;
+  size_t used;
+  size_t allocated;
+  size_t capacity;
+};
+
+}  // namespace openhoi
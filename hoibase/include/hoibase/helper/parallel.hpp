@@ -0,0 +1,26 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include "hoibase/helper/library.hpp"
+
+namespace openhoi {
+
+class OPENHOI_LIB_EXPORT Parallel final {
+ public:
+  // Invokes the provided task for every index in [0, count) using a pool of
+  // worker threads. The calling thread takes part in the work and this function
+  // returns as soon as all indices were processed. If a thread count of 0 is
+  // provided, the number of hardware threads is used. The first exception
+  // thrown by a task is rethrown on the calling thread.
+  static void forEach(size_t count, std::function<void(size_t)> const& task,
+                      unsigned int threadCount = 0);
+
+  // Gets the number of worker threads used by default
+  static unsigned int getDefaultThreadCount();
+};
+
+}  // namespace openhoi
@@ -0,0 +1,47 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "hoibase/helper/array_view.hpp"
+#include "hoibase/helper/library.hpp"
+#include "hoibase/map/province_store.hpp"
+
+namespace openhoi {
+
+// Neighbourhood of all provinces of a province store in compressed sparse row
+// form. The neighbours of province h are [offsets[h], offsets[h + 1]) inside of
+// the neighbour array, sorted by handle. Two provinces are neighbours if they
+// share at least one border edge, i.e. two consecutive ring points with exactly
+// the same coordinates. Provinces that only touch in a single point are not
+// neighbours. The graph is immutable once built and may be queried from
+// multiple threads.
+class AdjacencyGraph final {
+ public:
+  // Builds the adjacency graph of all provinces of the provided store from
+  // their shared border edges. The build time is linear in the number of
+  // points
+  OPENHOI_LIB_EXPORT AdjacencyGraph(ProvinceStore const& provinces);
+
+  // Gets the number of provinces
+  OPENHOI_LIB_EXPORT size_t size() const;
+
+  // Gets the number of pairs of neighbouring provinces
+  OPENHOI_LIB_EXPORT size_t getEdgeCount() const;
+
+  // Gets the neighbours of the province, sorted by handle
+  OPENHOI_LIB_EXPORT ArrayView<ProvinceHandle> getNeighbours(
+      ProvinceHandle province) const;
+
+  // Checks if the provinces share a border
+  OPENHOI_LIB_EXPORT bool areNeighbours(ProvinceHandle first,
+                                        ProvinceHandle second) const;
+
+ private:
+  std::vector<uint32_t> offsets;
+  std::vector<ProvinceHandle> neighbours;
+};
+
+}  // namespace openhoi
@@ -0,0 +1,35 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "hoibase/helper/array_view.hpp"
+#include "hoibase/helper/library.hpp"
+#include "hoibase/map/province_store.hpp"
+
+namespace openhoi {
+
+// Knows for every ring edge of a province store which province lies on the
+// other side of it. Edge i of a ring goes from point i to point i + 1, where
+// the last edge closes the ring. Two provinces share an edge if both of their
+// rings contain two consecutive points with exactly the same coordinates.
+// Edges without another province, e.g. coastlines, have InvalidProvinceHandle
+// on the other side.
+class BorderIndex final {
+ public:
+  // Builds the border index of all provinces of the provided store by hashing
+  // their ring edges. The build time is linear in the number of points
+  OPENHOI_LIB_EXPORT BorderIndex(ProvinceStore const& provinces);
+
+  // Gets the provinces on the other side of the edges of a ring, where the
+  // ring index refers to ProvinceStore::getRings()
+  OPENHOI_LIB_EXPORT ArrayView<ProvinceHandle> getOpposites(size_t ring) const;
+
+ private:
+  std::vector<uint32_t> offsets;
+  std::vector<ProvinceHandle> opposites;
+};
+
+}  // namespace openhoi
@@ -0,0 +1,33 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include "hoibase/map/triangulator.hpp"
+
+namespace openhoi {
+
+// Triangulator based on the constrained Delaunay triangulation of CGAL. It
+// handles any input including self-intersecting rings and supports all mesh
+// quality presets. Rings inside of an odd number of other rings are holes,
+// like for the ear clipping triangulator.
+class OPENHOI_LIB_EXPORT CGALTriangulator final : public Triangulator {
+ public:
+  // CGAL triangulator constructor
+  explicit CGALTriangulator(MeshQuality quality = DefaultMeshQuality);
+
+  // Gets the name of the triangulator, which is the name of its mesh quality
+  std::string getName() const override;
+
+  // Gets the mesh quality of the triangulations
+  MeshQuality getMeshQuality() const override;
+
+  // Triangulates the provided province rings and returns the vertices of the
+  // triangles as x, y, z triples in map coordinates
+  std::vector<Ogre::Real> triangulate(
+      ArrayView<ArrayView<Ogre::Vector2>> rings) const override;
+
+ private:
+  MeshQuality quality;
+};
+
+}  // namespace openhoi
@@ -0,0 +1,52 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+
+// Magic bytes at the beginning of every compiled map file
+#define OPENHOI_COMPILED_MAP_MAGIC "OHMP"
+
+// Version of the compiled map file layout. Increase it whenever the layout
+// changes. Since version 2 the province centers are filled in
+#define OPENHOI_COMPILED_MAP_VERSION 2
+
+// A compiled map file is a flat, versioned binary representation of a map that
+// can be used in place after mapping it into memory. All integers and floats
+// are stored in native byte order and every table is 4 byte aligned:
+//
+//   CompiledMapHeader
+//   CompiledMapProvince[provinceCount]  province table
+//   uint32_t[ringCount + 1]             index of each ring's first coordinate
+//   float[coordinateCount * 2]          x/y pairs of all rings
+//   char[stringPoolSize]                province IDs (not null terminated)
+
+namespace openhoi {
+
+// Header of a compiled map file
+struct CompiledMapHeader {
+  char magic[4];
+  uint32_t version;
+  int32_t radius;
+  uint32_t provinceCount;
+  uint32_t ringCount;
+  uint32_t coordinateCount;
+  uint32_t stringPoolSize;
+  uint32_t reserved;
+};
+static_assert(sizeof(CompiledMapHeader) == 32,
+              "Unexpected compiled map header size");
+
+// Entry of the province table of a compiled map file
+struct CompiledMapProvince {
+  uint32_t idOffset;
+  uint32_t idLength;
+  uint32_t firstRing;
+  uint32_t ringCount;
+  float centerX;
+  float centerY;
+};
+static_assert(sizeof(CompiledMapProvince) == 24,
+              "Unexpected compiled map province size");
+
+}  // namespace openhoi
@@ -0,0 +1,45 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include "hoibase/map/cgal_triangulator.hpp"
+
+namespace openhoi {
+
+// Lightweight triangulator that clips ears off simple rings. Rings inside of an
+// odd number of other rings are holes, which are bridged into their enclosing
+// ring before clipping. No vertices are added, so the result is comparable to
+// the constrained-only mesh quality. Provinces with rings that intersect
+// themselves or each other, or any other input the ear clipping can not handle
+// are triangulated by CGAL instead.
+class OPENHOI_LIB_EXPORT EarClipTriangulator final : public Triangulator {
+ public:
+  // Ear clipping triangulator constructor. The provided mesh quality is used
+  // by the CGAL fallback
+  explicit EarClipTriangulator(
+      MeshQuality fallbackQuality = MeshQuality::ConstrainedOnly);
+
+  // Gets the name of the triangulator
+  std::string getName() const override;
+
+  // Gets the mesh quality of the triangulations, which is the one of the
+  // fallback
+  MeshQuality getMeshQuality() const override;
+
+  // Triangulates the provided province rings and returns the vertices of the
+  // triangles as x, y, z triples in map coordinates
+  std::vector<Ogre::Real> triangulate(
+      ArrayView<ArrayView<Ogre::Vector2>> rings) const override;
+
+  // Triangulates the provided province rings by ear clipping only and appends
+  // the triangles to the vertices. Returns false and leaves the vertices
+  // untouched in case a ring intersects itself or another ring or can not be
+  // clipped
+  static bool clip(ArrayView<ArrayView<Ogre::Vector2>> rings,
+                   std::vector<Ogre::Real>& vertices);
+
+ private:
+  CGALTriangulator fallback;
+};
+
+}  // namespace openhoi
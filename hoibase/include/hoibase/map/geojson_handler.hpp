@@ -0,0 +1,117 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include "hoibase/helper/library.hpp"
+#include "hoibase/map/province.hpp"
+
+#define RAPIDJSON_HAS_STDSTRING 1
+#include <rapidjson/reader.h>
+
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace openhoi {
+
+// rapidjson SAX handler that reads a GeoJSON feature collection and hands
+// every province to a callback as soon as its feature has been read. Only the
+// current feature is buffered, so the document tree is never built
+class GeoJSONHandler final {
+ public:
+  // GeoJSON handler constructor
+  OPENHOI_LIB_EXPORT GeoJSONHandler(
+      std::function<void(Province)> const& callback);
+
+  // Checks if the whole feature collection has been read successfully. If not,
+  // the error message is set
+  OPENHOI_LIB_EXPORT bool finish();
+
+  // Gets the error message of the last failed check
+  OPENHOI_LIB_EXPORT char const* getError() const;
+
+  // rapidjson reader handler callbacks
+  bool Null();
+  bool Bool(bool value);
+  bool Int(int value);
+  bool Uint(unsigned value);
+  bool Int64(int64_t value);
+  bool Uint64(uint64_t value);
+  bool Double(double value);
+  bool RawNumber(char const* value, rapidjson::SizeType length, bool copy);
+  bool String(char const* value, rapidjson::SizeType length, bool copy);
+  bool StartObject();
+  bool Key(char const* value, rapidjson::SizeType length, bool copy);
+  bool EndObject(rapidjson::SizeType memberCount);
+  bool StartArray();
+  bool EndArray(rapidjson::SizeType elementCount);
+
+ private:
+  // Kind of the object or array the reader is currently in
+  enum class Scope {
+    Root,
+    Features,
+    Feature,
+    Properties,
+    Geometry,
+    Coordinates,
+    Other
+  };
+
+  // Object or array the reader is currently in
+  struct Frame {
+    Scope scope;
+    bool array;
+
+    // Coordinates only: nesting level below the geometry (1 is the
+    // coordinates array itself), number of elements and the first two
+    // elements if they are floating point numbers
+    unsigned int level;
+    size_t elements;
+    bool firstIsDouble;
+    bool secondIsDouble;
+    Ogre::Vector2 point;
+
+    // Coordinates only: the points of this ring and whether its last element
+    // was a point, as the last element of a ring is always dropped
+    std::vector<Ogre::Vector2> ring;
+    bool lastIsPoint;
+  };
+
+  // Province data of the feature that is currently read
+  struct Feature {
+    std::string type;
+    bool hasProperties;
+    std::string name;
+    std::string propertiesType;
+    bool hasGeometry;
+    std::string geometryType;
+    bool hasCoordinates;
+    std::vector<Ogre::Vector2> lineString;
+    std::vector<std::vector<Ogre::Vector2>> multiPolygon;
+  };
+
+  // Pushes a new object or array onto the frame stack
+  void push(bool array);
+
+  // Handles a scalar value at the current position
+  bool value(std::string const* string, bool isDouble, double number);
+
+  // Handles the end of an array inside of the coordinates
+  void endCoordinates(Frame& frame);
+
+  // Builds the province out of the feature that has just been read
+  void endFeature();
+
+  std::function<void(Province)> callback;
+  std::vector<Frame> frames;
+  std::string key;
+  std::string rootType;
+  bool hasFeatures;
+  Feature feature;
+  std::unordered_set<std::string> importedIds;
+  char const* error;
+};
+
+}  // namespace openhoi
@@ -0,0 +1,69 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <Ogre.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "hoibase/helper/array_view.hpp"
+#include "hoibase/helper/library.hpp"
+
+namespace openhoi {
+
+// Triangle mesh with unique 2D vertices and an index array with three indices
+// per triangle. The indices are 16 bit wide as long as the mesh has at most
+// 65536 vertices, otherwise they are 32 bit wide.
+class IndexedMesh final {
+ public:
+  // Empty indexed mesh constructor
+  OPENHOI_LIB_EXPORT IndexedMesh();
+
+  // Indexed mesh constructor for 16 bit wide indices. The mesh must have at
+  // most 65536 vertices
+  OPENHOI_LIB_EXPORT IndexedMesh(std::vector<Ogre::Vector2> vertices,
+                                 std::vector<uint16_t> indices);
+
+  // Indexed mesh constructor for 32 bit wide indices. They are narrowed to 16
+  // bit if the mesh has at most 65536 vertices
+  OPENHOI_LIB_EXPORT IndexedMesh(std::vector<Ogre::Vector2> vertices,
+                                 std::vector<uint32_t> indices);
+
+  // Builds an indexed mesh out of a triangle list with x, y, z triples per
+  // vertex, as returned by the province triangulation. Vertices with the same
+  // x and y coordinates are merged, z is dropped
+  OPENHOI_LIB_EXPORT static IndexedMesh fromTriangles(
+      ArrayView<Ogre::Real> triangles);
+
+  // Gets the unique vertices
+  OPENHOI_LIB_EXPORT std::vector<Ogre::Vector2> const& getVertices() const;
+
+  // Gets the number of indices
+  OPENHOI_LIB_EXPORT size_t getIndexCount() const;
+
+  // Gets the index at the provided position
+  OPENHOI_LIB_EXPORT uint32_t getIndex(size_t position) const;
+
+  // Checks if the indices are 32 bit wide
+  OPENHOI_LIB_EXPORT bool hasWideIndices() const;
+
+  // Gets the indices if they are 16 bit wide
+  OPENHOI_LIB_EXPORT std::vector<uint16_t> const& getIndices16() const;
+
+  // Gets the indices if they are 32 bit wide
+  OPENHOI_LIB_EXPORT std::vector<uint32_t> const& getIndices32() const;
+
+  // Gets the number of bytes of the vertices and indices
+  OPENHOI_LIB_EXPORT size_t getMemorySize() const;
+
+  // Expands the mesh back into a triangle list with x, y, z triples per vertex
+  OPENHOI_LIB_EXPORT std::vector<Ogre::Real> toTriangles() const;
+
+ private:
+  std::vector<Ogre::Vector2> vertices;
+  std::vector<uint16_t> indices16;
+  std::vector<uint32_t> indices32;
+};
+
+}  // namespace openhoi
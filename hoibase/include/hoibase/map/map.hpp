@@ -2,10 +2,16 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <vector>
 
+#include "adjacency_graph.hpp"
 #include "hoibase/helper/library.hpp"
+#include "map_lod.hpp"
 #include "province.hpp"
+#include "province_store.hpp"
+#include "spatial_index.hpp"
 
 namespace openhoi {
 
@@ -15,19 +21,61 @@ class Map final {
   // Map constructor
   OPENHOI_LIB_EXPORT Map(int radius);
 
-  // Add province to map
-  OPENHOI_LIB_EXPORT void addProvince(Province province);
+  // Add province to map and returns its handle
+  OPENHOI_LIB_EXPORT ProvinceHandle addProvince(Province province);
 
   // Gets the map's provinces
-  OPENHOI_LIB_EXPORT std::unordered_map<std::string, Province> const&
-  getProvinces() const;
+  OPENHOI_LIB_EXPORT ProvinceStore const& getProvinces() const;
+
+  // Gets the map's provinces for modification. Whoever adds provinces or
+  // changes their rings through it has to call invalidateIndices() afterwards
+  OPENHOI_LIB_EXPORT ProvinceStore& getProvinces();
+
+  // Drops the spatial index, the adjacency graph and the levels of detail, so
+  // they are rebuilt on next access. References to them that were handed out
+  // before become invalid
+  OPENHOI_LIB_EXPORT void invalidateIndices();
+
+  // Gets the handle of the province with the provided ID or
+  // InvalidProvinceHandle if it does not exist
+  OPENHOI_LIB_EXPORT ProvinceHandle getProvinceHandle(
+      std::string const& id) const;
+
+  // Gets the spatial index over all provinces. The index is built on first
+  // access and rebuilt after provinces were added
+  OPENHOI_LIB_EXPORT SpatialIndex const& getSpatialIndex() const;
+
+  // Gets the province under the provided point or InvalidProvinceHandle if
+  // there is none
+  OPENHOI_LIB_EXPORT ProvinceHandle getProvinceAt(
+      Ogre::Vector2 const& point) const;
+
+  // Gets all provinces whose bounding box intersects the provided rectangle
+  OPENHOI_LIB_EXPORT std::vector<ProvinceHandle> getProvincesIn(
+      Ogre::Vector2 const& min, Ogre::Vector2 const& max) const;
+
+  // Gets the adjacency graph of all provinces. The graph is built on first
+  // access and rebuilt after provinces were added
+  OPENHOI_LIB_EXPORT AdjacencyGraph const& getAdjacencyGraph() const;
+
+  // Gets the provinces that share a border with the province
+  OPENHOI_LIB_EXPORT ArrayView<ProvinceHandle> getNeighbours(
+      ProvinceHandle province) const;
+
+  // Gets the simplified province outlines for all levels of detail. They are
+  // built on first access and rebuilt after provinces were added
+  OPENHOI_LIB_EXPORT MapLOD const& getLOD() const;
 
   // Gets the map's radius
   OPENHOI_LIB_EXPORT int const& getRadius() const;
 
  private:
   int radius;
-  std::unordered_map<std::string, Province> provinces;
+  ProvinceStore provinces;
+  mutable std::unique_ptr<SpatialIndex> spatialIndex;
+  mutable std::unique_ptr<AdjacencyGraph> adjacencyGraph;
+  mutable std::unique_ptr<MapLOD> lod;
+  mutable std::mutex indexMutex;
 };
 
-}  // namespace openhoi
\ No newline at end of file
+}  // namespace openhoi
@@ -0,0 +1,19 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include "hoibase/file/filesystem.hpp"
+#include "hoibase/helper/library.hpp"
+#include "hoibase/map/map.hpp"
+
+namespace openhoi {
+
+class MapCompiler final {
+ public:
+  // Writes the provided map as compiled map file (see compiled_map_format.hpp)
+  // that can be loaded with MapFactory::loadMap. Returns false in case the
+  // file could not be written.
+  OPENHOI_LIB_EXPORT static bool compile(Map const& map, filesystem::path file);
+};
+
+}  // namespace openhoi
@@ -5,18 +5,63 @@
 #include "hoibase/file/file_access.hpp"
 #include "hoibase/helper/library.hpp"
 #include "hoibase/map/map.hpp"
+#include "hoibase/map/mesh_quality.hpp"
+#include "hoibase/map/province.hpp"
+#include "hoibase/map/triangulator.hpp"
 
 #define RAPIDJSON_HAS_STDSTRING 1
 #include <rapidjson/document.h>
 
+#include <functional>
 #include <memory>
 
 namespace openhoi {
 
 class MapFactory {
  public:
-  // Loads the map file and returns the map data
-  OPENHOI_LIB_EXPORT static std::unique_ptr<Map> loadMap(std::string path);
+  // Loads the map file and returns the map data. The map file can either be a
+  // GeoJSON file or a compiled map file. The provinces are triangulated with
+  // the provided mesh quality
+  OPENHOI_LIB_EXPORT static std::unique_ptr<Map> loadMap(
+      std::string path, MeshQuality meshQuality = DefaultMeshQuality);
+
+  // Loads the map file and returns the map data. The map file can either be a
+  // GeoJSON file or a compiled map file. The provinces are triangulated with
+  // the provided triangulator
+  OPENHOI_LIB_EXPORT static std::unique_ptr<Map> loadMap(
+      std::string path, std::shared_ptr<Triangulator const> triangulator);
+
+  // Parses the provided map data, which can either be GeoJSON or a compiled
+  // map, and returns the map data. The provinces are not triangulated
+  OPENHOI_LIB_EXPORT static std::unique_ptr<Map> parseMap(
+      unsigned char const* data, size_t size);
+
+  // Parses the provided GeoJSON data into a document tree and returns the map
+  // data. The provinces are not triangulated
+  OPENHOI_LIB_EXPORT static std::unique_ptr<Map> parseGeoJSON(char const* data,
+                                                              size_t size);
+
+  // Reads the provided GeoJSON data feature by feature without building a
+  // document tree and returns the map data. The provinces are not triangulated
+  OPENHOI_LIB_EXPORT static std::unique_ptr<Map> streamGeoJSON(
+      char const* data, size_t size);
+
+  // Reads the provided GeoJSON data feature by feature without building a
+  // document tree and hands every province to the callback as soon as its
+  // feature has been read
+  OPENHOI_LIB_EXPORT static void streamGeoJSON(
+      char const* data, size_t size,
+      std::function<void(Province)> const& callback);
+
+  // Parses the provided compiled map data and returns the map data. The data
+  // is read in place, so it has to stay valid until this function returns. The
+  // provinces are not triangulated
+  OPENHOI_LIB_EXPORT static std::unique_ptr<Map> parseCompiledMap(
+      unsigned char const* data, size_t size);
+
+  // Checks if the provided data is a compiled map
+  OPENHOI_LIB_EXPORT static bool isCompiledMap(unsigned char const* data,
+                                               size_t size);
 
  private:
   // Get coordinates out of object
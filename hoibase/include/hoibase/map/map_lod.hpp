@@ -0,0 +1,77 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <Ogre.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "hoibase/helper/array_view.hpp"
+#include "hoibase/helper/library.hpp"
+#include "hoibase/map/province_store.hpp"
+
+namespace openhoi {
+
+// Simplified province outlines for multiple levels of detail. Level 0 are the
+// original rings of the province store, every further level is simplified with
+// the Douglas-Peucker algorithm and a growing tolerance.
+//
+// The rings are split into chains at every point where the province on the
+// other side of the border changes. Both provinces along a border simplify the
+// same chain in the same direction, so shared borders stay identical on every
+// level and no cracks appear between provinces. Every chain keeps its end
+// points and its most distant point, so rings never collapse.
+class MapLOD final {
+ public:
+  // Builds the levels of detail of all provinces of the provided store with
+  // the provided tolerances in map units, sorted from fine to coarse. The
+  // store must outlive the levels of detail
+  OPENHOI_LIB_EXPORT MapLOD(ProvinceStore const& provinces,
+                            std::vector<Ogre::Real> tolerances);
+
+  // Gets the default tolerances for a map with the provided extent, i.e. the
+  // length of the diagonal of its bounding box
+  OPENHOI_LIB_EXPORT static std::vector<Ogre::Real> getDefaultTolerances(
+      Ogre::Real extent);
+
+  // Gets the number of levels, including the original rings at level 0
+  OPENHOI_LIB_EXPORT size_t getLevelCount() const;
+
+  // Gets the maximum distance between the simplified and the original outline
+  // of the level
+  OPENHOI_LIB_EXPORT Ogre::Real getTolerance(size_t level) const;
+
+  // Gets the number of points of all provinces on the level
+  OPENHOI_LIB_EXPORT size_t getPointCount(size_t level) const;
+
+  // Gets the rings of the province on the level. Rings that are too small to
+  // be visible on the level are left out
+  OPENHOI_LIB_EXPORT ArrayView<ArrayView<Ogre::Vector2>> getRings(
+      size_t level, ProvinceHandle province) const;
+
+  // Gets the coarsest level whose tolerance is below the provided size of one
+  // screen pixel in map units
+  OPENHOI_LIB_EXPORT size_t selectLevel(Ogre::Real pixelSize) const;
+
+  // Gets the coarsest level that is precise enough for a camera at the
+  // provided distance to the map, with the provided vertical field of view in
+  // radians and viewport height in pixels
+  OPENHOI_LIB_EXPORT size_t selectLevel(Ogre::Real cameraDistance,
+                                        Ogre::Real fieldOfViewY,
+                                        Ogre::Real viewportHeight) const;
+
+ private:
+  // Simplified rings of all provinces on one level
+  struct Level {
+    Ogre::Real tolerance;
+    std::vector<Ogre::Vector2> points;
+    std::vector<ArrayView<Ogre::Vector2>> rings;
+    std::vector<uint32_t> ringOffsets;
+  };
+
+  ProvinceStore const& provinces;
+  std::vector<Level> levels;
+};
+
+}  // namespace openhoi
@@ -0,0 +1,125 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <Ogre.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "hoibase/helper/library.hpp"
+#include "hoibase/map/province_store.hpp"
+#include "hoibase/map/spatial_index.hpp"
+
+namespace openhoi {
+
+// Name of the material that draws the map mesh. It looks up the color of every
+// province in the province color table bound to its first texture unit
+#define OPENHOI_MAP_MESH_MATERIAL "map_province"
+
+// Vertex of the map mesh. The province handle is stored as float, so that it
+// can be passed to the shaders as texture coordinate
+struct MapMeshVertex {
+  float x;
+  float y;
+  float province;
+};
+
+// All triangulated provinces of a map packed into one vertex buffer and one
+// index buffer, so that the whole map is drawn in a single draw call. Every
+// vertex carries the handle of its province, so that the province colors can
+// be changed through a color lookup texture without touching the mesh.
+// Single provinces can be updated later on, e.g. when the map file was edited,
+// and only the changed parts of the buffers are uploaded again.
+class MapMesh final {
+ public:
+  // Builds the map mesh out of the triangulations of all provinces of the
+  // provided store
+  OPENHOI_LIB_EXPORT MapMesh(ProvinceStore const& provinces);
+
+  // Gets the vertices of all provinces
+  OPENHOI_LIB_EXPORT std::vector<MapMeshVertex> const& getVertices() const;
+
+  // Gets the triangle indices of all provinces
+  OPENHOI_LIB_EXPORT std::vector<uint32_t> const& getIndices() const;
+
+  // Gets the first index of the triangles of the province
+  OPENHOI_LIB_EXPORT size_t getIndexStart(ProvinceHandle province) const;
+
+  // Gets the number of indices of the triangles of the province
+  OPENHOI_LIB_EXPORT size_t getIndexCount(ProvinceHandle province) const;
+
+  // Gets the bounding box of all vertices that were ever written
+  OPENHOI_LIB_EXPORT BoundingBox const& getBounds() const;
+
+  // Replaces the triangles of the provided provinces with their current
+  // triangulation in the store. Provinces that were added to the store are
+  // appended. A province keeps its place in the buffers if its new triangles
+  // fit, otherwise it is moved to the end and its old triangles are collapsed.
+  // The space of moved provinces is only reclaimed by rebuilding the mesh
+  OPENHOI_LIB_EXPORT void updateProvinces(
+      ProvinceStore const& provinces,
+      std::vector<ProvinceHandle> const& changedProvinces);
+
+  // Checks if vertices or indices changed since the last upload
+  OPENHOI_LIB_EXPORT bool hasChanges() const;
+
+  // Creates an Ogre mesh with one sub mesh that uses the map material and
+  // uploads the vertices and indices into hardware buffers with room to grow
+  OPENHOI_LIB_EXPORT Ogre::MeshPtr createOgreMesh(
+      std::string const& name,
+      std::string const& resourceGroupName = Ogre::RGN_DEFAULT) const;
+
+  // Writes the vertices and indices that changed since the last upload into
+  // the hardware buffers of the provided mesh, which was created by
+  // createOgreMesh. Provinces that were moved to the end are appended in place
+  // as long as the buffers have room left, they are only recreated if they are
+  // too small
+  OPENHOI_LIB_EXPORT void uploadChanges(Ogre::MeshPtr const& mesh);
+
+ private:
+  // Location of the vertices and indices of one province in the buffers
+  struct ProvinceRange {
+    uint32_t vertexStart;
+    uint32_t vertexCapacity;
+    uint32_t indexStart;
+    uint32_t indexCount;
+    uint32_t indexCapacity;
+  };
+
+  // Range [first, second) of vertices or indices that changed since the last
+  // upload
+  typedef std::pair<size_t, size_t> DirtyRange;
+
+  // Writes the indexed mesh of the province into the buffers, in place of its
+  // previous triangles if they fit or at the end otherwise
+  void writeProvince(ProvinceHandle province, IndexedMesh const& mesh);
+
+  // Sets the bounds of the Ogre mesh to the bounds of the map mesh
+  void setOgreBounds(Ogre::MeshPtr const& mesh) const;
+
+  // Creates the sub mesh that draws the map mesh with the map material
+  void createSubMesh(Ogre::MeshPtr const& mesh,
+                     std::string const& resourceGroupName) const;
+
+  // Creates the hardware buffers of the sub mesh and uploads all vertices and
+  // indices. The buffers are larger than needed, so that provinces which are
+  // moved to the end later on can be appended without recreating them. As they
+  // are partially updated, they are dynamic instead of static
+  void createBuffers(Ogre::SubMesh* subMesh) const;
+
+  // Gets the number of vertices or indices the hardware buffers are allocated
+  // with if the provided number of them is used
+  static size_t getBufferCapacity(size_t size);
+
+  std::vector<MapMeshVertex> vertices;
+  std::vector<uint32_t> indices;
+  std::vector<ProvinceRange> ranges;
+  std::vector<DirtyRange> dirtyVertices;
+  std::vector<DirtyRange> dirtyIndices;
+  BoundingBox bounds;
+};
+
+}  // namespace openhoi
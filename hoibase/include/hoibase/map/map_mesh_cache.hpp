@@ -0,0 +1,37 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <string>
+
+#include "hoibase/file/filesystem.hpp"
+#include "hoibase/helper/library.hpp"
+#include "hoibase/map/map.hpp"
+
+namespace openhoi {
+
+// On-disk cache of triangulated province meshes and province centers. The
+// cache is stored inside the user's game config directory and keyed by the
+// content hash of the map file, so that a changed map file never picks up
+// stale meshes.
+class MapMeshCache final {
+ public:
+  // Computes the cache key out of the raw map file content
+  OPENHOI_LIB_EXPORT static std::string computeKey(unsigned char const* data,
+                                                   size_t size);
+
+  // Restores the province triangulations and centers of the provided map from
+  // the cache. Returns false and leaves the provinces untouched in case there
+  // is no usable cache entry for every province.
+  OPENHOI_LIB_EXPORT static bool load(std::string const& key, Map& map);
+
+  // Stores the province triangulations and centers of the provided map in the
+  // cache. Returns false in case the cache file could not be written.
+  OPENHOI_LIB_EXPORT static bool save(std::string const& key, Map const& map);
+
+ private:
+  // Gets the path of the cache file for the provided key
+  static filesystem::path getCacheFile(std::string const& key);
+};
+
+}  // namespace openhoi
@@ -0,0 +1,67 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "hoibase/file/file_watcher.hpp"
+#include "hoibase/helper/library.hpp"
+#include "hoibase/map/map.hpp"
+#include "hoibase/map/province_store.hpp"
+
+namespace openhoi {
+
+// Differences between two versions of the provinces of a map, by province ID
+struct MapDiff {
+  // IDs of the provinces that only exist in the new version
+  std::vector<std::string> added;
+
+  // IDs of the provinces whose rings changed
+  std::vector<std::string> changed;
+
+  // IDs of the provinces that only exist in the old version
+  std::vector<std::string> removed;
+};
+
+// Keeps a loaded map in sync with its map file, e.g. while the map is edited
+// with the game running. Only provinces whose geometry changed get a new
+// center and are re-triangulated, so that the map mesh only has to update
+// those provinces.
+// Removed provinces keep their handle, but lose all their rings.
+class MapReloader final {
+ public:
+  // Starts watching the map file the provided map was loaded from. The map has
+  // to outlive the reloader
+  OPENHOI_LIB_EXPORT MapReloader(std::string path, Map& map);
+
+  // Checks without blocking if the map file changed and applies the changes to
+  // the map. Returns the handles of all added, changed and removed provinces,
+  // which are already re-triangulated. If the map file could not be parsed,
+  // the map is left untouched
+  OPENHOI_LIB_EXPORT std::vector<ProvinceHandle> poll();
+
+  // Reads the map file and applies the changes to the map. Returns the handles
+  // of all added, changed and removed provinces, which are already
+  // re-triangulated
+  OPENHOI_LIB_EXPORT std::vector<ProvinceHandle> reload();
+
+  // Compares two versions of the provinces of a map by province ID
+  OPENHOI_LIB_EXPORT static MapDiff diff(ProvinceStore const& current,
+                                         ProvinceStore const& updated);
+
+  // Applies the differences to the map and recomputes the centers and
+  // triangulations of the affected provinces in parallel. Returns the handles
+  // of all added, changed and removed provinces. If a thread count of 0 is
+  // provided, the number of hardware threads is used.
+  OPENHOI_LIB_EXPORT static std::vector<ProvinceHandle> apply(
+      Map& map, ProvinceStore const& updated, MapDiff const& diff,
+      unsigned int threadCount = 0);
+
+ private:
+  std::string path;
+  Map& map;
+  FileWatcher watcher;
+};
+
+}  // namespace openhoi
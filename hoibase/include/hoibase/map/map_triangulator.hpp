@@ -0,0 +1,88 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "hoibase/helper/library.hpp"
+#include "hoibase/map/map.hpp"
+
+namespace openhoi {
+
+// Triangulation details of one single province inside a map triangulation
+struct ProvinceTriangulation {
+  // The province handle
+  ProvinceHandle handle;
+
+  // The province ID
+  std::string id;
+
+  // Offset of the province's first vertex component inside the map vertices
+  size_t offset;
+
+  // Number of vertex components (x, y, z triples) of the province
+  size_t size;
+
+  // Time it took to triangulate the province
+  std::chrono::microseconds duration;
+};
+
+// Represents the triangulated vertices of all provinces of a map
+class MapTriangulation final {
+ public:
+  // Map triangulation constructor
+  OPENHOI_LIB_EXPORT MapTriangulation(
+      std::vector<Ogre::Real> vertices,
+      std::vector<ProvinceTriangulation> provinces,
+      std::chrono::microseconds duration, unsigned int threadCount);
+
+  // Gets the vertices of all provinces in one buffer
+  OPENHOI_LIB_EXPORT std::vector<Ogre::Real> const& getVertices() const;
+
+  // Gets the per-province offsets and timings
+  OPENHOI_LIB_EXPORT std::vector<ProvinceTriangulation> const& getProvinces()
+      const;
+
+  // Gets the wall clock time the whole triangulation took
+  OPENHOI_LIB_EXPORT std::chrono::microseconds const& getDuration() const;
+
+  // Gets the number of threads used for the triangulation
+  OPENHOI_LIB_EXPORT unsigned int const& getThreadCount() const;
+
+ private:
+  std::vector<Ogre::Real> vertices;
+  std::vector<ProvinceTriangulation> provinces;
+  std::chrono::microseconds duration;
+  unsigned int threadCount;
+};
+
+class MapTriangulator final {
+ public:
+  // Triangulates all provinces of the provided map in parallel so that every
+  // province keeps its triangulation, without gathering the vertices. If a
+  // thread count of 0 is provided, the number of hardware threads is used.
+  OPENHOI_LIB_EXPORT static void triangulateProvinces(
+      Map const& map, unsigned int threadCount = 0);
+
+  // Triangulates all provinces of the provided map in parallel and gathers
+  // their vertices into one map triangulation. If a thread count of 0 is
+  // provided, the number of hardware threads is used.
+  OPENHOI_LIB_EXPORT static MapTriangulation triangulate(
+      Map const& map, unsigned int threadCount = 0);
+
+ private:
+  // Triangulates all provinces of the provided store on the worker pool and
+  // returns the time each province took
+  static std::vector<std::chrono::microseconds> triangulateProvinces(
+      ProvinceStore const& provinces, unsigned int threadCount);
+
+  // Gets the number of threads to triangulate the provided provinces with. A
+  // thread count of 0 means the number of hardware threads, and there are
+  // never more threads than provinces
+  static unsigned int getThreadCount(ProvinceStore const& provinces,
+                                     unsigned int threadCount);
+};
+
+}  // namespace openhoi
@@ -0,0 +1,41 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <string>
+
+#include "hoibase/helper/library.hpp"
+
+namespace openhoi {
+
+// Quality presets of the province triangulation, from the cheapest to the most
+// expensive one
+enum class MeshQuality {
+  // Constrained Delaunay triangulation of the province rings without any
+  // additional vertices, e.g. for the server, which never renders the map
+  ConstrainedOnly = 0,
+
+  // Delaunay refinement, which inserts vertices until no triangle is too
+  // skinny
+  Refined = 1,
+
+  // Delaunay refinement followed by Lloyd optimization, which moves the
+  // inserted vertices towards the centroids of their cells
+  RefinedLloyd = 2
+};
+
+// Mesh quality used when none is requested explicitly
+constexpr MeshQuality DefaultMeshQuality = MeshQuality::RefinedLloyd;
+
+// Number of mesh quality presets
+constexpr int MeshQualityCount = 3;
+
+// Gets the name of the mesh quality preset, e.g. for option files and logs
+OPENHOI_LIB_EXPORT std::string const& getMeshQualityName(MeshQuality quality);
+
+// Parses the name of a mesh quality preset. Returns false and leaves the
+// quality untouched in case the name is unknown
+OPENHOI_LIB_EXPORT bool parseMeshQuality(std::string const& name,
+                                         MeshQuality& quality);
+
+}  // namespace openhoi
@@ -7,7 +7,10 @@
 #include <string>
 #include <vector>
 
+#include "hoibase/helper/array_view.hpp"
 #include "hoibase/helper/library.hpp"
+#include "hoibase/map/indexed_mesh.hpp"
+#include "hoibase/map/mesh_quality.hpp"
 
 namespace openhoi {
 
@@ -19,6 +22,13 @@ class Province final {
       std::string id, std::vector<std::vector<Ogre::Vector2>> coordinates,
       Ogre::Vector2 center);
 
+  // Provinces are move-only, so that their coordinates are never copied on
+  // their way into the map
+  Province(Province const&) = delete;
+  Province& operator=(Province const&) = delete;
+  Province(Province&&) = default;
+  Province& operator=(Province&&) = default;
+
   // Gets the province ID
   OPENHOI_LIB_EXPORT std::string const& getID() const;
 
@@ -26,17 +36,44 @@ class Province final {
   OPENHOI_LIB_EXPORT std::vector<std::vector<Ogre::Vector2>> const&
   getCoordinates() const;
 
-  // Gets the vertices of the triangulated province
-  OPENHOI_LIB_EXPORT std::vector<Ogre::Real> const getTriangulatedVertices()
-      const;
+  // Sets the province coordinates. This invalidates the triangulation
+  OPENHOI_LIB_EXPORT void setCoordinates(
+      std::vector<std::vector<Ogre::Vector2>> coordinates);
+
+  // Gets the triangulated province as indexed mesh with unique vertices. The
+  // province is triangulated on first access and the mesh is kept until the
+  // coordinates change or the triangulation is invalidated. The first access
+  // to one province must not happen from multiple threads at the same time.
+  OPENHOI_LIB_EXPORT IndexedMesh const& getIndexedMesh() const;
+
+  // Gets the vertices of the triangulated province as triangle list. It is
+  // expanded out of the kept indexed mesh on every call
+  OPENHOI_LIB_EXPORT std::vector<Ogre::Real> getTriangulatedVertices() const;
+
+  // Sets the vertices of the triangulated province, e.g. when they were
+  // restored from a cache. They are kept as indexed mesh until the coordinates
+  // change.
+  OPENHOI_LIB_EXPORT void setTriangulatedVertices(
+      std::vector<Ogre::Real> const& vertices);
+
+  // Drops the cached triangulation so that it is rebuilt on next access
+  OPENHOI_LIB_EXPORT void invalidateTriangulation();
 
   // Gets the province center point
   OPENHOI_LIB_EXPORT Ogre::Vector2 const& getCenter() const;
 
+  // Triangulates the provided province rings with the provided mesh quality
+  // and returns the vertices of the triangles
+  OPENHOI_LIB_EXPORT static std::vector<Ogre::Real> triangulate(
+      ArrayView<ArrayView<Ogre::Vector2>> rings,
+      MeshQuality quality = DefaultMeshQuality);
+
  private:
   std::string id;
   std::vector<std::vector<Ogre::Vector2>> coordinates;
   Ogre::Vector2 center;
+  mutable IndexedMesh mesh;
+  mutable bool triangulated;
 };
 
 }  // namespace openhoi
\ No newline at end of file
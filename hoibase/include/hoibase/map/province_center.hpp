@@ -0,0 +1,38 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <Ogre.h>
+
+#include "hoibase/helper/array_view.hpp"
+#include "hoibase/helper/library.hpp"
+#include "hoibase/map/province_store.hpp"
+
+// Precision of the province centers relative to the larger side of the
+// province's bounding box
+#define OPENHOI_PROVINCE_CENTER_PRECISION 0.001
+
+namespace openhoi {
+
+// Computes the visual centers of provinces, which are used to place labels and
+// units. The visual center is the pole of inaccessibility, the point inside the
+// province that is farthest away from its outline, found by the iterative grid
+// search of the polylabel algorithm. Unlike the centroid it always lies inside
+// the province, even for concave provinces or provinces with holes.
+class ProvinceCenter final {
+ public:
+  // Computes the pole of inaccessibility of the provided province rings. Rings
+  // inside of other rings are treated as holes. The result is accurate to the
+  // provided precision relative to the larger side of the bounding box
+  OPENHOI_LIB_EXPORT static Ogre::Vector2 compute(
+      ArrayView<ArrayView<Ogre::Vector2>> rings,
+      double relativePrecision = OPENHOI_PROVINCE_CENTER_PRECISION);
+
+  // Computes the centers of all provinces of the provided store in parallel
+  // and stores them as province centers. If a thread count of 0 is provided,
+  // the number of hardware threads is used.
+  OPENHOI_LIB_EXPORT static void computeCenters(ProvinceStore& provinces,
+                                                unsigned int threadCount = 0);
+};
+
+}  // namespace openhoi
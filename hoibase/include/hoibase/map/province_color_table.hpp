@@ -0,0 +1,63 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <Ogre.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "hoibase/helper/library.hpp"
+#include "hoibase/map/province_store.hpp"
+
+namespace openhoi {
+
+// Color lookup texture with one texel per province, which is read by the map
+// material to color the map mesh. Texel h is at (h % width, h / width).
+// Highlighting or recoloring provinces only changes this texture, the map mesh
+// stays untouched.
+class ProvinceColorTable final {
+ public:
+  // Width of the color lookup texture in texels
+  static const size_t Width = 1024;
+
+  // Creates the color lookup texture for the provided number of provinces.
+  // All provinces start out white
+  OPENHOI_LIB_EXPORT ProvinceColorTable(
+      std::string const& name, size_t provinceCount,
+      std::string const& resourceGroupName = Ogre::RGN_DEFAULT);
+
+  // Removes the color lookup texture
+  OPENHOI_LIB_EXPORT ~ProvinceColorTable();
+
+  ProvinceColorTable(ProvinceColorTable const&) = delete;
+  ProvinceColorTable& operator=(ProvinceColorTable const&) = delete;
+
+  // Sets the color of the province. The change becomes visible with the next
+  // upload
+  OPENHOI_LIB_EXPORT void setColor(ProvinceHandle province,
+                                   Ogre::ColourValue const& color);
+
+  // Gets the color of the province
+  OPENHOI_LIB_EXPORT Ogre::ColourValue getColor(ProvinceHandle province) const;
+
+  // Uploads the colors to the texture if any of them changed since the last
+  // upload
+  OPENHOI_LIB_EXPORT void upload();
+
+  // Binds the color lookup texture to the texture units named 'colorTable' in
+  // all techniques and passes of the provided material, e.g. the map material
+  OPENHOI_LIB_EXPORT void bind(Ogre::MaterialPtr const& material) const;
+
+  // Gets the color lookup texture
+  OPENHOI_LIB_EXPORT Ogre::TexturePtr const& getTexture() const;
+
+ private:
+  Ogre::TexturePtr texture;
+  size_t height;
+  std::vector<uint32_t> texels;
+  bool dirty;
+};
+
+}  // namespace openhoi
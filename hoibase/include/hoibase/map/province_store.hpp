@@ -0,0 +1,168 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <Ogre.h>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "hoibase/helper/array_view.hpp"
+#include "hoibase/helper/library.hpp"
+#include "hoibase/helper/monotonic_arena.hpp"
+#include "hoibase/map/indexed_mesh.hpp"
+#include "hoibase/map/mesh_quality.hpp"
+#include "hoibase/map/triangulator.hpp"
+
+namespace openhoi {
+
+// Handle of a province inside of a province store. Handles are dense, i.e. the
+// n-th province added to a store has the handle n
+typedef uint32_t ProvinceHandle;
+
+// Handle that does not refer to any province
+constexpr ProvinceHandle InvalidProvinceHandle =
+    std::numeric_limits<ProvinceHandle>::max();
+
+// Dense structure-of-arrays storage of all provinces of a map. The rings of
+// province h are [ringOffsets[h], ringOffsets[h + 1]) inside of the ring array.
+// The points of all rings are owned by a monotonic arena, where the points of
+// one province are contiguous and never move once the province was added.
+// Province IDs are only needed to map between the outside world and the
+// handles.
+class ProvinceStore final {
+ public:
+  // Province store constructor
+  OPENHOI_LIB_EXPORT ProvinceStore();
+
+  // The rings point into the arena of the store, so it can be moved but not
+  // copied
+  ProvinceStore(ProvinceStore const&) = delete;
+  ProvinceStore& operator=(ProvinceStore const&) = delete;
+  ProvinceStore(ProvinceStore&&) = default;
+  ProvinceStore& operator=(ProvinceStore&&) = default;
+
+  // Adds a province and returns its handle. The province ID must be unique
+  OPENHOI_LIB_EXPORT ProvinceHandle
+  add(std::string id, ArrayView<ArrayView<Ogre::Vector2>> rings,
+      Ogre::Vector2 center);
+
+  // Replaces the rings of the province and drops its triangulation. The new
+  // points are copied into the arena, the memory of the old points is only
+  // released together with the store
+  OPENHOI_LIB_EXPORT void setRings(ProvinceHandle province,
+                                   ArrayView<ArrayView<Ogre::Vector2>> rings);
+
+  // Reserves memory for the provided number of provinces, rings and points
+  OPENHOI_LIB_EXPORT void reserve(size_t provinceCount, size_t ringCount,
+                                  size_t pointCount);
+
+  // Gets the number of provinces
+  OPENHOI_LIB_EXPORT size_t size() const;
+
+  // Checks if the store has no provinces
+  OPENHOI_LIB_EXPORT bool empty() const;
+
+  // Gets the handle of the province with the provided ID or
+  // InvalidProvinceHandle if it does not exist
+  OPENHOI_LIB_EXPORT ProvinceHandle find(std::string const& id) const;
+
+  // Gets the province ID
+  OPENHOI_LIB_EXPORT std::string const& getID(ProvinceHandle province) const;
+
+  // Gets the province center point
+  OPENHOI_LIB_EXPORT Ogre::Vector2 const& getCenter(
+      ProvinceHandle province) const;
+
+  // Sets the province center point
+  OPENHOI_LIB_EXPORT void setCenter(ProvinceHandle province,
+                                    Ogre::Vector2 center);
+
+  // Gets the number of rings of the province
+  OPENHOI_LIB_EXPORT size_t getRingCount(ProvinceHandle province) const;
+
+  // Gets the points of one ring of the province
+  OPENHOI_LIB_EXPORT ArrayView<Ogre::Vector2> getRing(ProvinceHandle province,
+                                                      size_t ring) const;
+
+  // Gets the rings of the province
+  OPENHOI_LIB_EXPORT ArrayView<ArrayView<Ogre::Vector2>> getRings(
+      ProvinceHandle province) const;
+
+  // Gets the points of all rings of the province
+  OPENHOI_LIB_EXPORT ArrayView<Ogre::Vector2> getPoints(
+      ProvinceHandle province) const;
+
+  // Gets the index of the first ring of every province, followed by the total
+  // number of rings
+  OPENHOI_LIB_EXPORT std::vector<uint32_t> const& getRingOffsets() const;
+
+  // Gets the rings of all provinces
+  OPENHOI_LIB_EXPORT std::vector<ArrayView<Ogre::Vector2>> const& getRings()
+      const;
+
+  // Gets the number of points of all provinces
+  OPENHOI_LIB_EXPORT size_t getPointCount() const;
+
+  // Gets the arena that owns the points of all provinces
+  OPENHOI_LIB_EXPORT MonotonicArena const& getArena() const;
+
+  // Gets the mesh quality the provinces are triangulated with
+  OPENHOI_LIB_EXPORT MeshQuality getMeshQuality() const;
+
+  // Sets the mesh quality the provinces are triangulated with by switching to
+  // the CGAL triangulator. Changing it drops the triangulations of all
+  // provinces
+  OPENHOI_LIB_EXPORT void setMeshQuality(MeshQuality quality);
+
+  // Gets the triangulator the provinces are triangulated with
+  OPENHOI_LIB_EXPORT Triangulator const& getTriangulator() const;
+
+  // Sets the triangulator the provinces are triangulated with. This drops the
+  // triangulations of all provinces
+  OPENHOI_LIB_EXPORT void setTriangulator(
+      std::shared_ptr<Triangulator const> triangulator);
+
+  // Gets the triangulated province as indexed mesh with unique vertices. The
+  // province is triangulated on first access and the mesh is kept until the
+  // triangulation is invalidated. Different provinces may be triangulated
+  // from multiple threads at the same time, but the first access to one
+  // province must not happen from multiple threads at the same time.
+  OPENHOI_LIB_EXPORT IndexedMesh const& getIndexedMesh(
+      ProvinceHandle province) const;
+
+  // Gets the vertices of the triangulated province as triangle list. It is
+  // expanded out of the kept indexed mesh on every call
+  OPENHOI_LIB_EXPORT std::vector<Ogre::Real> getTriangulatedVertices(
+      ProvinceHandle province) const;
+
+  // Sets the triangulated province, e.g. when it was restored from a cache
+  OPENHOI_LIB_EXPORT void setIndexedMesh(ProvinceHandle province,
+                                         IndexedMesh mesh);
+
+  // Sets the vertices of the triangulated province. They are kept as indexed
+  // mesh
+  OPENHOI_LIB_EXPORT void setTriangulatedVertices(
+      ProvinceHandle province, std::vector<Ogre::Real> const& vertices);
+
+  // Drops the cached triangulation so that it is rebuilt on next access
+  OPENHOI_LIB_EXPORT void invalidateTriangulation(ProvinceHandle province);
+
+ private:
+  std::vector<std::string> ids;
+  std::vector<Ogre::Vector2> centers;
+  std::vector<uint32_t> ringOffsets;
+  std::vector<ArrayView<Ogre::Vector2>> rings;
+  MonotonicArena arena;
+  size_t totalPointCount;
+  std::shared_ptr<Triangulator const> triangulator;
+  mutable std::vector<IndexedMesh> meshes;
+  mutable std::vector<uint8_t> triangulated;
+  std::unordered_map<std::string, ProvinceHandle> index;
+};
+
+}  // namespace openhoi
@@ -0,0 +1,73 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <Ogre.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "hoibase/helper/library.hpp"
+#include "hoibase/map/province_store.hpp"
+
+namespace openhoi {
+
+// Axis aligned bounding box in map coordinates
+struct BoundingBox {
+  Ogre::Vector2 min;
+  Ogre::Vector2 max;
+};
+
+// Uniform grid over the bounding boxes of all provinces of a province store.
+// Every cell lists the provinces whose bounding box overlaps it, so point and
+// rectangle queries only have to look at the provinces of the touched cells.
+// The index is immutable once built and may be queried from multiple threads.
+class SpatialIndex final {
+ public:
+  // Builds the spatial index over all provinces of the provided store. The
+  // store must outlive the index and must not change while the index is used.
+  // If a cell count of 0 is provided, the grid gets about one cell per
+  // province.
+  OPENHOI_LIB_EXPORT SpatialIndex(ProvinceStore const& provinces,
+                                  size_t cellCount = 0);
+
+  // Gets the province that contains the provided point or InvalidProvinceHandle
+  // if the point is not inside of any province
+  OPENHOI_LIB_EXPORT ProvinceHandle pick(Ogre::Vector2 const& point) const;
+
+  // Gets all provinces whose bounding box intersects the provided rectangle,
+  // e.g. to cull the provinces outside of the view
+  OPENHOI_LIB_EXPORT std::vector<ProvinceHandle> query(
+      Ogre::Vector2 const& min, Ogre::Vector2 const& max) const;
+
+  // Gets the bounding box of the province
+  OPENHOI_LIB_EXPORT BoundingBox const& getBounds(
+      ProvinceHandle province) const;
+
+  // Gets the bounding box of all provinces
+  OPENHOI_LIB_EXPORT BoundingBox const& getBounds() const;
+
+  // Checks if the provided point is inside of the province. Rings are treated
+  // as closed and the even-odd rule is used, so holes are excluded
+  OPENHOI_LIB_EXPORT static bool contains(ProvinceStore const& provinces,
+                                          ProvinceHandle province,
+                                          Ogre::Vector2 const& point);
+
+ private:
+  // Gets the grid column of the provided x coordinate, clamped to the grid
+  size_t getColumn(Ogre::Real x) const;
+
+  // Gets the grid row of the provided y coordinate, clamped to the grid
+  size_t getRow(Ogre::Real y) const;
+
+  ProvinceStore const& provinces;
+  std::vector<BoundingBox> provinceBounds;
+  BoundingBox bounds;
+  size_t columns;
+  size_t rows;
+  Ogre::Vector2 cellSize;
+  std::vector<uint32_t> cellOffsets;
+  std::vector<ProvinceHandle> cellProvinces;
+};
+
+}  // namespace openhoi
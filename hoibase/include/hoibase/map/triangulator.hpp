@@ -0,0 +1,40 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <Ogre.h>
+
+#include <string>
+#include <vector>
+
+#include "hoibase/helper/array_view.hpp"
+#include "hoibase/helper/library.hpp"
+#include "hoibase/map/mesh_quality.hpp"
+
+namespace openhoi {
+
+// Interface of the province triangulation backends. Triangulators are
+// immutable, so one triangulator may be used from multiple threads at the same
+// time.
+class OPENHOI_LIB_EXPORT Triangulator {
+ public:
+  virtual ~Triangulator() = default;
+
+  // Gets the name of the triangulator, e.g. for logs and cache keys
+  virtual std::string getName() const = 0;
+
+  // Gets the mesh quality of the triangulations
+  virtual MeshQuality getMeshQuality() const = 0;
+
+  // Triangulates the provided province rings and returns the vertices of the
+  // triangles as x, y, z triples in map coordinates
+  virtual std::vector<Ogre::Real> triangulate(
+      ArrayView<ArrayView<Ogre::Vector2>> rings) const = 0;
+
+  // Appends a vertex in map coordinates out of the provided longitude and
+  // latitude
+  static void appendVertex(std::vector<Ogre::Real>& vertices, double x,
+                           double y);
+};
+
+}  // namespace openhoi
@@ -0,0 +1,182 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/file/asset_archive.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+namespace openhoi {
+
+// Opens the provided archive file. Use isOpen() to check if it is a valid
+// archive
+AssetArchive::AssetArchive(filesystem::path file)
+    : path(file),
+      file(file, MappedFileAccess::Random),
+      header(nullptr),
+      entries(nullptr),
+      namePool(nullptr) {
+  if (!this->file.isOpen() ||
+      this->file.getSize() < sizeof(AssetArchiveHeader))
+    return;
+  auto data = this->file.getData();
+  header = reinterpret_cast<AssetArchiveHeader const*>(data);
+  entries = reinterpret_cast<AssetArchiveEntry const*>(
+      data + sizeof(AssetArchiveHeader));
+  namePool = reinterpret_cast<char const*>(
+      data + sizeof(AssetArchiveHeader) +
+      (size_t)header->entryCount * sizeof(AssetArchiveEntry));
+  if (!validate()) header = nullptr;
+}
+
+// Opens the provided archive file and shares it between all callers as long as
+// any of them holds it. Once the last holder releases it, the file is unmapped
+// and the next call opens it again, e.g. after it was rebuilt. Returns nullptr
+// in case it is no valid archive
+std::shared_ptr<AssetArchive> AssetArchive::open(filesystem::path file) {
+  static std::mutex mutex;
+  static std::map<filesystem::path, std::weak_ptr<AssetArchive>> archives;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto it = archives.begin(); it != archives.end();) {
+    if (it->second.expired())
+      it = archives.erase(it);
+    else
+      ++it;
+  }
+  auto it = archives.find(file);
+  if (it != archives.end()) return it->second.lock();
+
+  // Invalid archives are not remembered, so that they are picked up as soon as
+  // they were built
+  auto archive = std::make_shared<AssetArchive>(file);
+  if (!archive->isOpen()) return nullptr;
+  archives.insert({file, archive});
+  return archive;
+}
+
+// Checks if the archive was opened and its index is valid
+bool AssetArchive::isOpen() const { return header != nullptr; }
+
+// Gets the path of the archive file
+filesystem::path const& AssetArchive::getPath() const { return path; }
+
+// Gets the number of entries
+size_t AssetArchive::getEntryCount() const {
+  return isOpen() ? header->entryCount : 0;
+}
+
+// Gets the entry at the provided index position
+AssetArchiveEntry const& AssetArchive::getEntry(size_t index) const {
+  return entries[index];
+}
+
+// Gets the name of the provided entry
+std::string AssetArchive::getName(AssetArchiveEntry const& entry) const {
+  return std::string(namePool + entry.nameOffset, entry.nameLength);
+}
+
+// Finds the entry with the provided name. Returns nullptr in case there is no
+// such entry
+AssetArchiveEntry const* AssetArchive::find(std::string const& name) const {
+  if (!isOpen()) return nullptr;
+  auto it = lowerBound(name);
+  if (it == entries + header->entryCount || getName(*it) != name)
+    return nullptr;
+  return it;
+}
+
+// Gets the data of the provided entry in place or nullptr in case it is
+// compressed
+unsigned char const* AssetArchive::getStoredData(
+    AssetArchiveEntry const& entry) const {
+  if (entry.flags & OPENHOI_ASSET_ARCHIVE_ZLIB) return nullptr;
+  return file.getData() + entry.dataOffset;
+}
+
+// Reads the uncompressed data of the provided entry into the provided buffer,
+// which must hold at least entry.size bytes. Returns false in case the data is
+// corrupt
+bool AssetArchive::read(AssetArchiveEntry const& entry,
+                        unsigned char* data) const {
+  unsigned char const* stored = file.getData() + entry.dataOffset;
+  if (!(entry.flags & OPENHOI_ASSET_ARCHIVE_ZLIB)) {
+    if (entry.size > 0) memcpy(data, stored, entry.size);
+    return true;
+  }
+  uLongf size = (uLongf)entry.size;
+  return uncompress(data, &size, stored, (uLong)entry.storedSize) == Z_OK &&
+         size == entry.size;
+}
+
+// Reads the uncompressed data of the entry with the provided name. Returns
+// false in case there is no such entry or its data is corrupt
+bool AssetArchive::read(std::string const& name,
+                        std::vector<unsigned char>& data) const {
+  auto entry = find(name);
+  if (!entry) return false;
+  data.resize(entry->size);
+  return read(*entry, data.data());
+}
+
+// Lists the names of all entries inside the provided directory, e.g.
+// "graphics/flags", or of all entries if the directory is empty. Entries in
+// subdirectories are only listed if recursive is set
+std::vector<std::string> AssetArchive::list(std::string const& directory,
+                                            bool recursive) const {
+  std::vector<std::string> names;
+  if (!isOpen()) return names;
+
+  // All entries of a directory are next to each other in the sorted index
+  std::string prefix = directory;
+  if (!prefix.empty() && prefix.back() != '/') prefix += '/';
+  auto end = entries + header->entryCount;
+  for (auto it = lowerBound(prefix); it != end; ++it) {
+    std::string name = getName(*it);
+    if (name.compare(0, prefix.size(), prefix) != 0) break;
+    if (recursive || name.find('/', prefix.size()) == std::string::npos)
+      names.push_back(name);
+  }
+  return names;
+}
+
+// Gets the first entry whose name is not less than the provided name
+AssetArchiveEntry const* AssetArchive::lowerBound(
+    std::string const& name) const {
+  return std::lower_bound(
+      entries, entries + header->entryCount, name,
+      [this](AssetArchiveEntry const& entry, std::string const& name) {
+        return name.compare(0, std::string::npos, namePool + entry.nameOffset,
+                            entry.nameLength) > 0;
+      });
+}
+
+// Checks that the header, index and name pool are within the file
+bool AssetArchive::validate() const {
+  size_t size = file.getSize();
+  if (memcmp(header->magic, OPENHOI_ASSET_ARCHIVE_MAGIC,
+             sizeof(header->magic)) != 0 ||
+      header->version != OPENHOI_ASSET_ARCHIVE_VERSION)
+    return false;
+  uint64_t dataStart =
+      sizeof(AssetArchiveHeader) +
+      (uint64_t)header->entryCount * sizeof(AssetArchiveEntry) +
+      header->namePoolSize;
+  if (dataStart > size) return false;
+  for (uint32_t i = 0; i < header->entryCount; i++) {
+    auto const& entry = entries[i];
+    if ((uint64_t)entry.nameOffset + entry.nameLength > header->namePoolSize ||
+        entry.dataOffset < dataStart || entry.dataOffset > size ||
+        entry.storedSize > size - entry.dataOffset)
+      return false;
+    if (!(entry.flags & OPENHOI_ASSET_ARCHIVE_ZLIB) &&
+        entry.storedSize != entry.size)
+      return false;
+  }
+  return true;
+}
+
+}  // namespace openhoi
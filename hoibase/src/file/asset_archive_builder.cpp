@@ -0,0 +1,119 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/file/asset_archive_builder.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "hoibase/file/asset_archive_format.hpp"
+#include "hoibase/file/file_access.hpp"
+
+namespace openhoi {
+
+// Packs all regular files below the provided asset root directory into an
+// asset archive file (see asset_archive_format.hpp). Every entry is compressed
+// with zlib at the provided level (1 to 9) if that makes it smaller, level 0
+// stores all entries as is. Returns false in case a file could not be read or
+// the archive could not be written.
+bool AssetArchiveBuilder::build(filesystem::path root, filesystem::path file,
+                                int compressionLevel) {
+  // Collect all files sorted by their entry name. The archive itself is
+  // skipped in case it is written into the asset root directory
+  std::vector<std::pair<std::string, filesystem::path>> files;
+  std::error_code error;
+  for (filesystem::recursive_directory_iterator it(root, error), end;
+       !error && it != end; it.increment(error)) {
+    if (!filesystem::is_regular_file(it->path())) continue;
+    if (filesystem::exists(file) && filesystem::equivalent(it->path(), file))
+      continue;
+    files.push_back(
+        {filesystem::relative(it->path(), root).generic_u8string(),
+         it->path()});
+  }
+  if (error) return false;
+  std::sort(files.begin(), files.end());
+
+  // Build the index without data offsets and the name pool
+  std::vector<AssetArchiveEntry> entries;
+  std::string namePool;
+  entries.reserve(files.size());
+  for (auto const& entry : files) {
+    AssetArchiveEntry archiveEntry = {};
+    archiveEntry.nameOffset = (uint32_t)namePool.size();
+    archiveEntry.nameLength = (uint32_t)entry.first.size();
+    entries.push_back(archiveEntry);
+    namePool += entry.first;
+  }
+
+  AssetArchiveHeader header;
+  memcpy(header.magic, OPENHOI_ASSET_ARCHIVE_MAGIC, sizeof(header.magic));
+  header.version = OPENHOI_ASSET_ARCHIVE_VERSION;
+  header.entryCount = (uint32_t)entries.size();
+  header.namePoolSize = (uint32_t)namePool.size();
+
+  // Write the file. The index is written twice: first as placeholder and
+  // again once the data offsets and sizes are known
+  auto closeFile = [](FILE* f) { fclose(f); };
+  auto holder = std::unique_ptr<FILE, decltype(closeFile)>(
+      FileAccess::fopen(file, "wb"), closeFile);
+  if (!holder) return false;
+  FILE* fp = holder.get();
+
+  bool ok = true;
+  uint64_t offset = 0;
+  auto write = [&](void const* data, size_t length) {
+    if (ok && length > 0) ok = fwrite(data, 1, length, fp) == length;
+    offset += length;
+  };
+  write(&header, sizeof(header));
+  write(entries.data(), entries.size() * sizeof(AssetArchiveEntry));
+  write(namePool.data(), namePool.size());
+
+  std::vector<unsigned char> compressed;
+  for (size_t i = 0; ok && i < files.size(); i++) {
+    auto& entry = entries[i];
+    entry.dataOffset = offset;
+
+    // Empty files cannot be mapped, but are valid entries
+    auto mapping = FileAccess::mapFile(files[i].second);
+    if (!mapping) {
+      if (filesystem::file_size(files[i].second, error) != 0 || error)
+        return false;
+      continue;
+    }
+    unsigned char const* data = mapping->getData();
+    entry.size = mapping->getSize();
+    entry.storedSize = entry.size;
+
+    // Compress the entry if that makes it smaller. zlib cannot handle sizes
+    // above 4 GiB in one call on every platform, so such entries are stored
+    if (compressionLevel > 0 &&
+        entry.size <= std::numeric_limits<uint32_t>::max()) {
+      uLongf compressedSize = compressBound((uLong)entry.size);
+      compressed.resize(compressedSize);
+      if (compress2(compressed.data(), &compressedSize, data, (uLong)entry.size,
+                    compressionLevel) == Z_OK &&
+          compressedSize < entry.size) {
+        entry.flags |= OPENHOI_ASSET_ARCHIVE_ZLIB;
+        entry.storedSize = compressedSize;
+        data = compressed.data();
+      }
+    }
+    write(data, (size_t)entry.storedSize);
+  }
+
+  // Write the final index
+  if (ok) ok = fseek(fp, sizeof(header), SEEK_SET) == 0;
+  write(entries.data(), entries.size() * sizeof(AssetArchiveEntry));
+  return ok;
+}
+
+}  // namespace openhoi
@@ -197,6 +197,14 @@ filesystem::path FileAccess::getAssetRootDirectory() {
   return FileAccess::gameAssetRootDirectory;
 }
 
+// Gets the asset archive inside the game asset root directory (see
+// asset_archive_format.hpp) or nullptr if there is none. The archive is shared
+// while it is in use.
+std::shared_ptr<AssetArchive> FileAccess::getAssetArchive() {
+  return AssetArchive::open(FileAccess::getAssetRootDirectory() /
+                            OPENHOI_ASSET_ARCHIVE_FILE);
+}
+
 // Custom fopen override for Windows
 FILE* FileAccess::fopen(char const* fileName, char const* mode) {
 #ifdef OPENHOI_OS_WINDOWS
@@ -258,6 +266,17 @@ long FileAccess::readFile(filesystem::path file, unsigned char** data) {
   return (long)size;
 }
 
+// Maps the provided file into memory instead of copying it, so that it can be
+// parsed in place. Returns nullptr in case the file could not be mapped, e.g.
+// because it does not exist or is empty.
+std::unique_ptr<MappedFile> FileAccess::mapFile(filesystem::path file,
+                                                MappedFileAccess access) {
+  if (!filesystem::is_regular_file(file)) return nullptr;
+  auto mapping = std::make_unique<MappedFile>(file, access);
+  if (!mapping->isOpen()) return nullptr;
+  return mapping;
+}
+
 // Gets the OGRE plugin directory. In case the plugins should be located
 // relatively to the executables, an empty path is returned.
 filesystem::path FileAccess::getOgrePluginDirectory() {
@@ -0,0 +1,138 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/file/file_read_service.hpp"
+
+#include <algorithm>
+#include <exception>
+
+#include "hoibase/file/file_access.hpp"
+
+namespace openhoi {
+
+// Orders the requests by priority first and by queue order second
+bool FileReadService::Request::operator<(Request const& other) const {
+  // The priority queue returns the largest element first
+  if (priority != other.priority) return priority < other.priority;
+  return sequence > other.sequence;
+}
+
+// Starts the provided number of I/O threads
+FileReadService::FileReadService(unsigned int threadCount)
+    : nextSequence(0), stopping(false), paused(false), pendingCount(0) {
+  threadCount = std::max(threadCount, 1u);
+  threads.reserve(threadCount);
+  for (unsigned int i = 0; i < threadCount; i++)
+    threads.emplace_back(&FileReadService::work, this);
+}
+
+// Stops the I/O threads after their current read. Reads that have not been
+// started yet are dropped: their futures report a broken promise and their
+// callbacks are never invoked
+FileReadService::~FileReadService() {
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    stopping = true;
+  }
+  queueCondition.notify_all();
+  for (auto& thread : threads) thread.join();
+}
+
+// Queues the file for reading. The future receives the file or nullptr if it
+// could not be read
+std::future<std::unique_ptr<MappedFile>> FileReadService::read(
+    filesystem::path file, FileReadPriority priority) {
+  auto promise = std::make_shared<std::promise<std::unique_ptr<MappedFile>>>();
+  auto future = promise->get_future();
+  enqueue({std::move(file), priority, 0, std::move(promise), nullptr});
+  return future;
+}
+
+// Queues the file for reading. The callback receives the file or nullptr if it
+// could not be read during the next dispatch after the read finished
+void FileReadService::read(filesystem::path file, FileReadCallback callback,
+                           FileReadPriority priority) {
+  enqueue({std::move(file), priority, 0, nullptr, std::move(callback)});
+}
+
+// Stops the I/O threads from starting further reads until resume is called.
+// Reads that are running are finished. This allows queueing a batch of reads
+// that are started in priority order as a whole
+void FileReadService::pause() {
+  std::lock_guard<std::mutex> lock(queueMutex);
+  paused = true;
+}
+
+// Lets the I/O threads start queued reads again after pause was called
+void FileReadService::resume() {
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    paused = false;
+  }
+  queueCondition.notify_all();
+}
+
+// Invokes the callbacks of all finished reads on the calling thread, e.g. once
+// per frame on the render thread. Returns the number of invoked callbacks
+size_t FileReadService::dispatch() {
+  // Take the finished reads first, so that callbacks may queue new reads
+  std::vector<std::pair<FileReadCallback, std::unique_ptr<MappedFile>>> reads;
+  {
+    std::lock_guard<std::mutex> lock(completedMutex);
+    reads.swap(completed);
+  }
+  for (auto& read : reads) read.first(std::move(read.second));
+  return reads.size();
+}
+
+// Gets the number of reads that are queued or running
+size_t FileReadService::getPendingCount() const { return pendingCount; }
+
+// Queues the request and wakes up one I/O thread
+void FileReadService::enqueue(Request request) {
+  pendingCount++;
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    request.sequence = nextSequence++;
+    queue.push(std::move(request));
+  }
+  queueCondition.notify_one();
+}
+
+// Runs one I/O thread until the service is stopped
+void FileReadService::work() {
+  for (;;) {
+    // Wait for the next request
+    Request request;
+    {
+      std::unique_lock<std::mutex> lock(queueMutex);
+      queueCondition.wait(
+          lock, [this] { return stopping || (!paused && !queue.empty()); });
+      if (stopping) return;
+      request = queue.top();
+      queue.pop();
+    }
+
+    // Map the file and read it in. Errors are reported as unreadable file
+    std::unique_ptr<MappedFile> file;
+    std::exception_ptr error;
+    try {
+      file = FileAccess::mapFile(request.file, MappedFileAccess::Sequential);
+      if (file) file->load();
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    // Hand the file over
+    if (request.callback) {
+      std::lock_guard<std::mutex> lock(completedMutex);
+      completed.push_back({std::move(request.callback), std::move(file)});
+    } else if (error) {
+      request.promise->set_exception(error);
+    } else {
+      request.promise->set_value(std::move(file));
+    }
+    pendingCount--;
+  }
+}
+
+}  // namespace openhoi
@@ -0,0 +1,83 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/file/file_watcher.hpp"
+
+#include <string>
+#include <system_error>
+
+#ifdef OPENHOI_OS_LINUX
+#  include <sys/inotify.h>
+#  include <unistd.h>
+#endif
+
+namespace openhoi {
+
+// Starts watching the provided file. The file does not need to exist yet
+FileWatcher::FileWatcher(filesystem::path file) : file(std::move(file)) {
+  lastWriteTime = getLastWriteTime();
+
+#ifdef OPENHOI_OS_LINUX
+  // Watch the parent directory instead of the file itself, as a watch on the
+  // file is lost as soon as the file is replaced
+  inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotifyDescriptor < 0) return;
+  filesystem::path directory = this->file.parent_path();
+  if (directory.empty()) directory = ".";
+  if (inotify_add_watch(inotifyDescriptor, directory.c_str(),
+                        IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+    close(inotifyDescriptor);
+    inotifyDescriptor = -1;
+  }
+#endif
+}
+
+// Stops watching the file
+FileWatcher::~FileWatcher() {
+#ifdef OPENHOI_OS_LINUX
+  if (inotifyDescriptor >= 0) close(inotifyDescriptor);
+#endif
+}
+
+// Checks without blocking if the file was written, replaced or created since
+// the last poll
+bool FileWatcher::poll() {
+#ifdef OPENHOI_OS_LINUX
+  if (inotifyDescriptor >= 0) {
+    // Drain all pending events, so that one save that caused multiple events
+    // is only reported once
+    bool changed = false;
+    std::string fileName = file.filename().string();
+    alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+      ssize_t length = read(inotifyDescriptor, buffer, sizeof(buffer));
+      if (length <= 0) break;
+      for (char* ptr = buffer; ptr < buffer + length;) {
+        auto event = reinterpret_cast<struct inotify_event const*>(ptr);
+        if (event->len > 0 && fileName == event->name) changed = true;
+        ptr += sizeof(struct inotify_event) + event->len;
+      }
+    }
+    return changed;
+  }
+#endif
+
+  // Fall back to comparing the modification time
+  filesystem::file_time_type writeTime = getLastWriteTime();
+  if (writeTime == lastWriteTime) return false;
+  lastWriteTime = writeTime;
+  return true;
+}
+
+// Gets the watched file
+filesystem::path const& FileWatcher::getPath() const { return file; }
+
+// Gets the modification time of the file or the default time if it does not
+// exist
+filesystem::file_time_type FileWatcher::getLastWriteTime() const {
+  std::error_code error;
+  filesystem::file_time_type writeTime =
+      filesystem::last_write_time(file, error);
+  return error ? filesystem::file_time_type() : writeTime;
+}
+
+}  // namespace openhoi
@@ -0,0 +1,128 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/file/mapped_file.hpp"
+
+#ifndef OPENHOI_OS_WINDOWS
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace openhoi {
+
+// Maps the provided file into memory and passes the access pattern to the
+// operating system. Use isOpen() to check if this worked
+MappedFile::MappedFile(filesystem::path file, MappedFileAccess access)
+    : data(nullptr),
+      size(0)
+#ifdef OPENHOI_OS_WINDOWS
+      ,
+      fileHandle(INVALID_HANDLE_VALUE),
+      mappingHandle(NULL)
+#endif
+{
+#ifdef OPENHOI_OS_WINDOWS
+  // Open file. The access pattern is a hint for the file cache, as Windows has
+  // no way to advise a mapped view
+  DWORD flags = FILE_ATTRIBUTE_NORMAL;
+  if (access == MappedFileAccess::Sequential)
+    flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+  else if (access == MappedFileAccess::Random)
+    flags |= FILE_FLAG_RANDOM_ACCESS;
+  fileHandle = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                           OPEN_EXISTING, flags, NULL);
+  if (fileHandle == INVALID_HANDLE_VALUE) return;
+
+  // Get file size. Empty files cannot be mapped
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) return;
+
+  // Map the whole file
+  mappingHandle =
+      CreateFileMappingW(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mappingHandle == NULL) return;
+  void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+  if (view == NULL) return;
+
+  data = static_cast<unsigned char const*>(view);
+  size = (size_t)fileSize.QuadPart;
+#else
+  // Open file
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0) return;
+
+  // Get file size. Empty files cannot be mapped
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+    close(fd);
+    return;
+  }
+
+  // Map the whole file. The mapping stays valid after closing the descriptor
+  void* view = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd,
+                    0);
+  close(fd);
+  if (view == MAP_FAILED) return;
+
+  data = static_cast<unsigned char const*>(view);
+  size = (size_t)fileStat.st_size;
+  advise(access);
+#endif
+}
+
+// Unmaps the file
+MappedFile::~MappedFile() {
+#ifdef OPENHOI_OS_WINDOWS
+  if (data) UnmapViewOfFile(data);
+  if (mappingHandle != NULL) CloseHandle(mappingHandle);
+  if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+#else
+  if (data) munmap(const_cast<unsigned char*>(data), size);
+#endif
+}
+
+// Checks if the file is mapped
+bool MappedFile::isOpen() const { return data != nullptr; }
+
+// Gets the mapped file content
+unsigned char const* MappedFile::getData() const { return data; }
+
+// Gets the size of the mapped file
+size_t MappedFile::getSize() const { return size; }
+
+// Passes a changed access pattern for the whole file to the operating system
+void MappedFile::advise(MappedFileAccess access) {
+#ifndef OPENHOI_OS_WINDOWS
+  if (!data) return;
+  int advice = MADV_NORMAL;
+  if (access == MappedFileAccess::Sequential)
+    advice = MADV_SEQUENTIAL;
+  else if (access == MappedFileAccess::Random)
+    advice = MADV_RANDOM;
+
+  // The advice is only a hint, so failing to give it is not an error
+  madvise(const_cast<unsigned char*>(data), size, advice);
+#endif
+}
+
+// Reads all pages of the file into memory, so that accessing the content later
+// on does not block on the disk
+void MappedFile::load() const {
+  if (!data) return;
+#ifndef OPENHOI_OS_WINDOWS
+  // Let the kernel read ahead the whole file while the pages are touched
+  madvise(const_cast<unsigned char*>(data), size, MADV_WILLNEED);
+#endif
+
+  // Touch one byte per page. Reading through a volatile pointer keeps the
+  // compiler from dropping the reads
+  const size_t pageSize = 4096;
+  volatile unsigned char const* bytes = data;
+  unsigned char sum = 0;
+  for (size_t offset = 0; offset < size; offset += pageSize)
+    sum = (unsigned char)(sum + bytes[offset]);
+  (void)sum;
+}
+
+}  // namespace openhoi
@@ -0,0 +1,206 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/file/ogre_asset_archive.hpp"
+
+#include <OgreDataStream.h>
+#include <OgreException.h>
+#include <OgreString.h>
+
+#include <algorithm>
+#include <chrono>
+#include <system_error>
+#include <utility>
+
+namespace openhoi {
+
+namespace {
+
+// Memory stream over a stored entry, used in place. It holds the asset archive,
+// so that the data stays mapped as long as the stream is in use, even if the
+// OGRE archive is unloaded in between
+class StoredEntryDataStream final : public Ogre::MemoryDataStream {
+ public:
+  StoredEntryDataStream(Ogre::String const& name,
+                        std::shared_ptr<AssetArchive> archive,
+                        unsigned char const* data, size_t size)
+      : Ogre::MemoryDataStream(name, const_cast<unsigned char*>(data), size,
+                               false, true),
+        archive(std::move(archive)) {}
+
+ private:
+  std::shared_ptr<AssetArchive> archive;
+};
+
+}  // namespace
+
+// Creates the archive for the provided location name
+OgreAssetArchive::OgreAssetArchive(Ogre::String const& name,
+                                   Ogre::String const& type)
+    : Ogre::Archive(name, type) {
+  // Split the location name after the archive file extension. Both separators
+  // are accepted, as the name is usually built with filesystem::path
+  std::string location = name;
+  std::replace(location.begin(), location.end(), '\\', '/');
+  std::string extension = OPENHOI_ASSET_ARCHIVE_EXTENSION;
+  size_t split = location.find(extension + "/");
+  if (split == std::string::npos) split = location.rfind(extension);
+  if (split == std::string::npos) {
+    archiveFile = filesystem::u8path(location);
+  } else {
+    split += extension.size();
+    archiveFile = filesystem::u8path(location.substr(0, split));
+    if (split < location.size()) directory = location.substr(split + 1);
+  }
+  while (!directory.empty() && directory.back() == '/') directory.pop_back();
+  if (!directory.empty()) directory += '/';
+}
+
+// Entry names are case sensitive
+bool OgreAssetArchive::isCaseSensitive() const { return true; }
+
+// Opens the asset archive file
+void OgreAssetArchive::load() {
+  archive = AssetArchive::open(archiveFile);
+  if (!archive)
+    OGRE_EXCEPT(Ogre::Exception::ERR_INVALIDPARAMS,
+                "Unable to open asset archive '" + archiveFile.u8string() + "'",
+                "OgreAssetArchive::load");
+}
+
+// Releases the asset archive file. It is unmapped once no other location uses
+// it anymore
+void OgreAssetArchive::unload() { archive.reset(); }
+
+// Opens the provided file. Stored entries are used in place and keep the archive
+// mapped while the stream is in use, compressed entries are decompressed into
+// memory
+Ogre::DataStreamPtr OgreAssetArchive::open(Ogre::String const& filename,
+                                           bool /*readOnly*/) const {
+  auto entry = archive ? archive->find(directory + filename) : nullptr;
+  if (!entry)
+    OGRE_EXCEPT(Ogre::Exception::ERR_FILE_NOT_FOUND,
+                "Cannot find '" + filename + "' in '" + mName + "'",
+                "OgreAssetArchive::open");
+
+  // The stream holds the archive, so the stored data stays valid until the
+  // stream is released
+  auto stored = archive->getStoredData(*entry);
+  if (stored)
+    return std::make_shared<StoredEntryDataStream>(filename, archive, stored,
+                                                   (size_t)entry->size);
+
+  auto stream = std::make_shared<Ogre::MemoryDataStream>(
+      filename, (size_t)entry->size, true, true);
+  if (!archive->read(*entry, stream->getPtr()))
+    OGRE_EXCEPT(Ogre::Exception::ERR_INVALID_STATE,
+                "Corrupt entry '" + filename + "' in '" + mName + "'",
+                "OgreAssetArchive::open");
+  return stream;
+}
+
+// Lists all files of the directory
+Ogre::StringVectorPtr OgreAssetArchive::list(bool recursive, bool dirs) const {
+  auto names = std::make_shared<Ogre::StringVector>();
+  if (dirs) return names;
+  for (auto const& info : *collect("", recursive))
+    names->push_back(info.filename);
+  return names;
+}
+
+// Lists all files of the directory with details
+Ogre::FileInfoListPtr OgreAssetArchive::listFileInfo(bool recursive,
+                                                     bool dirs) const {
+  if (dirs) return std::make_shared<Ogre::FileInfoList>();
+  return collect("", recursive);
+}
+
+// Finds all files of the directory that match the provided pattern
+Ogre::StringVectorPtr OgreAssetArchive::find(Ogre::String const& pattern,
+                                             bool recursive, bool dirs) const {
+  auto names = std::make_shared<Ogre::StringVector>();
+  if (dirs) return names;
+  for (auto const& info : *collect(pattern, recursive))
+    names->push_back(info.filename);
+  return names;
+}
+
+// Finds all files of the directory with details that match the provided
+// pattern
+Ogre::FileInfoListPtr OgreAssetArchive::findFileInfo(
+    Ogre::String const& pattern, bool recursive, bool dirs) const {
+  if (dirs) return std::make_shared<Ogre::FileInfoList>();
+  return collect(pattern, recursive);
+}
+
+// Checks if the provided file exists
+bool OgreAssetArchive::exists(Ogre::String const& filename) const {
+  return archive && archive->find(directory + filename) != nullptr;
+}
+
+// Gets the modification time of the asset archive file, as entries carry no
+// modification time of their own
+time_t OgreAssetArchive::getModifiedTime(
+    Ogre::String const& /*filename*/) const {
+  std::error_code error;
+  auto time = filesystem::last_write_time(archiveFile, error);
+  if (error) return 0;
+
+  // The clock of the file time has no defined epoch, so convert it relatively
+  // to the current time
+  auto now = decltype(time)::clock::now();
+  return std::chrono::system_clock::to_time_t(
+      std::chrono::system_clock::now() +
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(time -
+                                                                      now));
+}
+
+// Collects the details of all files of the directory that match the provided
+// pattern. An empty pattern matches every file
+Ogre::FileInfoListPtr OgreAssetArchive::collect(Ogre::String const& pattern,
+                                                bool recursive) const {
+  auto infos = std::make_shared<Ogre::FileInfoList>();
+  if (!archive) return infos;
+
+  // Patterns with a directory are matched against the whole file name, all
+  // others only against the base name
+  bool fullMatch = pattern.find('/') != std::string::npos;
+  for (auto const& name : archive->list(directory, recursive)) {
+    auto entry = archive->find(name);
+    Ogre::FileInfo info;
+    info.archive = this;
+    info.filename = name.substr(directory.size());
+    size_t slash = info.filename.rfind('/');
+    info.basename = slash == std::string::npos
+                        ? info.filename
+                        : info.filename.substr(slash + 1);
+    info.path = info.filename.substr(0, info.filename.size() -
+                                            info.basename.size());
+    if (!pattern.empty() &&
+        !Ogre::StringUtil::match(fullMatch ? info.filename : info.basename,
+                                 pattern, true))
+      continue;
+    info.compressedSize = (size_t)entry->storedSize;
+    info.uncompressedSize = (size_t)entry->size;
+    infos->push_back(info);
+  }
+  return infos;
+}
+
+// Gets the OGRE archive type
+Ogre::String const& OgreAssetArchiveFactory::getType() const {
+  static Ogre::String const type = OPENHOI_OGRE_ASSET_ARCHIVE_TYPE;
+  return type;
+}
+
+// Creates the archive for the provided location name
+Ogre::Archive* OgreAssetArchiveFactory::createInstance(Ogre::String const& name,
+                                                       bool /*readOnly*/) {
+  return OGRE_NEW OgreAssetArchive(name, getType());
+}
+
+// Destroys the provided archive
+void OgreAssetArchiveFactory::destroyInstance(Ogre::Archive* archive) {
+  OGRE_DELETE archive;
+}
+
+}  // namespace openhoi
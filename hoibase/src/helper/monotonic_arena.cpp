@@ -0,0 +1,81 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/helper/monotonic_arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace openhoi {
+
+// Monotonic arena constructor. Blocks are allocated with the provided size
+// unless a single allocation needs a larger block
+MonotonicArena::MonotonicArena(size_t blockSize)
+    : blockSize(blockSize), used(0), allocated(0), capacity(0) {}
+
+// Monotonic arena move constructor
+MonotonicArena::MonotonicArena(MonotonicArena&& other) noexcept
+    : blockSize(other.blockSize),
+      blocks(std::move(other.blocks)),
+      used(other.used),
+      allocated(other.allocated),
+      capacity(other.capacity) {
+  other.blocks.clear();
+  other.used = other.allocated = other.capacity = 0;
+}
+
+// Monotonic arena move assignment
+MonotonicArena& MonotonicArena::operator=(MonotonicArena&& other) noexcept {
+  if (this != &other) {
+    blockSize = other.blockSize;
+    blocks = std::move(other.blocks);
+    used = other.used;
+    allocated = other.allocated;
+    capacity = other.capacity;
+    other.blocks.clear();
+    other.used = other.allocated = other.capacity = 0;
+  }
+  return *this;
+}
+
+// Allocates uninitialized memory with the provided size and alignment
+void* MonotonicArena::allocate(size_t size, size_t alignment) {
+  // Align the offset inside of the current block and fall back to a new block
+  // if the allocation does not fit
+  size_t offset = (used + alignment - 1) & ~(alignment - 1);
+  if (blocks.empty() || offset + size > blocks.back().size) {
+    addBlock(size + alignment);
+    offset = 0;
+    while (((uintptr_t)blocks.back().data.get() + offset) % alignment != 0)
+      offset++;
+  }
+
+  used = offset + size;
+  allocated += size;
+  return blocks.back().data.get() + offset;
+}
+
+// Makes sure that the next allocations with a total of the provided size are
+// served from a single block
+void MonotonicArena::reserve(size_t size) {
+  if (blocks.empty() || used + size > blocks.back().size) addBlock(size);
+}
+
+// Gets the number of blocks allocated from the system
+size_t MonotonicArena::getBlockCount() const { return blocks.size(); }
+
+// Gets the number of bytes handed out by the arena
+size_t MonotonicArena::getAllocatedSize() const { return allocated; }
+
+// Gets the number of bytes allocated from the system
+size_t MonotonicArena::getCapacity() const { return capacity; }
+
+// Appends a new block that is at least of the provided size
+void MonotonicArena::addBlock(size_t size) {
+  size = std::max(size, blockSize);
+  blocks.push_back({std::unique_ptr<unsigned char[]>(new unsigned char[size]),
+                    size});
+  used = 0;
+  capacity += size;
+}
+
+}  // namespace openhoi
@@ -0,0 +1,63 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/helper/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace openhoi {
+
+// Invokes the provided task for every index in [0, count) using a pool of
+// worker threads. The calling thread takes part in the work and this function
+// returns as soon as all indices were processed. If a thread count of 0 is
+// provided, the number of hardware threads is used. The first exception thrown
+// by a task is rethrown on the calling thread.
+void Parallel::forEach(size_t count, std::function<void(size_t)> const& task,
+                       unsigned int threadCount) {
+  if (count == 0) return;
+
+  // Never start more threads than there is work to do
+  if (threadCount == 0) threadCount = getDefaultThreadCount();
+  threadCount = (unsigned int)std::min<size_t>(threadCount, count);
+
+  // Every worker grabs the next unprocessed index until all are done. This
+  // balances the load even if some tasks take a lot longer than others
+  std::atomic<size_t> nextIndex(0);
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  auto worker = [&]() {
+    size_t index;
+    while ((index = nextIndex++) < count) {
+      try {
+        task(index);
+      } catch (...) {
+        // Remember the first error and make all workers stop early
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) error = std::current_exception();
+        nextIndex = count;
+      }
+    }
+  };
+
+  // Start the additional worker threads. The calling thread is a worker, too
+  std::vector<std::thread> threads;
+  threads.reserve(threadCount - 1);
+  for (unsigned int i = 1; i < threadCount; i++) threads.emplace_back(worker);
+  worker();
+  for (auto& thread : threads) thread.join();
+
+  // Forward the error to the caller
+  if (error) std::rethrow_exception(error);
+}
+
+// Gets the number of worker threads used by default
+unsigned int Parallel::getDefaultThreadCount() {
+  unsigned int threadCount = std::thread::hardware_concurrency();
+  return threadCount > 0 ? threadCount : 1;
+}
+
+}  // namespace openhoi
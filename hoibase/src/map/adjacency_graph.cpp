@@ -0,0 +1,81 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/adjacency_graph.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "hoibase/map/border_index.hpp"
+
+namespace openhoi {
+
+// Builds the adjacency graph of all provinces of the provided store from their
+// shared border edges. The build time is linear in the number of points
+AdjacencyGraph::AdjacencyGraph(ProvinceStore const& provinces) {
+  BorderIndex borders(provinces);
+  auto const& ringOffsets = provinces.getRingOffsets();
+
+  // Collect the pairs of provinces across shared edges. Consecutive edges
+  // mostly belong to the same border, so a pair is only recorded once per run
+  // of edges
+  std::vector<std::pair<ProvinceHandle, ProvinceHandle>> pairs;
+  for (ProvinceHandle province = 0; province < provinces.size(); province++) {
+    ProvinceHandle lastNeighbour = InvalidProvinceHandle;
+    for (uint32_t ring = ringOffsets[province];
+         ring < ringOffsets[province + 1]; ring++) {
+      for (ProvinceHandle neighbour : borders.getOpposites(ring)) {
+        if (neighbour == InvalidProvinceHandle || neighbour == lastNeighbour)
+          continue;
+        pairs.push_back({province, neighbour});
+        lastNeighbour = neighbour;
+      }
+    }
+  }
+
+  // Sort the pairs by province with a counting sort and drop the duplicates of
+  // provinces that share more than one edge
+  std::vector<uint32_t> counts(provinces.size() + 1, 0);
+  for (auto const& pair : pairs) counts[pair.first + 1]++;
+  for (size_t i = 1; i < counts.size(); i++) counts[i] += counts[i - 1];
+  std::vector<ProvinceHandle> sorted(pairs.size());
+  {
+    std::vector<uint32_t> next(counts.begin(), counts.end() - 1);
+    for (auto const& pair : pairs) sorted[next[pair.first]++] = pair.second;
+  }
+  std::vector<std::pair<ProvinceHandle, ProvinceHandle>>().swap(pairs);
+
+  offsets.reserve(provinces.size() + 1);
+  offsets.push_back(0);
+  for (ProvinceHandle province = 0; province < provinces.size(); province++) {
+    auto first = sorted.begin() + counts[province];
+    auto last = sorted.begin() + counts[province + 1];
+    std::sort(first, last);
+    neighbours.insert(neighbours.end(), first, std::unique(first, last));
+    offsets.push_back((uint32_t)neighbours.size());
+  }
+  neighbours.shrink_to_fit();
+}
+
+// Gets the number of provinces
+size_t AdjacencyGraph::size() const { return offsets.size() - 1; }
+
+// Gets the number of pairs of neighbouring provinces
+size_t AdjacencyGraph::getEdgeCount() const { return neighbours.size() / 2; }
+
+// Gets the neighbours of the province, sorted by handle
+ArrayView<ProvinceHandle> AdjacencyGraph::getNeighbours(
+    ProvinceHandle province) const {
+  assert(province < size());
+  return ArrayView<ProvinceHandle>(neighbours.data() + offsets[province],
+                                   offsets[province + 1] - offsets[province]);
+}
+
+// Checks if the provinces share a border
+bool AdjacencyGraph::areNeighbours(ProvinceHandle first,
+                                   ProvinceHandle second) const {
+  auto candidates = getNeighbours(first);
+  return std::binary_search(candidates.begin(), candidates.end(), second);
+}
+
+}  // namespace openhoi
@@ -0,0 +1,95 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/border_index.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+namespace openhoi {
+
+// Edge inside of the edge hash table. The points are ordered, so both provinces
+// along a border produce the same edge
+struct HashedEdge {
+  Ogre::Vector2 from;
+  Ogre::Vector2 to;
+  ProvinceHandle province;
+  uint32_t edge;
+};
+
+// Gets the bit pattern of a coordinate, where 0 and -0 are the same
+static uint64_t getBits(Ogre::Real value) {
+  static_assert(sizeof(Ogre::Real) <= sizeof(uint64_t),
+                "Coordinates must fit into 64 bits");
+  uint64_t bits = 0;
+  if (value != 0) memcpy(&bits, &value, sizeof(value));
+  return bits;
+}
+
+// Gets the hash of an edge
+static size_t hashEdge(Ogre::Vector2 const& from, Ogre::Vector2 const& to) {
+  uint64_t result = getBits(from.x);
+  for (Ogre::Real value : {from.y, to.x, to.y})
+    result = (result ^ getBits(value)) * 0x9e3779b97f4a7c15ULL;
+  return (size_t)(result ^ (result >> 32));
+}
+
+// Builds the border index of all provinces of the provided store by hashing
+// their ring edges. The build time is linear in the number of points
+BorderIndex::BorderIndex(ProvinceStore const& provinces) {
+  auto const& rings = provinces.getRings();
+  auto const& ringOffsets = provinces.getRingOffsets();
+  offsets.reserve(rings.size() + 1);
+  offsets.push_back(0);
+  for (auto const& ring : rings)
+    offsets.push_back(offsets.back() + (uint32_t)ring.size());
+  opposites.assign(offsets.back(), InvalidProvinceHandle);
+
+  // Open addressing hash table, which is at most 3/4 full, so that linear
+  // probing stays short while the table stays small enough for the cache
+  size_t slotCount = 16;
+  while (slotCount * 3 < opposites.size() * 4) slotCount <<= 1;
+  std::vector<HashedEdge> edges(
+      slotCount,
+      {Ogre::Vector2(0, 0), Ogre::Vector2(0, 0), InvalidProvinceHandle, 0});
+
+  // Insert every ring edge. Whenever an edge is already owned by another
+  // province, both edges get the other province as their opposite
+  for (ProvinceHandle province = 0; province < provinces.size(); province++) {
+    for (uint32_t ringIndex = ringOffsets[province];
+         ringIndex < ringOffsets[province + 1]; ringIndex++) {
+      auto const& ring = rings[ringIndex];
+      for (size_t i = 0, count = ring.size(); i < count; i++) {
+        Ogre::Vector2 from = ring[i];
+        Ogre::Vector2 to = ring[i + 1 < count ? i + 1 : 0];
+        if (from == to) continue;
+        if (to.x < from.x || (to.x == from.x && to.y < from.y))
+          std::swap(from, to);
+
+        size_t slot = hashEdge(from, to) & (slotCount - 1);
+        while (edges[slot].province != InvalidProvinceHandle &&
+               (edges[slot].from != from || edges[slot].to != to))
+          slot = (slot + 1) & (slotCount - 1);
+
+        HashedEdge& edge = edges[slot];
+        uint32_t index = offsets[ringIndex] + (uint32_t)i;
+        if (edge.province == InvalidProvinceHandle) {
+          edge = {from, to, province, index};
+        } else if (edge.province != province) {
+          opposites[index] = edge.province;
+          opposites[edge.edge] = province;
+        }
+      }
+    }
+  }
+}
+
+// Gets the provinces on the other side of the edges of a ring, where the ring
+// index refers to ProvinceStore::getRings()
+ArrayView<ProvinceHandle> BorderIndex::getOpposites(size_t ring) const {
+  assert(ring + 1 < offsets.size());
+  return ArrayView<ProvinceHandle>(opposites.data() + offsets[ring],
+                                   offsets[ring + 1] - offsets[ring]);
+}
+
+}  // namespace openhoi
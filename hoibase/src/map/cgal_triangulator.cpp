@@ -0,0 +1,175 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/cgal_triangulator.hpp"
+
+#include <CGAL/Constrained_Delaunay_triangulation_2.h>
+#include <CGAL/Delaunay_mesh_face_base_2.h>
+#include <CGAL/Delaunay_mesh_size_criteria_2.h>
+#include <CGAL/Delaunay_mesh_vertex_base_2.h>
+#include <CGAL/Delaunay_mesher_2.h>
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <CGAL/lloyd_optimize_mesh_2.h>
+#include <cassert>
+#include <deque>
+#include <unordered_map>
+
+// Number of Lloyd iterations of the refined+Lloyd mesh quality
+#define OPENHOI_PROVINCE_LLOYD_ITERATIONS 10
+
+namespace openhoi {
+
+typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
+typedef CGAL::Delaunay_mesh_vertex_base_2<K> Vb;
+typedef CGAL::Delaunay_mesh_face_base_2<K> Fb;
+typedef CGAL::Triangulation_data_structure_2<Vb, Fb> Tds;
+typedef CGAL::Constrained_Delaunay_triangulation_2<K, Tds,
+                                                   CGAL::Exact_predicates_tag>
+    CDT;
+typedef CGAL::Delaunay_mesh_size_criteria_2<CDT> Criteria;
+typedef CGAL::Delaunay_mesher_2<CDT, Criteria> Mesher;
+typedef CDT::Vertex_handle Vertex_handle;
+typedef CDT::Face_handle Face_handle;
+typedef CDT::Point Point;
+
+namespace {
+
+// Gets one point inside of every hole of the constrained triangulation. The
+// rings split the faces into areas, where the nesting level of an area is the
+// number of rings around it. Areas with an even nesting level are outside of
+// the province, but only the bounded ones need a seed, as CGAL never meshes
+// the unbounded area. The triangulation must be two-dimensional
+std::vector<Point> getHoleSeeds(CDT const& cdt) {
+  assert(cdt.dimension() == 2);
+  std::unordered_map<CDT::Face const*, int> levels;
+  std::deque<CDT::Edge> border;
+  std::vector<Face_handle> stack;
+
+  // Marks the area of the start face without crossing any ring and collects
+  // the ring edges around it
+  auto fill = [&](Face_handle start, int level) {
+    levels[&*start] = level;
+    stack.push_back(start);
+    while (!stack.empty()) {
+      Face_handle face = stack.back();
+      stack.pop_back();
+      for (int i = 0; i < 3; i++) {
+        Face_handle neighbour = face->neighbor(i);
+        if (levels.count(&*neighbour)) continue;
+        if (cdt.is_constrained(CDT::Edge(face, i))) {
+          border.push_back(CDT::Edge(face, i));
+        } else {
+          levels[&*neighbour] = level;
+          stack.push_back(neighbour);
+        }
+      }
+    }
+  };
+
+  // The areas are visited from the outside in, so every area is reached from
+  // the area around it first
+  std::vector<Point> seeds;
+  fill(cdt.infinite_face(), 0);
+  while (!border.empty()) {
+    CDT::Edge edge = border.front();
+    border.pop_front();
+    Face_handle face = edge.first->neighbor(edge.second);
+    if (levels.count(&*face)) continue;
+    int level = levels[&*edge.first] + 1;
+    if (level % 2 == 0)
+      seeds.push_back(CGAL::centroid(face->vertex(0)->point(),
+                                     face->vertex(1)->point(),
+                                     face->vertex(2)->point()));
+    fill(face, level);
+  }
+  return seeds;
+}
+
+}  // namespace
+
+// CGAL triangulator constructor
+CGALTriangulator::CGALTriangulator(MeshQuality quality) : quality(quality) {}
+
+// Gets the name of the triangulator, which is the name of its mesh quality
+std::string CGALTriangulator::getName() const {
+  return getMeshQualityName(quality);
+}
+
+// Gets the mesh quality of the triangulations
+MeshQuality CGALTriangulator::getMeshQuality() const { return quality; }
+
+// Triangulates the provided province rings and returns the vertices of the
+// triangles as x, y, z triples in map coordinates
+std::vector<Ogre::Real> CGALTriangulator::triangulate(
+    ArrayView<ArrayView<Ogre::Vector2>> rings) const {
+  // Create province vertex handles and insert contraints
+  CDT cdt;
+  std::vector<Vertex_handle> handles;
+  size_t handleTotal = 0;
+  for (const auto& coords : rings) {
+    // Create vertex handles
+    const size_t len = coords.size();
+    for (size_t i = 0; i < len; i++) {
+      const auto point = coords[i];
+      handles.push_back(cdt.insert(Point(point.x, point.y)));
+    }
+    // Insert constraints. Repeated points share one vertex handle and must not
+    // be connected to themselves
+    for (size_t i = handleTotal; i < handleTotal + len; i++) {
+      size_t next = i < handleTotal + len - 1 ? i + 1 : handleTotal;
+      if (handles[i] != handles[next])
+        cdt.insert_constraint(handles[i], handles[next]);
+    }
+    handleTotal += len;
+  }
+
+  // Collinear rings or rings with less than three points in total do not span
+  // any face, so there is nothing to mesh
+  if (cdt.dimension() < 2) return std::vector<Ogre::Real>();
+
+  // Rings inside of an odd number of other rings are holes. They are kept out
+  // of the domain by placing a seed into each of them
+  std::vector<Point> seeds = getHoleSeeds(cdt);
+
+  // Mark the triangles inside of the rings. Refining the mesh marks them as
+  // well, so this is only needed if the mesh is not refined
+  Mesher mesher(cdt, Criteria());
+  mesher.set_seeds(seeds.begin(), seeds.end(), false);
+  if (quality == MeshQuality::ConstrainedOnly) {
+    mesher.mark_facets();
+  } else {
+    // Mesh the domain
+    mesher.refine_mesh();
+
+    // Optimize mesh
+    if (quality == MeshQuality::RefinedLloyd)
+      CGAL::lloyd_optimize_mesh_2(
+          cdt,
+          CGAL::parameters::max_iteration_number =
+              OPENHOI_PROVINCE_LLOYD_ITERATIONS,
+          CGAL::parameters::seeds_begin = seeds.begin(),
+          CGAL::parameters::seeds_end = seeds.end(),
+          CGAL::parameters::mark = false);
+  }
+
+  // Build vertices vector from triangles
+  std::vector<Ogre::Real> vertices;
+  for (CDT::Finite_faces_iterator it = cdt.finite_faces_begin();
+       it != cdt.finite_faces_end(); ++it) {
+    // Check if the triangle is in domain which means that it is inside
+    // a province and is not a triangle connecting some province panhandles
+    // etc.
+    if (it->is_in_domain() && it->is_valid()) {
+      // Get the triangle
+      CDT::Triangle tri = cdt.triangle(it);
+      for (int i = 0; i < 3; i++) {
+        auto vertex = tri.vertex(i);
+        appendVertex(vertices, vertex.x(), vertex.y());
+      }
+    }
+  }
+
+  // Return vertices vector
+  return vertices;
+}
+
+}  // namespace openhoi
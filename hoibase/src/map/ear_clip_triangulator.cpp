@@ -0,0 +1,459 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/ear_clip_triangulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+namespace openhoi {
+
+namespace {
+
+// Vertex of the circular doubly linked list of the polygon that is clipped
+struct Node {
+  Ogre::Vector2 point;
+  uint32_t prev;
+  uint32_t next;
+};
+
+// Ring of a province without repeated points
+struct Ring {
+  std::vector<Ogre::Vector2> points;
+  double area;
+  int depth;
+};
+
+// Gets twice the signed area of the triangle abc, which is positive if the
+// triangle is counter-clockwise
+double cross(Ogre::Vector2 const& a, Ogre::Vector2 const& b,
+             Ogre::Vector2 const& c) {
+  return ((double)b.x - a.x) * ((double)c.y - a.y) -
+         ((double)b.y - a.y) * ((double)c.x - a.x);
+}
+
+// Gets twice the signed area of the ring, which is positive if the ring is
+// counter-clockwise
+double getArea(std::vector<Ogre::Vector2> const& points) {
+  double area = 0;
+  for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++)
+    area += ((double)points[j].x - points[i].x) *
+            ((double)points[j].y + points[i].y);
+  return area;
+}
+
+// Checks if the point is inside of the ring using the even-odd rule. Returns 1
+// if it is inside, 0 if it is outside and -1 if it is on the ring
+int locate(Ogre::Vector2 const& point, std::vector<Ogre::Vector2> const& ring) {
+  bool inside = false;
+  for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+    Ogre::Vector2 const& a = ring[j];
+    Ogre::Vector2 const& b = ring[i];
+    if (cross(a, b, point) == 0 && point.x >= std::min(a.x, b.x) &&
+        point.x <= std::max(a.x, b.x) && point.y >= std::min(a.y, b.y) &&
+        point.y <= std::max(a.y, b.y))
+      return -1;
+    if ((a.y > point.y) != (b.y > point.y) &&
+        point.x < a.x + (b.x - a.x) * (point.y - a.y) / (b.y - a.y))
+      inside = !inside;
+  }
+  return inside ? 1 : 0;
+}
+
+// Checks if the point is inside of the triangle abc or on its border
+bool isInTriangle(Ogre::Vector2 const& a, Ogre::Vector2 const& b,
+                  Ogre::Vector2 const& c, Ogre::Vector2 const& point) {
+  return cross(a, b, point) >= 0 && cross(b, c, point) >= 0 &&
+         cross(c, a, point) >= 0;
+}
+
+// Checks if the segments ab and cd intersect or touch
+bool intersects(Ogre::Vector2 const& a, Ogre::Vector2 const& b,
+                Ogre::Vector2 const& c, Ogre::Vector2 const& d) {
+  double d1 = cross(a, b, c), d2 = cross(a, b, d);
+  double d3 = cross(c, d, a), d4 = cross(c, d, b);
+  if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) &&
+      ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0)))
+    return true;
+  auto onSegment = [](Ogre::Vector2 const& p, Ogre::Vector2 const& q,
+                      Ogre::Vector2 const& r) {
+    return r.x >= std::min(p.x, q.x) && r.x <= std::max(p.x, q.x) &&
+           r.y >= std::min(p.y, q.y) && r.y <= std::max(p.y, q.y);
+  };
+  return (d1 == 0 && onSegment(a, b, c)) || (d2 == 0 && onSegment(a, b, d)) ||
+         (d3 == 0 && onSegment(c, d, a)) || (d4 == 0 && onSegment(c, d, b));
+}
+
+// Edge of a ring, given by the ring and the index of its first point
+struct Edge {
+  uint32_t ring;
+  uint32_t point;
+};
+
+// Checks if the rings are simple, i.e. no two edges that are not adjacent
+// intersect or touch, neither inside of one ring nor between two rings. The
+// edges are swept from left to right, so that only edges that overlap in x are
+// tested against each other
+bool isSimple(std::vector<Ring> const& rings) {
+  std::vector<std::pair<Ogre::Real, Edge>> edges;
+  for (uint32_t r = 0; r < rings.size(); r++) {
+    auto const& points = rings[r].points;
+    uint32_t count = (uint32_t)points.size();
+    for (uint32_t i = 0; i < count; i++)
+      edges.push_back(
+          {std::min(points[i].x, points[(i + 1) % count].x), {r, i}});
+  }
+  std::sort(edges.begin(), edges.end(),
+            [](std::pair<Ogre::Real, Edge> const& a,
+               std::pair<Ogre::Real, Edge> const& b) {
+              return a.first < b.first;
+            });
+
+  // Gets the start and end point of an edge
+  auto getStart = [&](Edge const& edge) -> Ogre::Vector2 const& {
+    return rings[edge.ring].points[edge.point];
+  };
+  auto getEnd = [&](Edge const& edge) -> Ogre::Vector2 const& {
+    auto const& points = rings[edge.ring].points;
+    return points[(edge.point + 1) % points.size()];
+  };
+
+  std::vector<std::pair<Ogre::Real, Edge>> active;
+  for (auto const& edge : edges) {
+    Edge const& a = edge.second;
+    uint32_t count = (uint32_t)rings[a.ring].points.size();
+    size_t kept = 0;
+    for (auto const& other : active) {
+      // Drop the edges that end left of this edge
+      if (other.first < edge.first) continue;
+      active[kept++] = other;
+      Edge const& b = other.second;
+      if (a.ring == b.ring && ((a.point + 1) % count == b.point ||
+                               (b.point + 1) % count == a.point))
+        continue;
+      if (intersects(getStart(a), getEnd(a), getStart(b), getEnd(b)))
+        return false;
+    }
+    active.resize(kept);
+    active.push_back({std::max(getStart(a).x, getEnd(a).x), a});
+  }
+  return true;
+}
+
+// Polygon that is clipped, where holes are bridged into their enclosing ring
+class Polygon {
+ public:
+  // Adds the points as new loop of the polygon and returns its first node.
+  // Outer rings have to be counter-clockwise and holes clockwise
+  uint32_t addLoop(std::vector<Ogre::Vector2> const& points) {
+    uint32_t first = (uint32_t)nodes.size();
+    uint32_t count = (uint32_t)points.size();
+    nodes.reserve(nodes.size() + count);
+    for (uint32_t i = 0; i < count; i++)
+      nodes.push_back({points[i], first + (i + count - 1) % count,
+                       first + (i + 1) % count});
+    return first;
+  }
+
+  // Gets the point of the node
+  Ogre::Vector2 const& getPoint(uint32_t node) const {
+    return nodes[node].point;
+  }
+
+  // Bridges the hole, given by its leftmost node, into the loop of the
+  // provided node. The bridge goes to the nearest node of the loop that can be
+  // seen from the hole without crossing any edge of the loop or of the
+  // provided holes that are not bridged yet. Returns false if there is no such
+  // node.
+  bool bridge(uint32_t loop, uint32_t hole,
+              std::vector<uint32_t> const& otherHoles) {
+    Ogre::Vector2 const& target = nodes[hole].point;
+    std::vector<uint32_t> candidates;
+    uint32_t node = loop;
+    do {
+      candidates.push_back(node);
+      node = nodes[node].next;
+    } while (node != loop);
+    std::sort(candidates.begin(), candidates.end(),
+              [&](uint32_t a, uint32_t b) {
+                return nodes[a].point.squaredDistance(target) <
+                       nodes[b].point.squaredDistance(target);
+              });
+
+    for (uint32_t candidate : candidates) {
+      Ogre::Vector2 const& point = nodes[candidate].point;
+      if (point == target ||
+          (isInCone(candidate, target) && isInCone(hole, point) &&
+           !crossesLoop(loop, point, target) &&
+           !crossesLoop(hole, point, target) &&
+           std::none_of(otherHoles.begin(), otherHoles.end(),
+                        [&](uint32_t other) {
+                          return crossesLoop(other, point, target);
+                        }))) {
+        split(candidate, hole);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Clips the ears off the loop of the provided node and appends the
+  // triangles to the vertices. Returns false if the loop can not be clipped
+  bool clip(uint32_t node, std::vector<Ogre::Real>& vertices) {
+    size_t count = 1;
+    for (uint32_t i = nodes[node].next; i != node; i = nodes[i].next) count++;
+
+    uint32_t stop = node;
+    while (count > 3) {
+      uint32_t prev = nodes[node].prev, next = nodes[node].next;
+      double area = cross(nodes[prev].point, nodes[node].point,
+                          nodes[next].point);
+      if (area == 0) {
+        // Drop collinear and repeated points, they never form an ear
+        remove(node);
+        count--;
+        node = stop = prev;
+      } else if (area > 0 && isEar(prev, node, next)) {
+        appendTriangle(vertices, prev, node, next);
+        remove(node);
+        count--;
+
+        // Skipping the next node avoids clipping thin fans off one point
+        node = stop = nodes[next].next;
+      } else {
+        node = next;
+        if (node == stop) return false;
+      }
+    }
+
+    uint32_t prev = nodes[node].prev, next = nodes[node].next;
+    if (cross(nodes[prev].point, nodes[node].point, nodes[next].point) > 0)
+      appendTriangle(vertices, prev, node, next);
+    return true;
+  }
+
+ private:
+  // Checks if the point is inside of the corner of the polygon at the node
+  bool isInCone(uint32_t node, Ogre::Vector2 const& point) const {
+    Ogre::Vector2 const& prev = nodes[nodes[node].prev].point;
+    Ogre::Vector2 const& current = nodes[node].point;
+    Ogre::Vector2 const& next = nodes[nodes[node].next].point;
+    if (cross(prev, current, next) >= 0)
+      return cross(prev, current, point) > 0 && cross(current, next, point) > 0;
+    return cross(prev, current, point) > 0 || cross(current, next, point) > 0;
+  }
+
+  // Checks if the segment ab crosses or touches any edge of the loop of the
+  // provided node, ignoring the edges that end in a or b
+  bool crossesLoop(uint32_t loop, Ogre::Vector2 const& a,
+                   Ogre::Vector2 const& b) const {
+    uint32_t node = loop;
+    do {
+      Ogre::Vector2 const& c = nodes[node].point;
+      Ogre::Vector2 const& d = nodes[nodes[node].next].point;
+      if (c != a && c != b && d != a && d != b && intersects(a, b, c, d))
+        return true;
+      node = nodes[node].next;
+    } while (node != loop);
+    return false;
+  }
+
+  // Checks if the triangle at the provided nodes is an ear, i.e. no other
+  // point of the polygon is inside of it. Only reflex points can be inside of
+  // a triangle of a simple polygon, so convex points are skipped
+  bool isEar(uint32_t prev, uint32_t node, uint32_t next) const {
+    Ogre::Vector2 const& a = nodes[prev].point;
+    Ogre::Vector2 const& b = nodes[node].point;
+    Ogre::Vector2 const& c = nodes[next].point;
+    Ogre::Real minX = std::min({a.x, b.x, c.x});
+    Ogre::Real minY = std::min({a.y, b.y, c.y});
+    Ogre::Real maxX = std::max({a.x, b.x, c.x});
+    Ogre::Real maxY = std::max({a.y, b.y, c.y});
+    for (uint32_t i = nodes[next].next; i != prev; i = nodes[i].next) {
+      Ogre::Vector2 const& point = nodes[i].point;
+      if (point.x < minX || point.x > maxX || point.y < minY ||
+          point.y > maxY || point == a || point == b || point == c)
+        continue;
+      if (isInTriangle(a, b, c, point) &&
+          cross(nodes[nodes[i].prev].point, point,
+                nodes[nodes[i].next].point) <= 0)
+        return false;
+    }
+    return true;
+  }
+
+  // Connects the nodes a and b with two opposite edges, duplicating both of
+  // them, so that their loops become one loop
+  void split(uint32_t a, uint32_t b) {
+    uint32_t a2 = (uint32_t)nodes.size();
+    uint32_t b2 = a2 + 1;
+    uint32_t an = nodes[a].next;
+    uint32_t bp = nodes[b].prev;
+    nodes.push_back({nodes[a].point, b2, an});
+    nodes.push_back({nodes[b].point, bp, a2});
+    nodes[a].next = b;
+    nodes[b].prev = a;
+    nodes[an].prev = a2;
+    nodes[bp].next = b2;
+  }
+
+  // Unlinks the node from its loop
+  void remove(uint32_t node) {
+    nodes[nodes[node].prev].next = nodes[node].next;
+    nodes[nodes[node].next].prev = nodes[node].prev;
+  }
+
+  // Appends the triangle at the provided nodes to the vertices
+  void appendTriangle(std::vector<Ogre::Real>& vertices, uint32_t a,
+                      uint32_t b, uint32_t c) const {
+    for (uint32_t node : {a, b, c})
+      Triangulator::appendVertex(vertices, nodes[node].point.x,
+                                 nodes[node].point.y);
+  }
+
+  std::vector<Node> nodes;
+};
+
+}  // namespace
+
+// Ear clipping triangulator constructor. The provided mesh quality is used by
+// the CGAL fallback
+EarClipTriangulator::EarClipTriangulator(MeshQuality fallbackQuality)
+    : fallback(fallbackQuality) {}
+
+// Gets the name of the triangulator
+std::string EarClipTriangulator::getName() const {
+  return "ear-clipping-" + fallback.getName();
+}
+
+// Gets the mesh quality of the triangulations, which is the one of the
+// fallback
+MeshQuality EarClipTriangulator::getMeshQuality() const {
+  return fallback.getMeshQuality();
+}
+
+// Triangulates the provided province rings and returns the vertices of the
+// triangles as x, y, z triples in map coordinates
+std::vector<Ogre::Real> EarClipTriangulator::triangulate(
+    ArrayView<ArrayView<Ogre::Vector2>> rings) const {
+  std::vector<Ogre::Real> vertices;
+  if (clip(rings, vertices)) return vertices;
+  return fallback.triangulate(rings);
+}
+
+// Triangulates the provided province rings by ear clipping only and appends
+// the triangles to the vertices. Returns false and leaves the vertices
+// untouched in case a ring intersects itself or another ring or can not be
+// clipped
+bool EarClipTriangulator::clip(ArrayView<ArrayView<Ogre::Vector2>> rings,
+                               std::vector<Ogre::Real>& vertices) {
+  // Drop repeated points and degenerated rings, then hand rings that intersect
+  // themselves or each other over to the fallback
+  std::vector<Ring> simpleRings;
+  for (auto const& ring : rings) {
+    Ring simpleRing;
+    simpleRing.points.reserve(ring.size());
+    for (auto const& point : ring) {
+      if (simpleRing.points.empty() || simpleRing.points.back() != point)
+        simpleRing.points.push_back(point);
+    }
+    while (simpleRing.points.size() > 1 &&
+           simpleRing.points.back() == simpleRing.points.front())
+      simpleRing.points.pop_back();
+    if (simpleRing.points.size() < 3) continue;
+    simpleRing.area = getArea(simpleRing.points);
+    simpleRings.push_back(std::move(simpleRing));
+  }
+  if (!isSimple(simpleRings)) return false;
+  simpleRings.erase(
+      std::remove_if(simpleRings.begin(), simpleRings.end(),
+                     [](Ring const& ring) { return ring.area == 0; }),
+      simpleRings.end());
+
+  // The nesting depth of a ring is the number of rings it is inside of. Rings
+  // with an odd depth are holes of the smallest ring around them
+  for (size_t i = 0; i < simpleRings.size(); i++) {
+    simpleRings[i].depth = 0;
+    for (size_t j = 0; j < simpleRings.size(); j++) {
+      if (i == j) continue;
+      for (auto const& point : simpleRings[i].points) {
+        int location = locate(point, simpleRings[j].points);
+        if (location < 0) continue;
+        simpleRings[i].depth += location;
+        break;
+      }
+    }
+  }
+  for (auto& ring : simpleRings) {
+    // Make outer rings counter-clockwise and holes clockwise
+    if ((ring.depth % 2 == 0) != (ring.area > 0)) {
+      std::reverse(ring.points.begin(), ring.points.end());
+      ring.area = -ring.area;
+    }
+  }
+  std::vector<std::vector<size_t>> holes(simpleRings.size());
+  for (size_t i = 0; i < simpleRings.size(); i++) {
+    if (simpleRings[i].depth % 2 == 0) continue;
+    size_t parent = simpleRings.size();
+    for (size_t j = 0; j < simpleRings.size(); j++) {
+      if (simpleRings[j].depth != simpleRings[i].depth - 1 ||
+          locate(simpleRings[i].points.front(), simpleRings[j].points) == 0)
+        continue;
+      if (parent == simpleRings.size() ||
+          std::abs(simpleRings[j].area) < std::abs(simpleRings[parent].area))
+        parent = j;
+    }
+    if (parent == simpleRings.size()) return false;
+    holes[parent].push_back(i);
+  }
+
+  // Clip every outer ring together with its holes. A polygon with n points
+  // and h holes results in n + 2h - 2 triangles
+  size_t start = vertices.size();
+  size_t triangleCount = 0;
+  for (auto const& ring : simpleRings)
+    triangleCount += ring.points.size() + (ring.depth % 2 == 0 ? 0 : 2);
+  vertices.reserve(vertices.size() + triangleCount * 9);
+  for (size_t i = 0; i < simpleRings.size(); i++) {
+    if (simpleRings[i].depth % 2 != 0) continue;
+    Polygon polygon;
+    uint32_t loop = polygon.addLoop(simpleRings[i].points);
+
+    // Bridge the holes from left to right, starting at their leftmost point
+    std::vector<uint32_t> holeNodes;
+    for (size_t hole : holes[i]) {
+      auto const& points = simpleRings[hole].points;
+      auto leftmost =
+          std::min_element(points.begin(), points.end(),
+                           [](Ogre::Vector2 const& a, Ogre::Vector2 const& b) {
+                             return a.x < b.x || (a.x == b.x && a.y < b.y);
+                           });
+      holeNodes.push_back(polygon.addLoop(points) +
+                          (uint32_t)std::distance(points.begin(), leftmost));
+    }
+    std::vector<uint32_t> order(holeNodes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+      return polygon.getPoint(holeNodes[a]).x <
+             polygon.getPoint(holeNodes[b]).x;
+    });
+    for (size_t j = 0; j < order.size(); j++) {
+      std::vector<uint32_t> remaining;
+      for (size_t k = j + 1; k < order.size(); k++)
+        remaining.push_back(holeNodes[order[k]]);
+      if (!polygon.bridge(loop, holeNodes[order[j]], remaining)) {
+        vertices.resize(start);
+        return false;
+      }
+    }
+
+    if (!polygon.clip(loop, vertices)) {
+      vertices.resize(start);
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace openhoi
@@ -0,0 +1,285 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/geojson_handler.hpp"
+
+namespace openhoi {
+
+// GeoJSON handler constructor
+GeoJSONHandler::GeoJSONHandler(std::function<void(Province)> const& callback)
+    : callback(callback), hasFeatures(false), error(nullptr) {}
+
+// Checks if the whole feature collection has been read successfully. If not,
+// the error message is set
+bool GeoJSONHandler::finish() {
+  if (error) return false;
+  if (rootType != "FeatureCollection") {
+    error = "Invalid map file (root type is not FeatureCollection)";
+    return false;
+  }
+  if (!hasFeatures) {
+    error = "Invalid map file (no features found)";
+    return false;
+  }
+  return true;
+}
+
+// Gets the error message of the last failed check
+char const* GeoJSONHandler::getError() const { return error; }
+
+// Handles a null value
+bool GeoJSONHandler::Null() { return value(nullptr, false, 0); }
+
+// Handles a boolean value
+bool GeoJSONHandler::Bool(bool) { return value(nullptr, false, 0); }
+
+// Handles an integer value
+bool GeoJSONHandler::Int(int) { return value(nullptr, false, 0); }
+
+// Handles an unsigned integer value
+bool GeoJSONHandler::Uint(unsigned) { return value(nullptr, false, 0); }
+
+// Handles a 64 bit integer value
+bool GeoJSONHandler::Int64(int64_t) { return value(nullptr, false, 0); }
+
+// Handles an unsigned 64 bit integer value
+bool GeoJSONHandler::Uint64(uint64_t) { return value(nullptr, false, 0); }
+
+// Handles a floating point value
+bool GeoJSONHandler::Double(double number) {
+  return value(nullptr, true, number);
+}
+
+// Handles a raw number, which is only reported if numbers are parsed as
+// strings
+bool GeoJSONHandler::RawNumber(char const*, rapidjson::SizeType, bool) {
+  return value(nullptr, false, 0);
+}
+
+// Handles a string value
+bool GeoJSONHandler::String(char const* value, rapidjson::SizeType length,
+                            bool) {
+  std::string string(value, length);
+  return this->value(&string, false, 0);
+}
+
+// Handles the start of an object
+bool GeoJSONHandler::StartObject() {
+  if (!frames.empty() && frames.back().scope == Scope::Root &&
+      key == "features") {
+    error = "Invalid map file (features must be an array)";
+    return false;
+  }
+  push(false);
+  return true;
+}
+
+// Handles the key of an object member
+bool GeoJSONHandler::Key(char const* value, rapidjson::SizeType length, bool) {
+  key.assign(value, length);
+  return true;
+}
+
+// Handles the end of an object
+bool GeoJSONHandler::EndObject(rapidjson::SizeType) {
+  Scope scope = frames.back().scope;
+  frames.pop_back();
+  if (scope == Scope::Feature) endFeature();
+  return true;
+}
+
+// Handles the start of an array
+bool GeoJSONHandler::StartArray() {
+  if (frames.empty()) {
+    error = "Invalid map file (root object is array)";
+    return false;
+  }
+  push(true);
+  return true;
+}
+
+// Handles the end of an array
+bool GeoJSONHandler::EndArray(rapidjson::SizeType) {
+  Frame frame = std::move(frames.back());
+  frames.pop_back();
+  if (frame.scope == Scope::Coordinates) endCoordinates(frame);
+  return true;
+}
+
+// Pushes a new object or array onto the frame stack
+void GeoJSONHandler::push(bool array) {
+  Frame frame = {Scope::Other, array, 0, 0, false, false, Ogre::Vector2(0, 0),
+                 {},           false};
+
+  if (frames.empty()) {
+    frame.scope = Scope::Root;
+  } else {
+    Frame& parent = frames.back();
+    switch (parent.scope) {
+      case Scope::Root:
+        if (array && key == "features") {
+          frame.scope = Scope::Features;
+          hasFeatures = true;
+        }
+        break;
+      case Scope::Features:
+        if (!array) {
+          frame.scope = Scope::Feature;
+          feature.type.clear();
+          feature.hasProperties = false;
+          feature.name.clear();
+          feature.propertiesType.clear();
+          feature.hasGeometry = false;
+          feature.geometryType.clear();
+          feature.hasCoordinates = false;
+          feature.lineString.clear();
+          feature.multiPolygon.clear();
+        }
+        break;
+      case Scope::Feature:
+        if (!array && key == "properties") {
+          frame.scope = Scope::Properties;
+          feature.hasProperties = true;
+        } else if (!array && key == "geometry") {
+          frame.scope = Scope::Geometry;
+          feature.hasGeometry = true;
+        }
+        break;
+      case Scope::Geometry:
+        if (array && key == "coordinates") {
+          frame.scope = Scope::Coordinates;
+          frame.level = 1;
+          feature.hasCoordinates = true;
+        }
+        break;
+      case Scope::Coordinates:
+        // Nested arrays and objects are elements of the parent array. Whether
+        // a nested array is a point is only known once it has been closed
+        parent.elements++;
+        parent.lastIsPoint = false;
+        if (parent.elements == 1) parent.firstIsDouble = false;
+        if (parent.elements == 2) parent.secondIsDouble = false;
+        if (array) {
+          frame.scope = Scope::Coordinates;
+          frame.level = parent.level + 1;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  frames.push_back(std::move(frame));
+}
+
+// Handles a scalar value at the current position
+bool GeoJSONHandler::value(std::string const* string, bool isDouble,
+                           double number) {
+  Frame& frame = frames.back();
+  switch (frame.scope) {
+    case Scope::Root:
+      if (key == "type") {
+        if (!string || *string != "FeatureCollection") {
+          error = "Invalid map file (root type is not FeatureCollection)";
+          return false;
+        }
+        rootType = *string;
+      } else if (key == "features") {
+        error = "Invalid map file (features must be an array)";
+        return false;
+      }
+      break;
+    case Scope::Feature:
+      if (string && key == "type") feature.type = *string;
+      break;
+    case Scope::Properties:
+      if (string && key == "name")
+        feature.name = *string;
+      else if (string && key == "type")
+        feature.propertiesType = *string;
+      break;
+    case Scope::Geometry:
+      if (string && key == "type") feature.geometryType = *string;
+      break;
+    case Scope::Coordinates:
+      frame.elements++;
+      frame.lastIsPoint = false;
+      if (frame.elements == 1) {
+        frame.firstIsDouble = isDouble;
+        frame.point.x = (Ogre::Real)number;
+      } else if (frame.elements == 2) {
+        frame.secondIsDouble = isDouble;
+        frame.point.y = (Ogre::Real)number;
+      }
+      break;
+    default:
+      break;
+  }
+  return true;
+}
+
+// Handles the end of an array inside of the coordinates
+void GeoJSONHandler::endCoordinates(Frame& frame) {
+  // Report the array to its parent array, which keeps it if it is a point
+  Frame& parent = frames.back();
+  if (parent.scope == Scope::Coordinates && frame.elements > 1 &&
+      frame.firstIsDouble && frame.secondIsDouble) {
+    parent.ring.push_back(frame.point);
+    parent.lastIsPoint = true;
+  }
+
+  // Always drop the last element of the ring, as it is the closing point, like
+  // the document parser does. Only if it was a point it has been added to the
+  // ring. A line string is the coordinates array itself, while the rings of a
+  // multi polygon are nested in polygons
+  std::vector<Ogre::Vector2> ring = std::move(frame.ring);
+  if (frame.lastIsPoint) ring.pop_back();
+  if (frame.level == 1)
+    feature.lineString = std::move(ring);
+  else if (frame.level == 3 && !ring.empty())
+    feature.multiPolygon.push_back(std::move(ring));
+}
+
+// Builds the province out of the feature that has just been read
+void GeoJSONHandler::endFeature() {
+  // Check if type is Feature
+  if (feature.type != "Feature") {
+    // TOOD: Log
+    return;
+  }
+
+  // Check for properties and the province ID out of name field
+  if (!feature.hasProperties || feature.name.empty()) {
+    // TOOD: Log
+    return;
+  } else if (importedIds.find(feature.name) != importedIds.end()) {
+    // TOOD: Log
+    return;
+  }
+  importedIds.insert(feature.name);
+
+  // Check for geometry and its type
+  bool multipolygon = feature.propertiesType == "multipolygon";
+  if (!feature.hasGeometry || !feature.hasCoordinates ||
+      feature.geometryType != (multipolygon ? "MultiPolygon" : "LineString")) {
+    // TOOD: Log
+    return;
+  }
+
+  // Get geometry coordinates
+  std::vector<std::vector<Ogre::Vector2>> coordinates;
+  if (!multipolygon) {
+    if (!feature.lineString.empty())
+      coordinates.push_back(std::move(feature.lineString));
+  } else {
+    coordinates = std::move(feature.multiPolygon);
+  }
+
+  if (!coordinates.empty()) {
+    // Build province and hand it over. The center is computed in one parallel
+    // pass once all provinces were read
+    callback(
+        Province(feature.name, std::move(coordinates), Ogre::Vector2(0, 0)));
+  }
+}
+
+}  // namespace openhoi
@@ -0,0 +1,112 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/indexed_mesh.hpp"
+
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+
+namespace openhoi {
+
+// Hashes vertices by their coordinates
+struct VertexHash {
+  size_t operator()(Ogre::Vector2 const& vertex) const {
+    return std::hash<Ogre::Real>()(vertex.x) * 31 +
+           std::hash<Ogre::Real>()(vertex.y);
+  }
+};
+
+// Empty indexed mesh constructor
+IndexedMesh::IndexedMesh() {}
+
+// Indexed mesh constructor for 16 bit wide indices. The mesh must have at most
+// 65536 vertices
+IndexedMesh::IndexedMesh(std::vector<Ogre::Vector2> vertices,
+                         std::vector<uint16_t> indices)
+    : vertices(std::move(vertices)), indices16(std::move(indices)) {
+  assert(this->vertices.size() <= std::numeric_limits<uint16_t>::max() + 1u);
+}
+
+// Indexed mesh constructor for 32 bit wide indices. They are narrowed to 16 bit
+// if the mesh has at most 65536 vertices
+IndexedMesh::IndexedMesh(std::vector<Ogre::Vector2> vertices,
+                         std::vector<uint32_t> indices)
+    : vertices(std::move(vertices)) {
+  if (this->vertices.size() <= std::numeric_limits<uint16_t>::max() + 1u)
+    indices16.assign(indices.begin(), indices.end());
+  else
+    indices32 = std::move(indices);
+}
+
+// Builds an indexed mesh out of a triangle list with x, y, z triples per
+// vertex, as returned by the province triangulation. Vertices with the same x
+// and y coordinates are merged, z is dropped
+IndexedMesh IndexedMesh::fromTriangles(ArrayView<Ogre::Real> triangles) {
+  size_t count = triangles.size() / 3;
+  std::vector<Ogre::Vector2> vertices;
+  std::vector<uint32_t> indices;
+  indices.reserve(count);
+  std::unordered_map<Ogre::Vector2, uint32_t, VertexHash> merged;
+  merged.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    Ogre::Vector2 vertex(triangles[i * 3], triangles[i * 3 + 1]);
+    auto result = merged.insert({vertex, (uint32_t)vertices.size()});
+    if (result.second) vertices.push_back(vertex);
+    indices.push_back(result.first->second);
+  }
+
+  // Use the narrowest index type that fits
+  return IndexedMesh(std::move(vertices), std::move(indices));
+}
+
+// Gets the unique vertices
+std::vector<Ogre::Vector2> const& IndexedMesh::getVertices() const {
+  return vertices;
+}
+
+// Gets the number of indices
+size_t IndexedMesh::getIndexCount() const {
+  return hasWideIndices() ? indices32.size() : indices16.size();
+}
+
+// Gets the index at the provided position
+uint32_t IndexedMesh::getIndex(size_t position) const {
+  assert(position < getIndexCount());
+  return hasWideIndices() ? indices32[position] : indices16[position];
+}
+
+// Checks if the indices are 32 bit wide
+bool IndexedMesh::hasWideIndices() const { return !indices32.empty(); }
+
+// Gets the indices if they are 16 bit wide
+std::vector<uint16_t> const& IndexedMesh::getIndices16() const {
+  return indices16;
+}
+
+// Gets the indices if they are 32 bit wide
+std::vector<uint32_t> const& IndexedMesh::getIndices32() const {
+  return indices32;
+}
+
+// Gets the number of bytes of the vertices and indices
+size_t IndexedMesh::getMemorySize() const {
+  return vertices.size() * sizeof(Ogre::Vector2) +
+         indices16.size() * sizeof(uint16_t) +
+         indices32.size() * sizeof(uint32_t);
+}
+
+// Expands the mesh back into a triangle list with x, y, z triples per vertex
+std::vector<Ogre::Real> IndexedMesh::toTriangles() const {
+  std::vector<Ogre::Real> triangles;
+  triangles.reserve(getIndexCount() * 3);
+  for (size_t i = 0; i < getIndexCount(); i++) {
+    auto const& vertex = vertices[getIndex(i)];
+    triangles.push_back(vertex.x);
+    triangles.push_back(vertex.y);
+    triangles.push_back(0);
+  }
+  return triangles;
+}
+
+}  // namespace openhoi
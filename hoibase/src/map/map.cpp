@@ -3,27 +3,102 @@
 #include "hoibase/map/map.hpp"
 
 #include <cassert>
+#include <cmath>
 
 namespace openhoi {
 
 // Map constructor
 Map::Map(int radius) { this->radius = radius; }
 
-// Add province to map
-void Map::addProvince(Province province) {
+// Add province to map and returns its handle
+ProvinceHandle Map::addProvince(Province province) {
   // Check for duplicate provinces
-  assert(provinces.find(province.getID()) == provinces.end());
+  assert(provinces.find(province.getID()) == InvalidProvinceHandle);
 
-  // Add the province
-  provinces.insert({province.getID(), province});
+  // Add the province. Its coordinates are copied into the arena of the province
+  // store
+  auto const& coordinates = province.getCoordinates();
+  std::vector<ArrayView<Ogre::Vector2>> rings(coordinates.begin(),
+                                              coordinates.end());
+  invalidateIndices();
+  return provinces.add(province.getID(), rings, province.getCenter());
 }
 
 // Gets the map's provinces
-std::unordered_map<std::string, Province> const& Map::getProvinces() const {
-  return provinces;
+ProvinceStore const& Map::getProvinces() const { return provinces; }
+
+// Gets the map's provinces for modification. Whoever adds provinces or changes
+// their rings through it has to call invalidateIndices() afterwards
+ProvinceStore& Map::getProvinces() { return provinces; }
+
+// Drops the spatial index, the adjacency graph and the levels of detail, so
+// they are rebuilt on next access. References to them that were handed out
+// before become invalid
+void Map::invalidateIndices() {
+  std::lock_guard<std::mutex> lock(indexMutex);
+  spatialIndex.reset();
+  adjacencyGraph.reset();
+  lod.reset();
+}
+
+// Gets the handle of the province with the provided ID or
+// InvalidProvinceHandle if it does not exist
+ProvinceHandle Map::getProvinceHandle(std::string const& id) const {
+  return provinces.find(id);
+}
+
+// Gets the spatial index over all provinces. The index is built on first access
+// and rebuilt after provinces were added
+SpatialIndex const& Map::getSpatialIndex() const {
+  std::lock_guard<std::mutex> lock(indexMutex);
+  if (!spatialIndex) spatialIndex = std::make_unique<SpatialIndex>(provinces);
+  return *spatialIndex;
+}
+
+// Gets the province under the provided point or InvalidProvinceHandle if there
+// is none
+ProvinceHandle Map::getProvinceAt(Ogre::Vector2 const& point) const {
+  return getSpatialIndex().pick(point);
+}
+
+// Gets all provinces whose bounding box intersects the provided rectangle
+std::vector<ProvinceHandle> Map::getProvincesIn(
+    Ogre::Vector2 const& min, Ogre::Vector2 const& max) const {
+  return getSpatialIndex().query(min, max);
+}
+
+// Gets the adjacency graph of all provinces. The graph is built on first access
+// and rebuilt after provinces were added
+AdjacencyGraph const& Map::getAdjacencyGraph() const {
+  std::lock_guard<std::mutex> lock(indexMutex);
+  if (!adjacencyGraph)
+    adjacencyGraph = std::make_unique<AdjacencyGraph>(provinces);
+  return *adjacencyGraph;
+}
+
+// Gets the provinces that share a border with the province
+ArrayView<ProvinceHandle> Map::getNeighbours(ProvinceHandle province) const {
+  return getAdjacencyGraph().getNeighbours(province);
+}
+
+// Gets the simplified province outlines for all levels of detail. They are
+// built on first access and rebuilt after provinces were added
+MapLOD const& Map::getLOD() const {
+  std::lock_guard<std::mutex> lock(indexMutex);
+  if (!lod) {
+    // The tolerances scale with the size of the map
+    if (!spatialIndex) spatialIndex = std::make_unique<SpatialIndex>(provinces);
+    BoundingBox const& bounds = spatialIndex->getBounds();
+    Ogre::Real width = bounds.max.x - bounds.min.x;
+    Ogre::Real height = bounds.max.y - bounds.min.y;
+    lod = std::make_unique<MapLOD>(
+        provinces, MapLOD::getDefaultTolerances(
+                       std::sqrt(width * width + height * height)));
+  }
+  return *lod;
 }
 
 // Gets the map's radius
 int const& Map::getRadius() const { return radius; }
 
-}  // namespace openhoi
\ No newline at end of file
+}  // namespace openhoi
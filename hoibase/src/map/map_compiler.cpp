@@ -0,0 +1,82 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/map_compiler.hpp"
+
+#include <cstring>
+#include <memory>
+
+#include "hoibase/file/file_access.hpp"
+#include "hoibase/map/compiled_map_format.hpp"
+
+namespace openhoi {
+
+// Writes the provided map as compiled map file (see compiled_map_format.hpp)
+// that can be loaded with MapFactory::loadMap. Returns false in case the file
+// could not be written.
+bool MapCompiler::compile(Map const& map, filesystem::path file) {
+  // The provinces are written in handle order, so the compiled map loads back
+  // into the same handles. The ring offsets of the province store are already
+  // laid out the way the compiled map expects them
+  ProvinceStore const& provinces = map.getProvinces();
+  std::vector<uint32_t> const& ringOffsets = provinces.getRingOffsets();
+
+  // Build the tables
+  std::vector<CompiledMapProvince> provinceTable;
+  std::vector<uint32_t> rings;
+  std::vector<float> coordinates;
+  std::string stringPool;
+  provinceTable.reserve(provinces.size());
+  for (ProvinceHandle i = 0; i < provinces.size(); i++) {
+    CompiledMapProvince entry;
+    entry.idOffset = (uint32_t)stringPool.size();
+    entry.idLength = (uint32_t)provinces.getID(i).size();
+    entry.firstRing = ringOffsets[i];
+    entry.ringCount = ringOffsets[i + 1] - ringOffsets[i];
+    entry.centerX = (float)provinces.getCenter(i).x;
+    entry.centerY = (float)provinces.getCenter(i).y;
+    provinceTable.push_back(entry);
+    stringPool += provinces.getID(i);
+  }
+  rings.reserve(provinces.getRings().size() + 1);
+  coordinates.reserve(provinces.getPointCount() * 2);
+  for (auto const& ring : provinces.getRings()) {
+    rings.push_back((uint32_t)(coordinates.size() / 2));
+    for (auto const& coordinate : ring) {
+      coordinates.push_back((float)coordinate.x);
+      coordinates.push_back((float)coordinate.y);
+    }
+  }
+  rings.push_back((uint32_t)(coordinates.size() / 2));
+
+  // Build the header
+  CompiledMapHeader header;
+  memcpy(header.magic, OPENHOI_COMPILED_MAP_MAGIC, sizeof(header.magic));
+  header.version = OPENHOI_COMPILED_MAP_VERSION;
+  header.radius = (int32_t)map.getRadius();
+  header.provinceCount = (uint32_t)provinceTable.size();
+  header.ringCount = (uint32_t)rings.size() - 1;
+  header.coordinateCount = (uint32_t)(coordinates.size() / 2);
+  header.stringPoolSize = (uint32_t)stringPool.size();
+  header.reserved = 0;
+
+  // Write the file
+  auto closeFile = [](FILE* f) { fclose(f); };
+  auto holder = std::unique_ptr<FILE, decltype(closeFile)>(
+      FileAccess::fopen(file, "wb"), closeFile);
+  if (!holder) return false;
+  FILE* fp = holder.get();
+
+  bool ok = true;
+  auto write = [&](void const* data, size_t length) {
+    if (ok && length > 0) ok = fwrite(data, 1, length, fp) == length;
+  };
+  write(&header, sizeof(header));
+  write(provinceTable.data(),
+        provinceTable.size() * sizeof(CompiledMapProvince));
+  write(rings.data(), rings.size() * sizeof(uint32_t));
+  write(coordinates.data(), coordinates.size() * sizeof(float));
+  write(stringPool.data(), stringPool.size());
+  return ok;
+}
+
+}  // namespace openhoi
@@ -3,27 +3,100 @@
 #include "hoibase/map/map_factory.hpp"
 
 #include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
 #include <cassert>
+#include <cstring>
+#include <rapidjson/memorystream.h>
+#include <stdexcept>
 #include <unordered_set>
 
+#include "hoibase/file/mapped_file.hpp"
+#include "hoibase/map/cgal_triangulator.hpp"
+#include "hoibase/map/compiled_map_format.hpp"
+#include "hoibase/map/geojson_handler.hpp"
+#include "hoibase/map/map_mesh_cache.hpp"
+#include "hoibase/map/map_triangulator.hpp"
+#include "hoibase/map/province_center.hpp"
+
 namespace openhoi {
 
-// Loads the map file and returns the map data
-std::unique_ptr<Map> MapFactory::loadMap(std::string path) {
+// Loads the map file and returns the map data. The map file can either be a
+// GeoJSON file or a compiled map file. The provinces are triangulated with the
+// provided mesh quality
+std::unique_ptr<Map> MapFactory::loadMap(std::string path,
+                                         MeshQuality meshQuality) {
+  return loadMap(std::move(path),
+                 std::make_shared<CGALTriangulator>(meshQuality));
+}
+
+// Loads the map file and returns the map data. The map file can either be a
+// GeoJSON file or a compiled map file. The provinces are triangulated with the
+// provided triangulator
+std::unique_ptr<Map> MapFactory::loadMap(
+    std::string path, std::shared_ptr<Triangulator const> triangulator) {
+  // Map the map file into memory. It is hashed and parsed front to back
+  MappedFile file(filesystem::u8path(path), MappedFileAccess::Sequential);
+  if (!file.isOpen())
+    throw std::runtime_error(
+        (boost::format("Unable to read map file '%s'") % path).str());
+
+  // Compute the mesh cache key out of the map file content. Every triangulator
+  // has its own cache entry
+  std::string cacheKey =
+      MapMeshCache::computeKey(file.getData(), file.getSize()) + "-" +
+      triangulator->getName();
+
+  // Parse the map file
+  std::unique_ptr<Map> map = parseMap(file.getData(), file.getSize());
+
+  // Select the triangulator before any province gets triangulated
+  map->getProvinces().setTriangulator(std::move(triangulator));
+
+  // Restore the province meshes and centers from the cache. If this is not
+  // possible, compute the centers and triangulate all provinces and store them
+  // in the cache for the next start. Compiled maps already carry the centers
+  if (!MapMeshCache::load(cacheKey, *map)) {
+    if (!isCompiledMap(file.getData(), file.getSize()))
+      ProvinceCenter::computeCenters(map->getProvinces());
+    MapTriangulator::triangulateProvinces(*map);
+    MapMeshCache::save(cacheKey, *map);
+  }
+
+  // Build the spatial index, the adjacency graph and the levels of detail up
+  // front, so that the first pick, neighbour lookup or frame does not stall
+  map->getSpatialIndex();
+  map->getAdjacencyGraph();
+  map->getLOD();
+
+  // Return map
+  return map;
+}
+
+// Parses the provided map data, which can either be GeoJSON or a compiled map,
+// and returns the map data. The provinces are not triangulated
+std::unique_ptr<Map> MapFactory::parseMap(unsigned char const* data,
+                                          size_t size) {
+  if (isCompiledMap(data, size)) return parseCompiledMap(data, size);
+  return streamGeoJSON(reinterpret_cast<const char*>(data), size);
+}
+
+// Checks if the provided data is a compiled map
+bool MapFactory::isCompiledMap(unsigned char const* data, size_t size) {
+  return size >= sizeof(CompiledMapHeader) &&
+         memcmp(data, OPENHOI_COMPILED_MAP_MAGIC, 4) == 0;
+}
+
+// Parses the provided GeoJSON data into a document tree and returns the map
+// data. The provinces are not triangulated
+std::unique_ptr<Map> MapFactory::parseGeoJSON(char const* data, size_t size) {
   // Generate map object
   std::unique_ptr<Map> map =
       std::make_unique<Map>(6378137 /* TODO: Add to feature collection */);
 
-  // Load map file
-  const Map* mapFile = NULL;  // TODO: Get from resource manager!
-
   // Open GeoJSON map file
   rapidjson::Document doc;
-  /*
-  if (doc.Parse(reinterpret_cast<const char*>(mapFile->getBytes()),
-  mapFile->getSize()) .HasParseError()) throw "Unable to parse map file";  //
-  TODO: Proper error handling!
-  */ // TODO: Remove comment!
+  if (doc.Parse(data, size).HasParseError())
+    throw "Unable to parse map file";  // TODO: Proper error handling!
 
   // Ensure that document is not an array
   if (!doc.IsObject())
@@ -133,10 +206,10 @@ std::unique_ptr<Map> MapFactory::loadMap(std::string path) {
     }
 
     if (!coordinates.empty()) {
-      // Build province and add it to map
-      Province province(id, coordinates,
-                        Ogre::Vector2(0, 0));  // TODO: Center point
-      map->addProvince(province);
+      // Build province and add it to map. The center is computed in one
+      // parallel pass once all provinces were read
+      Province province(id, std::move(coordinates), Ogre::Vector2(0, 0));
+      map->addProvince(std::move(province));
     }
   }
 
@@ -144,11 +217,121 @@ std::unique_ptr<Map> MapFactory::loadMap(std::string path) {
   return map;
 }
 
-// Get the coordinates for one single way
+// Parses the provided compiled map data and returns the map data. The data is
+// read in place, so it has to stay valid until this function returns. The
+// provinces are not triangulated
+std::unique_ptr<Map> MapFactory::parseCompiledMap(unsigned char const* data,
+                                                  size_t size) {
+  // Check header
+  if (!isCompiledMap(data, size))
+    throw std::runtime_error("Invalid compiled map file (bad header)");
+  auto header = reinterpret_cast<CompiledMapHeader const*>(data);
+  if (header->version != OPENHOI_COMPILED_MAP_VERSION)
+    throw std::runtime_error(
+        (boost::format("Unsupported compiled map file version %d") %
+         header->version)
+            .str());
+
+  // Locate the tables. All of them are 4 byte aligned
+  uint64_t provincesOffset = sizeof(CompiledMapHeader);
+  uint64_t ringsOffset = provincesOffset + (uint64_t)header->provinceCount *
+                                               sizeof(CompiledMapProvince);
+  uint64_t coordinatesOffset =
+      ringsOffset + ((uint64_t)header->ringCount + 1) * sizeof(uint32_t);
+  uint64_t stringPoolOffset =
+      coordinatesOffset + (uint64_t)header->coordinateCount * 2 * sizeof(float);
+  if (stringPoolOffset + header->stringPoolSize > size)
+    throw std::runtime_error("Invalid compiled map file (truncated)");
+  auto provinces =
+      reinterpret_cast<CompiledMapProvince const*>(data + provincesOffset);
+  auto rings = reinterpret_cast<uint32_t const*>(data + ringsOffset);
+  auto coordinates = reinterpret_cast<float const*>(data + coordinatesOffset);
+  auto stringPool = reinterpret_cast<char const*>(data + stringPoolOffset);
+  if (rings[header->ringCount] != header->coordinateCount)
+    throw std::runtime_error("Invalid compiled map file (bad ring table)");
+
+  // Build the provinces straight out of the tables. The points are converted
+  // in one scratch buffer and copied into the arena of the province store, so
+  // no per-province or per-ring allocations are made
+  std::unique_ptr<Map> map = std::make_unique<Map>(header->radius);
+  ProvinceStore& store = map->getProvinces();
+  store.reserve(header->provinceCount, header->ringCount,
+                header->coordinateCount);
+  std::vector<Ogre::Vector2> points;
+  std::vector<ArrayView<Ogre::Vector2>> provinceRings;
+  for (uint32_t i = 0; i < header->provinceCount; i++) {
+    auto const& entry = provinces[i];
+    if ((uint64_t)entry.idOffset + entry.idLength > header->stringPoolSize ||
+        (uint64_t)entry.firstRing + entry.ringCount > header->ringCount)
+      throw std::runtime_error("Invalid compiled map file (bad province)");
+    std::string id(stringPool + entry.idOffset, entry.idLength);
+    if (store.find(id) != InvalidProvinceHandle)
+      throw std::runtime_error(
+          "Invalid compiled map file (duplicate province)");
+
+    uint32_t firstPoint = rings[entry.firstRing];
+    uint32_t lastPoint = rings[entry.firstRing + entry.ringCount];
+    if (firstPoint > lastPoint || lastPoint > header->coordinateCount)
+      throw std::runtime_error("Invalid compiled map file (bad ring)");
+    points.clear();
+    for (uint32_t c = firstPoint; c < lastPoint; c++)
+      points.push_back(Ogre::Vector2((Ogre::Real)coordinates[c * 2],
+                                     (Ogre::Real)coordinates[c * 2 + 1]));
+
+    provinceRings.clear();
+    for (uint32_t ring = entry.firstRing;
+         ring < entry.firstRing + entry.ringCount; ring++) {
+      if (rings[ring] < firstPoint || rings[ring] > rings[ring + 1])
+        throw std::runtime_error("Invalid compiled map file (bad ring)");
+      provinceRings.push_back(ArrayView<Ogre::Vector2>(
+          points.data() + (rings[ring] - firstPoint),
+          rings[ring + 1] - rings[ring]));
+    }
+
+    store.add(std::move(id), provinceRings,
+              Ogre::Vector2((Ogre::Real)entry.centerX,
+                            (Ogre::Real)entry.centerY));
+  }
+
+  return map;
+}
+
+// Reads the provided GeoJSON data feature by feature without building a
+// document tree and returns the map data. The provinces are not triangulated
+std::unique_ptr<Map> MapFactory::streamGeoJSON(char const* data, size_t size) {
+  // Generate map object with the same radius as the document parser
+  std::unique_ptr<Map> map = std::make_unique<Map>(6378137);
+
+  // Add every province as soon as it has been read
+  streamGeoJSON(data, size, [&map](Province province) {
+    map->addProvince(std::move(province));
+  });
+
+  // Return map
+  return map;
+}
+
+// Reads the provided GeoJSON data feature by feature without building a
+// document tree and hands every province to the callback as soon as its
+// feature has been read
+void MapFactory::streamGeoJSON(char const* data, size_t size,
+                               std::function<void(Province)> const& callback) {
+  GeoJSONHandler handler(callback);
+  rapidjson::Reader reader;
+  rapidjson::MemoryStream stream(data, size);
+  if (reader.Parse(stream, handler).IsError()) {
+    if (handler.getError()) throw std::runtime_error(handler.getError());
+    throw std::runtime_error("Unable to parse map file");
+  }
+  if (!handler.finish()) throw std::runtime_error(handler.getError());
+}
+
+// Get the coordinates for one single way. The last element is the closing
+// point of the ring and is always skipped
 std::vector<Ogre::Vector2> MapFactory::getCoordinates(rapidjson::Value& value) {
   std::vector<Ogre::Vector2> coords;
 
-  if (value.IsArray()) {
+  if (value.IsArray() && !value.Empty()) {
     for (auto it = value.Begin(); it != std::prev(value.End()); ++it) {
       if (it->IsArray()) {
         auto coordArray = it->GetArray();
@@ -0,0 +1,256 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/map_lod.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <utility>
+
+#include "hoibase/map/border_index.hpp"
+
+namespace openhoi {
+
+// Checks if the first point is lexicographically smaller than the second one
+static bool isLess(Ogre::Vector2 const& first, Ogre::Vector2 const& second) {
+  return first.x < second.x || (first.x == second.x && first.y < second.y);
+}
+
+// Gets the distance between a point and the segment from a to b
+static Ogre::Real getSegmentDistance(Ogre::Vector2 const& point,
+                                     Ogre::Vector2 const& a,
+                                     Ogre::Vector2 const& b) {
+  Ogre::Real dx = b.x - a.x, dy = b.y - a.y;
+  Ogre::Real px = point.x - a.x, py = point.y - a.y;
+  Ogre::Real length = dx * dx + dy * dy;
+  if (length > 0) {
+    Ogre::Real t = std::min<Ogre::Real>(
+        std::max<Ogre::Real>((px * dx + py * dy) / length, 0), 1);
+    px -= t * dx;
+    py -= t * dy;
+  }
+  return std::sqrt(px * px + py * py);
+}
+
+// Computes the Douglas-Peucker importance of the inner points of a chain, i.e.
+// the largest tolerance at which they are still kept. The first split of the
+// chain is always kept
+static void simplifyChain(ArrayView<Ogre::Vector2> ring,
+                          std::vector<uint32_t> const& chain,
+                          Ogre::Real* importance) {
+  const Ogre::Real infinity = std::numeric_limits<Ogre::Real>::infinity();
+  std::vector<std::tuple<size_t, size_t, Ogre::Real>> stack;
+  stack.push_back(std::make_tuple(0, chain.size() - 1, infinity));
+  bool first = true;
+  while (!stack.empty()) {
+    size_t from, to;
+    Ogre::Real bound;
+    std::tie(from, to, bound) = stack.back();
+    stack.pop_back();
+    if (to - from < 2) continue;
+
+    // Find the point that is most distant from the segment between the ends
+    size_t split = from + 1;
+    Ogre::Real distance = -1;
+    for (size_t i = from + 1; i < to; i++) {
+      Ogre::Real d = getSegmentDistance(ring[chain[i]], ring[chain[from]],
+                                        ring[chain[to]]);
+      if (d > distance) {
+        split = i;
+        distance = d;
+      }
+    }
+
+    Ogre::Real value = first ? infinity : std::min(bound, distance);
+    importance[chain[split]] = value;
+    first = false;
+    stack.push_back(std::make_tuple(from, split, value));
+    stack.push_back(std::make_tuple(split, to, value));
+  }
+}
+
+// Computes the importance of all points of a ring. Points where the province on
+// the other side of the border changes are always kept
+static void simplifyRing(ArrayView<Ogre::Vector2> ring,
+                         ArrayView<ProvinceHandle> opposites,
+                         Ogre::Real* importance) {
+  const Ogre::Real infinity = std::numeric_limits<Ogre::Real>::infinity();
+  size_t count = ring.size();
+  std::fill(importance, importance + count, (Ogre::Real)0);
+  if (count < 4) {
+    std::fill(importance, importance + count, infinity);
+    return;
+  }
+
+  // Find the points where the border changes
+  std::vector<uint32_t> breaks;
+  for (size_t i = 0; i < count; i++) {
+    if (opposites[(i + count - 1) % count] != opposites[i]) {
+      breaks.push_back((uint32_t)i);
+      importance[i] = infinity;
+    }
+  }
+
+  // A ring without changes is one closed chain, which starts at its smallest
+  // point so that both sides agree on it
+  bool closed = breaks.empty();
+  if (closed) {
+    uint32_t smallest = 0;
+    for (size_t i = 1; i < count; i++)
+      if (isLess(ring[i], ring[smallest])) smallest = (uint32_t)i;
+    breaks.push_back(smallest);
+    importance[smallest] = infinity;
+  }
+
+  std::vector<uint32_t> chain;
+  for (size_t b = 0; b < breaks.size(); b++) {
+    uint32_t start = breaks[b];
+    uint32_t end = b + 1 < breaks.size() ? breaks[b + 1]
+                                         : breaks[0] + (uint32_t)count;
+    chain.clear();
+    for (uint32_t i = start; i <= end; i++) chain.push_back(i % count);
+
+    // Both provinces along a border walk it in opposite directions, so bring
+    // every chain into a canonical direction before simplifying it
+    size_t last = chain.size() - 1;
+    if (closed ? isLess(ring[chain[last - 1]], ring[chain[1]])
+               : isLess(ring[chain[last]], ring[chain[0]]))
+      std::reverse(chain.begin(), chain.end());
+
+    if (!closed) {
+      simplifyChain(ring, chain, importance);
+      continue;
+    }
+
+    // Closed chains are split at their point most distant from the start, so
+    // that both halves have distinct ends
+    size_t split = 1;
+    Ogre::Real distance = -1;
+    for (size_t i = 1; i < last; i++) {
+      Ogre::Real d = getSegmentDistance(ring[chain[i]], ring[chain[0]],
+                                        ring[chain[0]]);
+      if (d > distance) {
+        split = i;
+        distance = d;
+      }
+    }
+    importance[chain[split]] = infinity;
+    std::vector<uint32_t> half(chain.begin(), chain.begin() + split + 1);
+    simplifyChain(ring, half, importance);
+    half.assign(chain.begin() + split, chain.end());
+    simplifyChain(ring, half, importance);
+  }
+}
+
+// Builds the levels of detail of all provinces of the provided store with the
+// provided tolerances in map units, sorted from fine to coarse. The store must
+// outlive the levels of detail
+MapLOD::MapLOD(ProvinceStore const& provinces,
+               std::vector<Ogre::Real> tolerances)
+    : provinces(provinces) {
+  assert(std::is_sorted(tolerances.begin(), tolerances.end()));
+
+  // Compute the importance of every point of every ring
+  BorderIndex borders(provinces);
+  auto const& rings = provinces.getRings();
+  std::vector<size_t> pointOffsets;
+  pointOffsets.reserve(rings.size() + 1);
+  pointOffsets.push_back(0);
+  for (auto const& ring : rings)
+    pointOffsets.push_back(pointOffsets.back() + ring.size());
+  std::vector<Ogre::Real> importance(pointOffsets.back());
+  for (size_t ring = 0; ring < rings.size(); ring++)
+    simplifyRing(rings[ring], borders.getOpposites(ring),
+                 importance.data() + pointOffsets[ring]);
+
+  // Keep the points that are more important than the tolerance of each level
+  auto const& ringOffsets = provinces.getRingOffsets();
+  for (Ogre::Real tolerance : tolerances) {
+    Level level;
+    level.tolerance = tolerance;
+    level.ringOffsets.reserve(ringOffsets.size());
+    level.ringOffsets.push_back(0);
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (ProvinceHandle province = 0; province < provinces.size();
+         province++) {
+      for (uint32_t ring = ringOffsets[province];
+           ring < ringOffsets[province + 1]; ring++) {
+        size_t first = level.points.size();
+        for (size_t i = 0; i < rings[ring].size(); i++) {
+          if (importance[pointOffsets[ring] + i] > tolerance)
+            level.points.push_back(rings[ring][i]);
+        }
+        if (level.points.size() - first < 3)
+          level.points.resize(first);
+        else
+          ranges.push_back({first, level.points.size() - first});
+      }
+      level.ringOffsets.push_back((uint32_t)ranges.size());
+    }
+
+    // Create the ring views once all points are in place
+    level.points.shrink_to_fit();
+    level.rings.reserve(ranges.size());
+    for (auto const& range : ranges)
+      level.rings.push_back(ArrayView<Ogre::Vector2>(
+          level.points.data() + range.first, range.second));
+    levels.push_back(std::move(level));
+  }
+}
+
+// Gets the default tolerances for a map with the provided extent, i.e. the
+// length of the diagonal of its bounding box
+std::vector<Ogre::Real> MapLOD::getDefaultTolerances(Ogre::Real extent) {
+  return {extent / 8192, extent / 2048, extent / 512};
+}
+
+// Gets the number of levels, including the original rings at level 0
+size_t MapLOD::getLevelCount() const { return levels.size() + 1; }
+
+// Gets the maximum distance between the simplified and the original outline of
+// the level
+Ogre::Real MapLOD::getTolerance(size_t level) const {
+  assert(level < getLevelCount());
+  return level == 0 ? 0 : levels[level - 1].tolerance;
+}
+
+// Gets the number of points of all provinces on the level
+size_t MapLOD::getPointCount(size_t level) const {
+  assert(level < getLevelCount());
+  return level == 0 ? provinces.getPointCount()
+                    : levels[level - 1].points.size();
+}
+
+// Gets the rings of the province on the level. Rings that are too small to be
+// visible on the level are left out
+ArrayView<ArrayView<Ogre::Vector2>> MapLOD::getRings(
+    size_t level, ProvinceHandle province) const {
+  assert(level < getLevelCount());
+  if (level == 0) return provinces.getRings(province);
+  Level const& data = levels[level - 1];
+  assert(province + 1 < data.ringOffsets.size());
+  return ArrayView<ArrayView<Ogre::Vector2>>(
+      data.rings.data() + data.ringOffsets[province],
+      data.ringOffsets[province + 1] - data.ringOffsets[province]);
+}
+
+// Gets the coarsest level whose tolerance is below the provided size of one
+// screen pixel in map units
+size_t MapLOD::selectLevel(Ogre::Real pixelSize) const {
+  size_t level = levels.size();
+  while (level > 0 && levels[level - 1].tolerance > pixelSize) level--;
+  return level;
+}
+
+// Gets the coarsest level that is precise enough for a camera at the provided
+// distance to the map, with the provided vertical field of view in radians and
+// viewport height in pixels
+size_t MapLOD::selectLevel(Ogre::Real cameraDistance, Ogre::Real fieldOfViewY,
+                           Ogre::Real viewportHeight) const {
+  Ogre::Real viewHeight = 2 * cameraDistance * std::tan(fieldOfViewY / 2);
+  return selectLevel(viewHeight / viewportHeight);
+}
+
+}  // namespace openhoi
@@ -0,0 +1,256 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/map_mesh.hpp"
+
+#include <OgreHardwareBufferManager.h>
+#include <OgreMeshManager.h>
+#include <OgreSubMesh.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+
+// Fraction of the used vertices and indices that is allocated on top of them
+// in the hardware buffers, so that provinces can grow without recreating them
+#define OPENHOI_MAP_MESH_BUFFER_SLACK 0.25
+
+// Minimum number of vertices and indices that is allocated on top of the used
+// ones in the hardware buffers
+#define OPENHOI_MAP_MESH_MIN_BUFFER_SLACK 1024
+
+namespace openhoi {
+
+// Builds the map mesh out of the triangulations of all provinces of the
+// provided store
+MapMesh::MapMesh(ProvinceStore const& provinces) {
+  const Ogre::Real infinity = std::numeric_limits<Ogre::Real>::infinity();
+  bounds = {Ogre::Vector2(infinity, infinity),
+            Ogre::Vector2(-infinity, -infinity)};
+  ranges.reserve(provinces.size());
+
+  // Append the indexed mesh of every province, so that vertices that are
+  // shared by multiple triangles of a province are only stored once
+  for (ProvinceHandle province = 0; province < provinces.size(); province++)
+    writeProvince(province, provinces.getIndexedMesh(province));
+  if (vertices.empty()) bounds = {Ogre::Vector2(0, 0), Ogre::Vector2(0, 0)};
+
+  // The whole mesh is uploaded when the Ogre mesh is created
+  dirtyVertices.clear();
+  dirtyIndices.clear();
+}
+
+// Gets the vertices of all provinces
+std::vector<MapMeshVertex> const& MapMesh::getVertices() const {
+  return vertices;
+}
+
+// Gets the triangle indices of all provinces
+std::vector<uint32_t> const& MapMesh::getIndices() const { return indices; }
+
+// Gets the first index of the triangles of the province
+size_t MapMesh::getIndexStart(ProvinceHandle province) const {
+  assert(province < ranges.size());
+  return ranges[province].indexStart;
+}
+
+// Gets the number of indices of the triangles of the province
+size_t MapMesh::getIndexCount(ProvinceHandle province) const {
+  assert(province < ranges.size());
+  return ranges[province].indexCount;
+}
+
+// Gets the bounding box of all vertices that were ever written
+BoundingBox const& MapMesh::getBounds() const { return bounds; }
+
+// Replaces the triangles of the provided provinces with their current
+// triangulation in the store. Provinces that were added to the store are
+// appended. A province keeps its place in the buffers if its new triangles
+// fit, otherwise it is moved to the end and its old triangles are collapsed.
+// The space of moved provinces is only reclaimed by rebuilding the mesh
+void MapMesh::updateProvinces(
+    ProvinceStore const& provinces,
+    std::vector<ProvinceHandle> const& changedProvinces) {
+  for (ProvinceHandle province : changedProvinces)
+    writeProvince(province, provinces.getIndexedMesh(province));
+}
+
+// Checks if vertices or indices changed since the last upload
+bool MapMesh::hasChanges() const {
+  return !dirtyVertices.empty() || !dirtyIndices.empty();
+}
+
+// Writes the indexed mesh of the province into the buffers, in place of its
+// previous triangles if they fit or at the end otherwise
+void MapMesh::writeProvince(ProvinceHandle province, IndexedMesh const& mesh) {
+  if (province >= ranges.size())
+    ranges.resize(province + 1, {(uint32_t)vertices.size(), 0,
+                                 (uint32_t)indices.size(), 0, 0});
+  ProvinceRange& range = ranges[province];
+  uint32_t vertexCount = (uint32_t)mesh.getVertices().size();
+  uint32_t indexCount = (uint32_t)mesh.getIndexCount();
+
+  if (vertexCount > range.vertexCapacity || indexCount > range.indexCapacity) {
+    // Collapse the old triangles into one point, so that they are no longer
+    // drawn, and move the province to the end of the buffers
+    if (range.indexCapacity > 0) {
+      std::fill_n(indices.begin() + range.indexStart, range.indexCapacity,
+                  range.vertexStart);
+      dirtyIndices.push_back(
+          {range.indexStart, range.indexStart + range.indexCapacity});
+    }
+    range.vertexStart = (uint32_t)vertices.size();
+    range.vertexCapacity = vertexCount;
+    range.indexStart = (uint32_t)indices.size();
+    range.indexCapacity = indexCount;
+    vertices.resize(vertices.size() + vertexCount);
+    indices.resize(indices.size() + indexCount);
+  }
+  range.indexCount = indexCount;
+
+  // Write the vertices
+  for (uint32_t i = 0; i < vertexCount; i++) {
+    auto const& vertex = mesh.getVertices()[i];
+    vertices[range.vertexStart + i] = {(float)vertex.x, (float)vertex.y,
+                                       (float)province};
+    bounds.min.x = std::min(bounds.min.x, vertex.x);
+    bounds.min.y = std::min(bounds.min.y, vertex.y);
+    bounds.max.x = std::max(bounds.max.x, vertex.x);
+    bounds.max.y = std::max(bounds.max.y, vertex.y);
+  }
+
+  // Write the indices and collapse the unused rest of the range
+  for (uint32_t i = 0; i < indexCount; i++)
+    indices[range.indexStart + i] = range.vertexStart + mesh.getIndex(i);
+  std::fill(indices.begin() + range.indexStart + indexCount,
+            indices.begin() + range.indexStart + range.indexCapacity,
+            range.vertexStart);
+
+  if (vertexCount > 0)
+    dirtyVertices.push_back(
+        {range.vertexStart, range.vertexStart + vertexCount});
+  if (range.indexCapacity > 0)
+    dirtyIndices.push_back(
+        {range.indexStart, range.indexStart + range.indexCapacity});
+}
+
+// Creates an Ogre mesh with one sub mesh that uses the map material and uploads
+// the vertices and indices into hardware buffers with room to grow
+Ogre::MeshPtr MapMesh::createOgreMesh(
+    std::string const& name, std::string const& resourceGroupName) const {
+  Ogre::MeshPtr mesh =
+      Ogre::MeshManager::getSingleton().createManual(name, resourceGroupName);
+  setOgreBounds(mesh);
+  if (indices.empty()) return mesh;
+
+  createSubMesh(mesh, resourceGroupName);
+  mesh->load();
+  return mesh;
+}
+
+// Writes the vertices and indices that changed since the last upload into the
+// hardware buffers of the provided mesh, which was created by createOgreMesh.
+// Provinces that were moved to the end are appended in place as long as the
+// buffers have room left, they are only recreated if they are too small
+void MapMesh::uploadChanges(Ogre::MeshPtr const& mesh) {
+  if (!hasChanges()) return;
+  setOgreBounds(mesh);
+
+  if (mesh->getNumSubMeshes() == 0) {
+    // The mesh was created without any triangles
+    createSubMesh(mesh, mesh->getGroup());
+  } else {
+    Ogre::SubMesh* subMesh = mesh->getSubMesh(0);
+    Ogre::HardwareVertexBufferSharedPtr vertexBuffer =
+        subMesh->vertexData->vertexBufferBinding->getBuffer(0);
+    Ogre::HardwareIndexBufferSharedPtr indexBuffer =
+        subMesh->indexData->indexBuffer;
+    if (vertexBuffer->getNumVertices() < vertices.size() ||
+        indexBuffer->getNumIndexes() < indices.size()) {
+      // Provinces were moved beyond the capacity of the buffers
+      createBuffers(subMesh);
+    } else {
+      for (auto const& range : dirtyVertices)
+        vertexBuffer->writeData(range.first * sizeof(MapMeshVertex),
+                                (range.second - range.first) *
+                                    sizeof(MapMeshVertex),
+                                vertices.data() + range.first);
+      for (auto const& range : dirtyIndices)
+        indexBuffer->writeData(range.first * sizeof(uint32_t),
+                               (range.second - range.first) * sizeof(uint32_t),
+                               indices.data() + range.first);
+
+      // Only draw the used part of the buffers
+      subMesh->vertexData->vertexCount = vertices.size();
+      subMesh->indexData->indexCount = indices.size();
+    }
+  }
+
+  dirtyVertices.clear();
+  dirtyIndices.clear();
+}
+
+// Sets the bounds of the Ogre mesh to the bounds of the map mesh
+void MapMesh::setOgreBounds(Ogre::MeshPtr const& mesh) const {
+  mesh->_setBounds(Ogre::AxisAlignedBox(bounds.min.x, bounds.min.y, 0,
+                                        bounds.max.x, bounds.max.y, 0));
+  mesh->_setBoundingSphereRadius(
+      std::max((bounds.max - bounds.min).length() / 2, (Ogre::Real)1));
+}
+
+// Creates the sub mesh that draws the map mesh with the map material
+void MapMesh::createSubMesh(Ogre::MeshPtr const& mesh,
+                            std::string const& resourceGroupName) const {
+  Ogre::SubMesh* subMesh = mesh->createSubMesh();
+  subMesh->setMaterialName(OPENHOI_MAP_MESH_MATERIAL, resourceGroupName);
+  subMesh->operationType = Ogre::RenderOperation::OT_TRIANGLE_LIST;
+  subMesh->useSharedVertices = false;
+
+  // Describe the vertex layout: 2D position and province handle
+  subMesh->vertexData = OGRE_NEW Ogre::VertexData();
+  subMesh->vertexData->vertexStart = 0;
+  Ogre::VertexDeclaration* declaration =
+      subMesh->vertexData->vertexDeclaration;
+  declaration->addElement(0, offsetof(MapMeshVertex, x), Ogre::VET_FLOAT2,
+                          Ogre::VES_POSITION);
+  declaration->addElement(0, offsetof(MapMeshVertex, province),
+                          Ogre::VET_FLOAT1, Ogre::VES_TEXTURE_COORDINATES, 0);
+
+  createBuffers(subMesh);
+}
+
+// Creates the hardware buffers of the sub mesh and uploads all vertices and
+// indices. The buffers are larger than needed, so that provinces which are
+// moved to the end later on can be appended without recreating them. As they
+// are partially updated, they are dynamic instead of static
+void MapMesh::createBuffers(Ogre::SubMesh* subMesh) const {
+  auto& bufferManager = Ogre::HardwareBufferManager::getSingleton();
+  Ogre::HardwareVertexBufferSharedPtr vertexBuffer =
+      bufferManager.createVertexBuffer(
+          sizeof(MapMeshVertex), getBufferCapacity(vertices.size()),
+          Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+  vertexBuffer->writeData(0, vertices.size() * sizeof(MapMeshVertex),
+                          vertices.data(), true);
+  subMesh->vertexData->vertexBufferBinding->setBinding(0, vertexBuffer);
+  subMesh->vertexData->vertexCount = vertices.size();
+
+  Ogre::HardwareIndexBufferSharedPtr indexBuffer =
+      bufferManager.createIndexBuffer(
+          Ogre::HardwareIndexBuffer::IT_32BIT,
+          getBufferCapacity(indices.size()),
+          Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+  indexBuffer->writeData(0, indices.size() * sizeof(uint32_t), indices.data(),
+                         true);
+  subMesh->indexData->indexBuffer = indexBuffer;
+  subMesh->indexData->indexStart = 0;
+  subMesh->indexData->indexCount = indices.size();
+}
+
+// Gets the number of vertices or indices the hardware buffers are allocated
+// with if the provided number of them is used
+size_t MapMesh::getBufferCapacity(size_t size) {
+  return size + std::max((size_t)(size * OPENHOI_MAP_MESH_BUFFER_SLACK),
+                         (size_t)OPENHOI_MAP_MESH_MIN_BUFFER_SLACK);
+}
+
+}  // namespace openhoi
@@ -0,0 +1,245 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/map_mesh_cache.hpp"
+
+#include <OgreLogManager.h>
+#include <openssl/sha.h>
+
+#include <array>
+#include <boost/format.hpp>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+
+#include "hoibase/file/file_access.hpp"
+#include "hoibase/file/mapped_file.hpp"
+
+// Magic bytes at the beginning of every mesh cache file
+#define OPENHOI_MAP_MESH_CACHE_MAGIC "OHMC"
+
+// Version of the mesh cache file layout. Increase it whenever the layout, the
+// triangulation output or the center computation changes
+#define OPENHOI_MAP_MESH_CACHE_VERSION 3
+
+// The mesh cache file layout is (all integers are 32 bit, native byte order):
+//   magic[4] | version | province count
+//   per province: ID length | ID bytes | center x, y (reals) | vertex count |
+//                 vertices (x, y reals) | index count | indices (16 bit if
+//                 there are at most 65536 vertices, otherwise 32 bit)
+
+namespace openhoi {
+
+namespace {
+
+// Reads sequentially from a memory mapped cache file and fails softly on
+// truncated data
+class CacheReader {
+ public:
+  CacheReader(unsigned char const* data, size_t size)
+      : data(data), size(size), pos(0) {}
+
+  bool read(void* target, size_t length) {
+    if (length > size - pos) return false;
+    memcpy(target, data + pos, length);
+    pos += length;
+    return true;
+  }
+
+  bool readUInt32(uint32_t& value) { return read(&value, sizeof(value)); }
+
+  // Reads the provided number of indices that all have to be less than the
+  // provided vertex count
+  template <typename T>
+  bool readIndices(std::vector<T>& indices, uint32_t count,
+                   uint32_t vertexCount) {
+    indices.resize(count);
+    if (!read(indices.data(), count * sizeof(T))) return false;
+    for (T index : indices)
+      if (index >= vertexCount) return false;
+    return true;
+  }
+
+ private:
+  unsigned char const* data;
+  size_t size;
+  size_t pos;
+};
+
+}  // namespace
+
+// Computes the cache key out of the raw map file content
+std::string MapMeshCache::computeKey(unsigned char const* data, size_t size) {
+  std::array<unsigned char, SHA256_DIGEST_LENGTH> digest;
+  SHA256(data, size, digest.data());
+
+  std::string key;
+  key.reserve(digest.size() * 2);
+  for (unsigned char value : digest)
+    key += (boost::format("%02x") % (unsigned int)value).str();
+  return key;
+}
+
+// Restores the province triangulations and centers of the provided map from
+// the cache. Returns false and leaves the provinces untouched in case there is
+// no usable cache entry for every province.
+bool MapMeshCache::load(std::string const& key, Map& map) {
+  filesystem::path cacheFile;
+  try {
+    cacheFile = getCacheFile(key);
+  } catch (std::exception const&) {
+    return false;
+  }
+  if (!filesystem::is_regular_file(cacheFile)) return false;
+
+  // Map the cache file into memory
+  MappedFile file(cacheFile, MappedFileAccess::Sequential);
+  if (!file.isOpen()) return false;
+  CacheReader reader(file.getData(), file.getSize());
+
+  // Check header
+  char magic[4];
+  uint32_t version, provinceCount;
+  if (!reader.read(magic, sizeof(magic)) ||
+      memcmp(magic, OPENHOI_MAP_MESH_CACHE_MAGIC, sizeof(magic)) != 0 ||
+      !reader.readUInt32(version) ||
+      version != OPENHOI_MAP_MESH_CACHE_VERSION ||
+      !reader.readUInt32(provinceCount) ||
+      provinceCount != map.getProvinces().size())
+    return false;
+
+  // Read all meshes first so that the map is not touched if the cache is
+  // incomplete
+  std::vector<std::pair<ProvinceHandle, IndexedMesh>> meshes;
+  std::vector<Ogre::Vector2> centers;
+  meshes.reserve(provinceCount);
+  centers.reserve(provinceCount);
+  for (uint32_t i = 0; i < provinceCount; i++) {
+    uint32_t idLength, vertexCount, indexCount;
+    std::string id;
+    Ogre::Real center[2];
+    if (!reader.readUInt32(idLength)) return false;
+    id.resize(idLength);
+    if (!reader.read(&id[0], idLength) ||
+        !reader.read(center, sizeof(center)) ||
+        !reader.readUInt32(vertexCount))
+      return false;
+
+    ProvinceHandle province = map.getProvinceHandle(id);
+    if (province == InvalidProvinceHandle) return false;
+
+    std::vector<Ogre::Vector2> vertices(vertexCount);
+    if (!reader.read(vertices.data(), vertexCount * sizeof(Ogre::Vector2)) ||
+        !reader.readUInt32(indexCount))
+      return false;
+    if (vertexCount <= std::numeric_limits<uint16_t>::max() + 1u) {
+      std::vector<uint16_t> indices;
+      if (!reader.readIndices(indices, indexCount, vertexCount)) return false;
+      meshes.push_back(
+          {province, IndexedMesh(std::move(vertices), std::move(indices))});
+    } else {
+      std::vector<uint32_t> indices;
+      if (!reader.readIndices(indices, indexCount, vertexCount)) return false;
+      meshes.push_back(
+          {province, IndexedMesh(std::move(vertices), std::move(indices))});
+    }
+    centers.push_back(Ogre::Vector2(center[0], center[1]));
+  }
+
+  // Hand the meshes and centers over to the provinces
+  map.invalidateIndices();
+  ProvinceStore& provinces = map.getProvinces();
+  for (size_t i = 0; i < meshes.size(); i++) {
+    provinces.setCenter(meshes[i].first, centers[i]);
+    provinces.setIndexedMesh(meshes[i].first, std::move(meshes[i].second));
+  }
+
+  if (Ogre::LogManager::getSingletonPtr())
+    Ogre::LogManager::getSingletonPtr()->logMessage(
+        (boost::format("Restored %d province meshes and centers from cache "
+                       "'%s'") %
+         provinceCount % cacheFile.filename().u8string())
+            .str());
+  return true;
+}
+
+// Stores the province triangulations and centers of the provided map in the
+// cache. Returns false in case the cache file could not be written.
+bool MapMeshCache::save(std::string const& key, Map const& map) {
+  filesystem::path cacheFile, tempFile;
+  try {
+    cacheFile = getCacheFile(key);
+    filesystem::create_directories(cacheFile.parent_path());
+  } catch (std::exception const&) {
+    return false;
+  }
+
+  // Write to a temporary file first so that an interrupted write never leaves
+  // a broken cache file behind
+  tempFile = cacheFile;
+  tempFile += ".tmp";
+  {
+    auto closeFile = [](FILE* f) { fclose(f); };
+    auto holder = std::unique_ptr<FILE, decltype(closeFile)>(
+        FileAccess::fopen(tempFile, "wb"), closeFile);
+    if (!holder) return false;
+    FILE* fp = holder.get();
+
+    bool ok = true;
+    auto write = [&](void const* data, size_t length) {
+      if (ok && length > 0) ok = fwrite(data, 1, length, fp) == length;
+    };
+    auto writeUInt32 = [&](uint32_t value) { write(&value, sizeof(value)); };
+
+    // Write header
+    write(OPENHOI_MAP_MESH_CACHE_MAGIC, 4);
+    writeUInt32(OPENHOI_MAP_MESH_CACHE_VERSION);
+    writeUInt32((uint32_t)map.getProvinces().size());
+
+    // Write one mesh per province
+    ProvinceStore const& provinces = map.getProvinces();
+    for (ProvinceHandle i = 0; i < provinces.size(); i++) {
+      auto const& id = provinces.getID(i);
+      auto const& center = provinces.getCenter(i);
+      auto const& mesh = provinces.getIndexedMesh(i);
+      auto const& vertices = mesh.getVertices();
+      writeUInt32((uint32_t)id.size());
+      write(id.data(), id.size());
+      write(&center.x, sizeof(center.x));
+      write(&center.y, sizeof(center.y));
+      writeUInt32((uint32_t)vertices.size());
+      write(vertices.data(), vertices.size() * sizeof(Ogre::Vector2));
+      writeUInt32((uint32_t)mesh.getIndexCount());
+      if (mesh.hasWideIndices())
+        write(mesh.getIndices32().data(),
+              mesh.getIndices32().size() * sizeof(uint32_t));
+      else
+        write(mesh.getIndices16().data(),
+              mesh.getIndices16().size() * sizeof(uint16_t));
+    }
+
+    if (!ok) {
+      holder.reset();
+      std::error_code ec;
+      filesystem::remove(tempFile, ec);
+      return false;
+    }
+  }
+
+  // Replace the previous cache file
+  std::error_code ec;
+  filesystem::rename(tempFile, cacheFile, ec);
+  if (ec) {
+    filesystem::remove(tempFile, ec);
+    return false;
+  }
+  return true;
+}
+
+// Gets the path of the cache file for the provided key
+filesystem::path MapMeshCache::getCacheFile(std::string const& key) {
+  return FileAccess::getUserGameConfigDirectory() / "cache" / "maps" /
+         (key + ".mesh");
+}
+
+}  // namespace openhoi
@@ -0,0 +1,170 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/map_reloader.hpp"
+
+#include <OgreLogManager.h>
+
+#include <algorithm>
+#include <boost/format.hpp>
+#include <chrono>
+#include <stdexcept>
+
+#include "hoibase/file/mapped_file.hpp"
+#include "hoibase/helper/parallel.hpp"
+#include "hoibase/map/map_factory.hpp"
+#include "hoibase/map/province_center.hpp"
+
+namespace openhoi {
+
+// Checks if two provinces have the same rings
+static bool haveEqualRings(ArrayView<ArrayView<Ogre::Vector2>> a,
+                           ArrayView<ArrayView<Ogre::Vector2>> b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].size() != b[i].size() ||
+        !std::equal(a[i].begin(), a[i].end(), b[i].begin()))
+      return false;
+  }
+  return true;
+}
+
+// Starts watching the map file the provided map was loaded from. The map has to
+// outlive the reloader
+MapReloader::MapReloader(std::string path, Map& map)
+    : path(path), map(map), watcher(filesystem::u8path(path)) {}
+
+// Checks without blocking if the map file changed and applies the changes to
+// the map. Returns the handles of all added, changed and removed provinces,
+// which are already re-triangulated. If the map file could not be parsed, the
+// map is left untouched
+std::vector<ProvinceHandle> MapReloader::poll() {
+  if (!watcher.poll()) return std::vector<ProvinceHandle>();
+
+  // The file may be in the middle of being written, so a broken file is not
+  // fatal. The next save triggers another reload
+  char const* error = nullptr;
+  std::string message;
+  try {
+    return reload();
+  } catch (char const* e) {
+    error = e;
+  } catch (std::exception const& e) {
+    message = e.what();
+    error = message.c_str();
+  }
+  if (Ogre::LogManager::getSingletonPtr())
+    Ogre::LogManager::getSingletonPtr()->logMessage(
+        (boost::format("Unable to reload map file '%s': %s") % path % error)
+            .str(),
+        Ogre::LogMessageLevel::LML_WARNING);
+  return std::vector<ProvinceHandle>();
+}
+
+// Reads the map file and applies the changes to the map. Returns the handles of
+// all added, changed and removed provinces, which are already re-triangulated
+std::vector<ProvinceHandle> MapReloader::reload() {
+  auto start = std::chrono::steady_clock::now();
+
+  // Parse the map file
+  MappedFile file(filesystem::u8path(path), MappedFileAccess::Sequential);
+  if (!file.isOpen())
+    throw std::runtime_error(
+        (boost::format("Unable to read map file '%s'") % path).str());
+  std::unique_ptr<Map> updated =
+      MapFactory::parseMap(file.getData(), file.getSize());
+
+  // Only touch the provinces that differ
+  ProvinceStore const& updatedProvinces =
+      static_cast<Map const&>(*updated).getProvinces();
+  MapDiff changes =
+      diff(static_cast<Map const&>(map).getProvinces(), updatedProvinces);
+  std::vector<ProvinceHandle> handles = apply(map, updatedProvinces, changes);
+
+  // Log the timings
+  if (Ogre::LogManager::getSingletonPtr()) {
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    Ogre::LogManager::getSingletonPtr()->logMessage(
+        (boost::format("Reloaded map file '%s' in %d ms (%d provinces added, "
+                       "%d changed, %d removed)") %
+         path % duration.count() % changes.added.size() %
+         changes.changed.size() % changes.removed.size())
+            .str());
+  }
+
+  return handles;
+}
+
+// Compares two versions of the provinces of a map by province ID
+MapDiff MapReloader::diff(ProvinceStore const& current,
+                          ProvinceStore const& updated) {
+  MapDiff result;
+  for (ProvinceHandle province = 0; province < updated.size(); province++) {
+    std::string const& id = updated.getID(province);
+    ProvinceHandle existing = current.find(id);
+    if (existing == InvalidProvinceHandle)
+      result.added.push_back(id);
+    else if (!haveEqualRings(current.getRings(existing),
+                             updated.getRings(province)))
+      result.changed.push_back(id);
+  }
+
+  // Provinces which were removed before only have empty rings left
+  for (ProvinceHandle province = 0; province < current.size(); province++) {
+    if (current.getRingCount(province) > 0 &&
+        updated.find(current.getID(province)) == InvalidProvinceHandle)
+      result.removed.push_back(current.getID(province));
+  }
+  return result;
+}
+
+// Applies the differences to the map and recomputes the centers and
+// triangulations of the affected provinces in parallel. Returns the handles of
+// all added, changed and removed provinces. If a thread count of 0 is
+// provided, the number of hardware threads is used.
+std::vector<ProvinceHandle> MapReloader::apply(Map& map,
+                                               ProvinceStore const& updated,
+                                               MapDiff const& diff,
+                                               unsigned int threadCount) {
+  std::vector<ProvinceHandle> handles;
+  if (diff.added.empty() && diff.changed.empty() && diff.removed.empty())
+    return handles;
+
+  // Modifying the provinces drops the spatial index, the adjacency graph and
+  // the levels of detail
+  map.invalidateIndices();
+  ProvinceStore& provinces = map.getProvinces();
+  handles.reserve(diff.added.size() + diff.changed.size() +
+                  diff.removed.size());
+  for (auto const& id : diff.added) {
+    ProvinceHandle source = updated.find(id);
+    handles.push_back(provinces.add(id, updated.getRings(source),
+                                    updated.getCenter(source)));
+  }
+  for (auto const& id : diff.changed) {
+    ProvinceHandle source = updated.find(id);
+    ProvinceHandle province = provinces.find(id);
+    provinces.setRings(province, updated.getRings(source));
+    handles.push_back(province);
+  }
+  for (auto const& id : diff.removed) {
+    ProvinceHandle province = provinces.find(id);
+    provinces.setRings(province, ArrayView<ArrayView<Ogre::Vector2>>());
+    handles.push_back(province);
+  }
+
+  // Update the affected provinces only
+  std::vector<Ogre::Vector2> centers(handles.size());
+  Parallel::forEach(
+      handles.size(),
+      [&](size_t i) {
+        centers[i] = ProvinceCenter::compute(provinces.getRings(handles[i]));
+        provinces.getIndexedMesh(handles[i]);
+      },
+      threadCount);
+  for (size_t i = 0; i < handles.size(); i++)
+    provinces.setCenter(handles[i], centers[i]);
+  return handles;
+}
+
+}  // namespace openhoi
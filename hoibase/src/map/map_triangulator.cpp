@@ -0,0 +1,139 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/map_triangulator.hpp"
+
+#include <OgreLogManager.h>
+
+#include <algorithm>
+#include <boost/format.hpp>
+
+#include "hoibase/helper/parallel.hpp"
+
+namespace openhoi {
+
+// Map triangulation constructor
+MapTriangulation::MapTriangulation(std::vector<Ogre::Real> vertices,
+                                   std::vector<ProvinceTriangulation> provinces,
+                                   std::chrono::microseconds duration,
+                                   unsigned int threadCount)
+    : vertices(std::move(vertices)),
+      provinces(std::move(provinces)),
+      duration(duration),
+      threadCount(threadCount) {}
+
+// Gets the vertices of all provinces in one buffer
+std::vector<Ogre::Real> const& MapTriangulation::getVertices() const {
+  return vertices;
+}
+
+// Gets the per-province offsets and timings
+std::vector<ProvinceTriangulation> const& MapTriangulation::getProvinces()
+    const {
+  return provinces;
+}
+
+// Gets the wall clock time the whole triangulation took
+std::chrono::microseconds const& MapTriangulation::getDuration() const {
+  return duration;
+}
+
+// Gets the number of threads used for the triangulation
+unsigned int const& MapTriangulation::getThreadCount() const {
+  return threadCount;
+}
+
+// Triangulates all provinces of the provided map in parallel so that every
+// province keeps its triangulation, without gathering the vertices. If a thread
+// count of 0 is provided, the number of hardware threads is used.
+void MapTriangulator::triangulateProvinces(Map const& map,
+                                           unsigned int threadCount) {
+  triangulateProvinces(map.getProvinces(), threadCount);
+}
+
+// Triangulates all provinces of the provided map in parallel and gathers their
+// vertices into one map triangulation. If a thread count of 0 is provided, the
+// number of hardware threads is used.
+MapTriangulation MapTriangulator::triangulate(Map const& map,
+                                              unsigned int threadCount) {
+  auto start = std::chrono::steady_clock::now();
+  ProvinceStore const& provinces = map.getProvinces();
+  threadCount = getThreadCount(provinces, threadCount);
+
+  // Triangulate every province on the worker pool
+  std::vector<std::chrono::microseconds> durations =
+      triangulateProvinces(provinces, threadCount);
+
+  // Gather all vertices into one buffer. The provinces keep indexed meshes,
+  // which are only expanded into triangle lists here
+  size_t total = 0;
+  for (ProvinceHandle i = 0; i < provinces.size(); i++)
+    total += provinces.getIndexedMesh(i).getIndexCount() * 3;
+  std::vector<Ogre::Real> vertices;
+  vertices.reserve(total);
+  std::vector<ProvinceTriangulation> provinceTriangulations;
+  provinceTriangulations.reserve(provinces.size());
+  for (ProvinceHandle i = 0; i < provinces.size(); i++) {
+    auto provinceVertices = provinces.getTriangulatedVertices(i);
+    provinceTriangulations.push_back({i, provinces.getID(i), vertices.size(),
+                                      provinceVertices.size(), durations[i]});
+    vertices.insert(vertices.end(), provinceVertices.begin(),
+                    provinceVertices.end());
+  }
+
+  auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  return MapTriangulation(std::move(vertices),
+                          std::move(provinceTriangulations), duration,
+                          threadCount);
+}
+
+// Triangulates all provinces of the provided store on the worker pool and
+// returns the time each province took. The store keeps the triangulation, so
+// each worker only warms the cache of the provinces it has picked up
+std::vector<std::chrono::microseconds> MapTriangulator::triangulateProvinces(
+    ProvinceStore const& provinces, unsigned int threadCount) {
+  auto start = std::chrono::steady_clock::now();
+  threadCount = getThreadCount(provinces, threadCount);
+
+  std::vector<std::chrono::microseconds> durations(provinces.size());
+  Parallel::forEach(
+      provinces.size(),
+      [&](size_t i) {
+        auto provinceStart = std::chrono::steady_clock::now();
+        provinces.getIndexedMesh((ProvinceHandle)i);
+        durations[i] = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - provinceStart);
+      },
+      threadCount);
+
+  // Log the timings
+  if (Ogre::LogManager::getSingletonPtr() && !provinces.empty()) {
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    auto slowestIt = std::max_element(durations.begin(), durations.end());
+    size_t slowest = (size_t)std::distance(durations.begin(), slowestIt);
+    Ogre::LogManager::getSingletonPtr()->logMessage(
+        (boost::format("Triangulated %d provinces with triangulator '%s' in "
+                       "%d ms using %d threads (slowest province '%s' took "
+                       "%d ms)") %
+         provinces.size() % provinces.getTriangulator().getName() %
+         (duration.count() / 1000) % threadCount %
+         provinces.getID((ProvinceHandle)slowest) %
+         (durations[slowest].count() / 1000))
+            .str());
+  }
+
+  return durations;
+}
+
+// Gets the number of threads to triangulate the provided provinces with. A
+// thread count of 0 means the number of hardware threads, and there are never
+// more threads than provinces
+unsigned int MapTriangulator::getThreadCount(ProvinceStore const& provinces,
+                                             unsigned int threadCount) {
+  if (threadCount == 0) threadCount = Parallel::getDefaultThreadCount();
+  return (unsigned int)std::max<size_t>(
+      1, std::min<size_t>(threadCount, provinces.size()));
+}
+
+}  // namespace openhoi
@@ -0,0 +1,32 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/mesh_quality.hpp"
+
+#include <array>
+#include <cassert>
+
+namespace openhoi {
+
+// Names of the mesh quality presets, in the order of the enumeration
+static const std::array<std::string, MeshQualityCount> meshQualityNames = {
+    "constrained", "refined", "refined-lloyd"};
+
+// Gets the name of the mesh quality preset, e.g. for option files and logs
+std::string const& getMeshQualityName(MeshQuality quality) {
+  assert((int)quality >= 0 && (int)quality < MeshQualityCount);
+  return meshQualityNames[(size_t)quality];
+}
+
+// Parses the name of a mesh quality preset. Returns false and leaves the
+// quality untouched in case the name is unknown
+bool parseMeshQuality(std::string const& name, MeshQuality& quality) {
+  for (size_t i = 0; i < meshQualityNames.size(); i++) {
+    if (meshQualityNames[i] == name) {
+      quality = (MeshQuality)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace openhoi
@@ -0,0 +1,187 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/province_center.hpp"
+
+#include <OgreLogManager.h>
+
+#include <algorithm>
+#include <boost/format.hpp>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <vector>
+
+#include "hoibase/helper/parallel.hpp"
+
+namespace openhoi {
+
+namespace {
+
+// Gets the signed distance of the point to the outline of the rings. The
+// distance is positive inside and negative outside of the province, using the
+// even-odd rule so that nested rings are holes
+double getSignedDistance(ArrayView<ArrayView<Ogre::Vector2>> rings, double x,
+                         double y) {
+  bool inside = false;
+  double minDistance = std::numeric_limits<double>::infinity();
+  for (auto const& ring : rings) {
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+      double ax = ring[i].x, ay = ring[i].y;
+      double bx = ring[j].x, by = ring[j].y;
+
+      // Cast a ray to the right and count the crossed edges
+      if ((ay > y) != (by > y) && x < (bx - ax) * (y - ay) / (by - ay) + ax)
+        inside = !inside;
+
+      // Squared distance to the edge
+      double dx = bx - ax, dy = by - ay;
+      double px = ax, py = ay;
+      double lengthSquared = dx * dx + dy * dy;
+      if (lengthSquared > 0) {
+        double t = ((x - ax) * dx + (y - ay) * dy) / lengthSquared;
+        t = std::max(0.0, std::min(1.0, t));
+        px += dx * t;
+        py += dy * t;
+      }
+      minDistance = std::min(minDistance,
+                             (x - px) * (x - px) + (y - py) * (y - py));
+    }
+  }
+  return (inside ? 1 : -1) * std::sqrt(minDistance);
+}
+
+// Square cell of the grid search
+struct Cell {
+  Cell(ArrayView<ArrayView<Ogre::Vector2>> rings, double x, double y,
+       double halfSize)
+      : x(x),
+        y(y),
+        halfSize(halfSize),
+        distance(getSignedDistance(rings, x, y)),
+        maxDistance(distance + halfSize * std::sqrt(2.0)) {}
+
+  // Orders the cells by the best distance any point inside could have
+  bool operator<(Cell const& other) const {
+    return maxDistance < other.maxDistance;
+  }
+
+  double x;
+  double y;
+  double halfSize;
+  double distance;
+  double maxDistance;
+};
+
+// Gets the area centroid of the rings as a first guess, or the provided
+// fallback if the rings have no area
+Ogre::Vector2 getCentroid(ArrayView<ArrayView<Ogre::Vector2>> rings,
+                          Ogre::Vector2 fallback) {
+  double area = 0, x = 0, y = 0;
+  for (auto const& ring : rings) {
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+      double cross =
+          (double)ring[i].x * ring[j].y - (double)ring[j].x * ring[i].y;
+      x += (ring[i].x + ring[j].x) * cross;
+      y += (ring[i].y + ring[j].y) * cross;
+      area += cross * 3;
+    }
+  }
+  if (area == 0) return fallback;
+  return Ogre::Vector2((Ogre::Real)(x / area), (Ogre::Real)(y / area));
+}
+
+}  // namespace
+
+// Computes the pole of inaccessibility of the provided province rings. Rings
+// inside of other rings are treated as holes. The result is accurate to the
+// provided precision relative to the larger side of the bounding box
+Ogre::Vector2 ProvinceCenter::compute(ArrayView<ArrayView<Ogre::Vector2>> rings,
+                                      double relativePrecision) {
+  // Get the bounding box of all rings
+  const double infinity = std::numeric_limits<double>::infinity();
+  double minX = infinity, minY = infinity, maxX = -infinity, maxY = -infinity;
+  for (auto const& ring : rings) {
+    for (auto const& point : ring) {
+      minX = std::min(minX, (double)point.x);
+      minY = std::min(minY, (double)point.y);
+      maxX = std::max(maxX, (double)point.x);
+      maxY = std::max(maxY, (double)point.y);
+    }
+  }
+  if (minX == infinity) return Ogre::Vector2(0, 0);
+
+  // Degenerated provinces without any area
+  double width = maxX - minX, height = maxY - minY;
+  double cellSize = std::min(width, height);
+  if (cellSize == 0)
+    return Ogre::Vector2((Ogre::Real)(minX + width / 2),
+                         (Ogre::Real)(minY + height / 2));
+  double precision = std::max(width, height) * relativePrecision;
+
+  // Cover the bounding box with square cells
+  std::priority_queue<Cell> queue;
+  double halfSize = cellSize / 2;
+  for (double x = minX; x < maxX; x += cellSize) {
+    for (double y = minY; y < maxY; y += cellSize)
+      queue.push(Cell(rings, x + halfSize, y + halfSize, halfSize));
+  }
+
+  // Start with the centroid or the center of the bounding box, whichever is
+  // farther inside
+  Cell boxCenter(rings, minX + width / 2, minY + height / 2, 0);
+  Ogre::Vector2 centroid = getCentroid(
+      rings, Ogre::Vector2((Ogre::Real)boxCenter.x, (Ogre::Real)boxCenter.y));
+  Cell best(rings, centroid.x, centroid.y, 0);
+  if (boxCenter.distance > best.distance) best = boxCenter;
+
+  // Split the most promising cells until no cell can contain a point that is
+  // farther inside than the best one by more than the precision
+  while (!queue.empty()) {
+    Cell cell = queue.top();
+    queue.pop();
+    if (cell.distance > best.distance) best = cell;
+    if (cell.maxDistance - best.distance <= precision) continue;
+
+    halfSize = cell.halfSize / 2;
+    queue.push(Cell(rings, cell.x - halfSize, cell.y - halfSize, halfSize));
+    queue.push(Cell(rings, cell.x + halfSize, cell.y - halfSize, halfSize));
+    queue.push(Cell(rings, cell.x - halfSize, cell.y + halfSize, halfSize));
+    queue.push(Cell(rings, cell.x + halfSize, cell.y + halfSize, halfSize));
+  }
+
+  return Ogre::Vector2((Ogre::Real)best.x, (Ogre::Real)best.y);
+}
+
+// Computes the centers of all provinces of the provided store in parallel and
+// stores them as province centers. If a thread count of 0 is provided, the
+// number of hardware threads is used.
+void ProvinceCenter::computeCenters(ProvinceStore& provinces,
+                                    unsigned int threadCount) {
+  auto start = std::chrono::steady_clock::now();
+  if (threadCount == 0) threadCount = Parallel::getDefaultThreadCount();
+
+  std::vector<Ogre::Vector2> centers(provinces.size());
+  Parallel::forEach(
+      provinces.size(),
+      [&](size_t i) {
+        centers[i] = compute(provinces.getRings((ProvinceHandle)i));
+      },
+      threadCount);
+  for (ProvinceHandle i = 0; i < provinces.size(); i++)
+    provinces.setCenter(i, centers[i]);
+
+  // Log the timings
+  if (Ogre::LogManager::getSingletonPtr() && !provinces.empty()) {
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    Ogre::LogManager::getSingletonPtr()->logMessage(
+        (boost::format("Computed %d province centers in %d ms using %d "
+                       "threads") %
+         provinces.size() % (duration.count() / 1000) %
+         std::min<size_t>(threadCount, provinces.size()))
+            .str());
+  }
+}
+
+}  // namespace openhoi
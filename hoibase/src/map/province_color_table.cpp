@@ -0,0 +1,82 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/province_color_table.hpp"
+
+#include <OgreHardwarePixelBuffer.h>
+#include <OgrePixelFormat.h>
+#include <OgreTextureManager.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace openhoi {
+
+// Creates the color lookup texture for the provided number of provinces. All
+// provinces start out white
+ProvinceColorTable::ProvinceColorTable(std::string const& name,
+                                       size_t provinceCount,
+                                       std::string const& resourceGroupName)
+    : height(std::max<size_t>((provinceCount + Width - 1) / Width, 1)),
+      texels(Width * height, 0xFFFFFFFF),
+      dirty(true) {
+  texture = Ogre::TextureManager::getSingleton().createManual(
+      name, resourceGroupName, Ogre::TEX_TYPE_2D, (Ogre::uint)Width,
+      (Ogre::uint)height, 0, Ogre::PF_BYTE_RGBA,
+      Ogre::TU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+  upload();
+}
+
+// Removes the color lookup texture
+ProvinceColorTable::~ProvinceColorTable() {
+  if (texture && Ogre::TextureManager::getSingletonPtr())
+    Ogre::TextureManager::getSingleton().remove(texture);
+}
+
+// Sets the color of the province. The change becomes visible with the next
+// upload
+void ProvinceColorTable::setColor(ProvinceHandle province,
+                                  Ogre::ColourValue const& color) {
+  assert(province < texels.size());
+  uint32_t texel;
+  Ogre::PixelUtil::packColour(color, Ogre::PF_BYTE_RGBA, &texel);
+  if (texels[province] == texel) return;
+  texels[province] = texel;
+  dirty = true;
+}
+
+// Gets the color of the province
+Ogre::ColourValue ProvinceColorTable::getColor(ProvinceHandle province) const {
+  assert(province < texels.size());
+  Ogre::ColourValue color;
+  Ogre::PixelUtil::unpackColour(&color, Ogre::PF_BYTE_RGBA, &texels[province]);
+  return color;
+}
+
+// Uploads the colors to the texture if any of them changed since the last
+// upload
+void ProvinceColorTable::upload() {
+  if (!dirty) return;
+  Ogre::PixelBox box((Ogre::uint32)Width, (Ogre::uint32)height, 1,
+                     Ogre::PF_BYTE_RGBA, texels.data());
+  texture->getBuffer()->blitFromMemory(box);
+  dirty = false;
+}
+
+// Binds the color lookup texture to the texture units named 'colorTable' in all
+// techniques and passes of the provided material, e.g. the map material. Ogre
+// picks the technique by render system, so every one of them needs the texture
+void ProvinceColorTable::bind(Ogre::MaterialPtr const& material) const {
+  for (Ogre::Technique* technique : material->getTechniques()) {
+    for (Ogre::Pass* pass : technique->getPasses()) {
+      Ogre::TextureUnitState* unit = pass->getTextureUnitState("colorTable");
+      if (unit) unit->setTexture(texture);
+    }
+  }
+}
+
+// Gets the color lookup texture
+Ogre::TexturePtr const& ProvinceColorTable::getTexture() const {
+  return texture;
+}
+
+}  // namespace openhoi
@@ -0,0 +1,243 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/province_store.hpp"
+
+#include <cassert>
+#include <memory>
+
+#include "hoibase/map/cgal_triangulator.hpp"
+
+namespace openhoi {
+
+// Province store constructor
+ProvinceStore::ProvinceStore()
+    : totalPointCount(0), triangulator(std::make_shared<CGALTriangulator>()) {
+  ringOffsets.push_back(0);
+}
+
+// Adds a province and returns its handle. The province ID must be unique
+ProvinceHandle ProvinceStore::add(std::string id,
+                                  ArrayView<ArrayView<Ogre::Vector2>> rings,
+                                  Ogre::Vector2 center) {
+  // Check for duplicate provinces
+  assert(index.find(id) == index.end());
+
+  // Copy the points of all rings into one contiguous arena allocation
+  ProvinceHandle handle = (ProvinceHandle)ids.size();
+  size_t provincePointCount = 0;
+  for (auto const& ring : rings) provincePointCount += ring.size();
+  Ogre::Vector2* points = arena.allocate<Ogre::Vector2>(provincePointCount);
+  for (auto const& ring : rings) {
+    std::uninitialized_copy(ring.begin(), ring.end(), points);
+    this->rings.push_back(ArrayView<Ogre::Vector2>(points, ring.size()));
+    points += ring.size();
+  }
+  ringOffsets.push_back((uint32_t)this->rings.size());
+  totalPointCount += provincePointCount;
+
+  // Add the province columns
+  index.insert({id, handle});
+  ids.push_back(std::move(id));
+  centers.push_back(center);
+  meshes.emplace_back();
+  triangulated.push_back(0);
+
+  return handle;
+}
+
+// Replaces the rings of the province and drops its triangulation. The new
+// points are copied into the arena, the memory of the old points is only
+// released together with the store
+void ProvinceStore::setRings(ProvinceHandle province,
+                             ArrayView<ArrayView<Ogre::Vector2>> rings) {
+  assert(province < ids.size());
+
+  // Copy the points of all rings into one contiguous arena allocation
+  size_t provincePointCount = 0;
+  for (auto const& ring : rings) provincePointCount += ring.size();
+  Ogre::Vector2* points = arena.allocate<Ogre::Vector2>(provincePointCount);
+  std::vector<ArrayView<Ogre::Vector2>> views;
+  views.reserve(rings.size());
+  for (auto const& ring : rings) {
+    std::uninitialized_copy(ring.begin(), ring.end(), points);
+    views.push_back(ArrayView<Ogre::Vector2>(points, ring.size()));
+    points += ring.size();
+  }
+  totalPointCount -= getPoints(province).size();
+  totalPointCount += provincePointCount;
+
+  // Replace the ring views of the province and move the ring offsets of all
+  // following provinces by the difference in ring count
+  int64_t difference = (int64_t)views.size() - (int64_t)getRingCount(province);
+  auto first = this->rings.begin() + ringOffsets[province];
+  auto last = this->rings.begin() + ringOffsets[province + 1];
+  first = this->rings.erase(first, last);
+  this->rings.insert(first, views.begin(), views.end());
+  for (size_t i = province + 1; i < ringOffsets.size(); i++)
+    ringOffsets[i] = (uint32_t)(ringOffsets[i] + difference);
+
+  invalidateTriangulation(province);
+}
+
+// Reserves memory for the provided number of provinces, rings and points
+void ProvinceStore::reserve(size_t provinceCount, size_t ringCount,
+                            size_t pointCount) {
+  ids.reserve(provinceCount);
+  centers.reserve(provinceCount);
+  ringOffsets.reserve(provinceCount + 1);
+  rings.reserve(ringCount);
+  arena.reserve(pointCount * sizeof(Ogre::Vector2));
+  meshes.reserve(provinceCount);
+  triangulated.reserve(provinceCount);
+  index.reserve(provinceCount);
+}
+
+// Gets the number of provinces
+size_t ProvinceStore::size() const { return ids.size(); }
+
+// Checks if the store has no provinces
+bool ProvinceStore::empty() const { return ids.empty(); }
+
+// Gets the handle of the province with the provided ID or InvalidProvinceHandle
+// if it does not exist
+ProvinceHandle ProvinceStore::find(std::string const& id) const {
+  auto it = index.find(id);
+  return it != index.end() ? it->second : InvalidProvinceHandle;
+}
+
+// Gets the province ID
+std::string const& ProvinceStore::getID(ProvinceHandle province) const {
+  assert(province < ids.size());
+  return ids[province];
+}
+
+// Gets the province center point
+Ogre::Vector2 const& ProvinceStore::getCenter(ProvinceHandle province) const {
+  assert(province < centers.size());
+  return centers[province];
+}
+
+// Sets the province center point
+void ProvinceStore::setCenter(ProvinceHandle province, Ogre::Vector2 center) {
+  assert(province < centers.size());
+  centers[province] = center;
+}
+
+// Gets the number of rings of the province
+size_t ProvinceStore::getRingCount(ProvinceHandle province) const {
+  assert(province < ids.size());
+  return ringOffsets[province + 1] - ringOffsets[province];
+}
+
+// Gets the points of one ring of the province
+ArrayView<Ogre::Vector2> ProvinceStore::getRing(ProvinceHandle province,
+                                                size_t ring) const {
+  assert(ring < getRingCount(province));
+  return rings[ringOffsets[province] + ring];
+}
+
+// Gets the rings of the province
+ArrayView<ArrayView<Ogre::Vector2>> ProvinceStore::getRings(
+    ProvinceHandle province) const {
+  assert(province < ids.size());
+  return ArrayView<ArrayView<Ogre::Vector2>>(
+      rings.data() + ringOffsets[province], getRingCount(province));
+}
+
+// Gets the points of all rings of the province
+ArrayView<Ogre::Vector2> ProvinceStore::getPoints(
+    ProvinceHandle province) const {
+  assert(province < ids.size());
+  size_t count = 0;
+  for (auto const& ring : getRings(province)) count += ring.size();
+  if (count == 0) return ArrayView<Ogre::Vector2>();
+  return ArrayView<Ogre::Vector2>(getRing(province, 0).begin(), count);
+}
+
+// Gets the index of the first ring of every province, followed by the total
+// number of rings
+std::vector<uint32_t> const& ProvinceStore::getRingOffsets() const {
+  return ringOffsets;
+}
+
+// Gets the rings of all provinces
+std::vector<ArrayView<Ogre::Vector2>> const& ProvinceStore::getRings() const {
+  return rings;
+}
+
+// Gets the number of points of all provinces
+size_t ProvinceStore::getPointCount() const { return totalPointCount; }
+
+// Gets the arena that owns the points of all provinces
+MonotonicArena const& ProvinceStore::getArena() const { return arena; }
+
+// Gets the mesh quality the provinces are triangulated with
+MeshQuality ProvinceStore::getMeshQuality() const {
+  return triangulator->getMeshQuality();
+}
+
+// Sets the mesh quality the provinces are triangulated with by switching to the
+// CGAL triangulator. Changing it drops the triangulations of all provinces
+void ProvinceStore::setMeshQuality(MeshQuality quality) {
+  if (quality == getMeshQuality() &&
+      dynamic_cast<CGALTriangulator const*>(triangulator.get()))
+    return;
+  setTriangulator(std::make_shared<CGALTriangulator>(quality));
+}
+
+// Gets the triangulator the provinces are triangulated with
+Triangulator const& ProvinceStore::getTriangulator() const {
+  return *triangulator;
+}
+
+// Sets the triangulator the provinces are triangulated with. This drops the
+// triangulations of all provinces
+void ProvinceStore::setTriangulator(
+    std::shared_ptr<Triangulator const> triangulator) {
+  assert(triangulator);
+  this->triangulator = std::move(triangulator);
+  for (ProvinceHandle i = 0; i < ids.size(); i++) invalidateTriangulation(i);
+}
+
+// Gets the triangulated province as indexed mesh with unique vertices. The
+// province is triangulated on first access and the mesh is kept until the
+// triangulation is invalidated
+IndexedMesh const& ProvinceStore::getIndexedMesh(
+    ProvinceHandle province) const {
+  assert(province < ids.size());
+  if (!triangulated[province]) {
+    meshes[province] = IndexedMesh::fromTriangles(
+        triangulator->triangulate(getRings(province)));
+    triangulated[province] = 1;
+  }
+  return meshes[province];
+}
+
+// Gets the vertices of the triangulated province as triangle list. It is
+// expanded out of the kept indexed mesh on every call
+std::vector<Ogre::Real> ProvinceStore::getTriangulatedVertices(
+    ProvinceHandle province) const {
+  return getIndexedMesh(province).toTriangles();
+}
+
+// Sets the triangulated province, e.g. when it was restored from a cache
+void ProvinceStore::setIndexedMesh(ProvinceHandle province, IndexedMesh mesh) {
+  assert(province < ids.size());
+  meshes[province] = std::move(mesh);
+  triangulated[province] = 1;
+}
+
+// Sets the vertices of the triangulated province. They are kept as indexed mesh
+void ProvinceStore::setTriangulatedVertices(
+    ProvinceHandle province, std::vector<Ogre::Real> const& vertices) {
+  setIndexedMesh(province, IndexedMesh::fromTriangles(vertices));
+}
+
+// Drops the cached triangulation so that it is rebuilt on next access
+void ProvinceStore::invalidateTriangulation(ProvinceHandle province) {
+  assert(province < ids.size());
+  meshes[province] = IndexedMesh();
+  triangulated[province] = 0;
+}
+
+}  // namespace openhoi
@@ -0,0 +1,178 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/spatial_index.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace openhoi {
+
+// Upper limit of grid columns and rows
+static const size_t maxGridSize = 4096;
+
+// Builds the spatial index over all provinces of the provided store. The store
+// must outlive the index and must not change while the index is used. If a
+// cell count of 0 is provided, the grid gets about one cell per province.
+SpatialIndex::SpatialIndex(ProvinceStore const& provinces, size_t cellCount)
+    : provinces(provinces) {
+  // Compute the bounding boxes of all provinces and of the whole map
+  const Ogre::Real infinity = std::numeric_limits<Ogre::Real>::infinity();
+  bounds = {Ogre::Vector2(infinity, infinity),
+            Ogre::Vector2(-infinity, -infinity)};
+  provinceBounds.reserve(provinces.size());
+  for (ProvinceHandle i = 0; i < provinces.size(); i++) {
+    BoundingBox box = {Ogre::Vector2(infinity, infinity),
+                       Ogre::Vector2(-infinity, -infinity)};
+    for (auto const& point : provinces.getPoints(i)) {
+      box.min.x = std::min(box.min.x, point.x);
+      box.min.y = std::min(box.min.y, point.y);
+      box.max.x = std::max(box.max.x, point.x);
+      box.max.y = std::max(box.max.y, point.y);
+    }
+    provinceBounds.push_back(box);
+    bounds.min.x = std::min(bounds.min.x, box.min.x);
+    bounds.min.y = std::min(bounds.min.y, box.min.y);
+    bounds.max.x = std::max(bounds.max.x, box.max.x);
+    bounds.max.y = std::max(bounds.max.y, box.max.y);
+  }
+  if (bounds.min.x > bounds.max.x)
+    bounds = {Ogre::Vector2(0, 0), Ogre::Vector2(0, 0)};
+
+  // Size the grid so that its cells are roughly square
+  if (cellCount == 0) cellCount = std::max<size_t>(provinces.size(), 1);
+  Ogre::Real width = std::max<Ogre::Real>(bounds.max.x - bounds.min.x, 1e-6f);
+  Ogre::Real height = std::max<Ogre::Real>(bounds.max.y - bounds.min.y, 1e-6f);
+  columns = (size_t)std::ceil(std::sqrt((double)cellCount * width / height));
+  columns = std::min(std::max<size_t>(columns, 1), maxGridSize);
+  rows = std::min(std::max<size_t>((cellCount + columns - 1) / columns, 1),
+                  maxGridSize);
+  cellSize = Ogre::Vector2(width / (Ogre::Real)columns,
+                           height / (Ogre::Real)rows);
+
+  // Count the provinces per cell, then fill the cells in a second pass so that
+  // all of them share one array
+  cellOffsets.assign(columns * rows + 1, 0);
+  for (int pass = 0; pass < 2; pass++) {
+    if (pass == 1) {
+      for (size_t cell = 1; cell < cellOffsets.size(); cell++)
+        cellOffsets[cell] += cellOffsets[cell - 1];
+      cellProvinces.resize(cellOffsets.back());
+    }
+    for (ProvinceHandle i = 0; i < provinces.size(); i++) {
+      auto const& box = provinceBounds[i];
+      if (box.min.x > box.max.x) continue;
+      for (size_t row = getRow(box.min.y); row <= getRow(box.max.y); row++) {
+        for (size_t column = getColumn(box.min.x);
+             column <= getColumn(box.max.x); column++) {
+          size_t cell = row * columns + column;
+          if (pass == 0)
+            cellOffsets[cell + 1]++;
+          else
+            cellProvinces[cellOffsets[cell]++] = i;
+        }
+      }
+    }
+  }
+
+  // The fill pass moved every offset to the end of its cell, so shift them back
+  for (size_t cell = cellOffsets.size() - 1; cell > 0; cell--)
+    cellOffsets[cell] = cellOffsets[cell - 1];
+  cellOffsets[0] = 0;
+}
+
+// Gets the province that contains the provided point or InvalidProvinceHandle
+// if the point is not inside of any province
+ProvinceHandle SpatialIndex::pick(Ogre::Vector2 const& point) const {
+  if (point.x < bounds.min.x || point.x > bounds.max.x ||
+      point.y < bounds.min.y || point.y > bounds.max.y)
+    return InvalidProvinceHandle;
+
+  // Only test the provinces of the cell below the point
+  size_t cell = getRow(point.y) * columns + getColumn(point.x);
+  for (uint32_t i = cellOffsets[cell]; i < cellOffsets[cell + 1]; i++) {
+    ProvinceHandle province = cellProvinces[i];
+    auto const& box = provinceBounds[province];
+    if (point.x >= box.min.x && point.x <= box.max.x && point.y >= box.min.y &&
+        point.y <= box.max.y && contains(provinces, province, point))
+      return province;
+  }
+  return InvalidProvinceHandle;
+}
+
+// Gets all provinces whose bounding box intersects the provided rectangle, e.g.
+// to cull the provinces outside of the view
+std::vector<ProvinceHandle> SpatialIndex::query(
+    Ogre::Vector2 const& min, Ogre::Vector2 const& max) const {
+  std::vector<ProvinceHandle> result;
+  if (max.x < bounds.min.x || min.x > bounds.max.x || max.y < bounds.min.y ||
+      min.y > bounds.max.y)
+    return result;
+
+  size_t firstColumn = getColumn(min.x), lastColumn = getColumn(max.x);
+  size_t firstRow = getRow(min.y), lastRow = getRow(max.y);
+  for (size_t row = firstRow; row <= lastRow; row++) {
+    for (size_t column = firstColumn; column <= lastColumn; column++) {
+      size_t cell = row * columns + column;
+      for (uint32_t i = cellOffsets[cell]; i < cellOffsets[cell + 1]; i++) {
+        ProvinceHandle province = cellProvinces[i];
+        auto const& box = provinceBounds[province];
+        if (box.max.x < min.x || box.min.x > max.x || box.max.y < min.y ||
+            box.min.y > max.y)
+          continue;
+
+        // A province spanning multiple cells is only reported by the cell
+        // that holds the lower left corner of its overlap with the rectangle
+        if (getColumn(std::max(box.min.x, min.x)) == column &&
+            getRow(std::max(box.min.y, min.y)) == row)
+          result.push_back(province);
+      }
+    }
+  }
+  return result;
+}
+
+// Gets the bounding box of the province
+BoundingBox const& SpatialIndex::getBounds(ProvinceHandle province) const {
+  assert(province < provinceBounds.size());
+  return provinceBounds[province];
+}
+
+// Gets the bounding box of all provinces
+BoundingBox const& SpatialIndex::getBounds() const { return bounds; }
+
+// Checks if the provided point is inside of the province. Rings are treated as
+// closed and the even-odd rule is used, so holes are excluded
+bool SpatialIndex::contains(ProvinceStore const& provinces,
+                            ProvinceHandle province,
+                            Ogre::Vector2 const& point) {
+  bool inside = false;
+  for (auto const& ring : provinces.getRings(province)) {
+    size_t count = ring.size();
+    for (size_t i = 0, j = count - 1; i < count; j = i++) {
+      auto const& a = ring[i];
+      auto const& b = ring[j];
+      if ((a.y > point.y) != (b.y > point.y) &&
+          point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x)
+        inside = !inside;
+    }
+  }
+  return inside;
+}
+
+// Gets the grid column of the provided x coordinate, clamped to the grid
+size_t SpatialIndex::getColumn(Ogre::Real x) const {
+  Ogre::Real column = std::floor((x - bounds.min.x) / cellSize.x);
+  if (column <= 0) return 0;
+  return std::min((size_t)column, columns - 1);
+}
+
+// Gets the grid row of the provided y coordinate, clamped to the grid
+size_t SpatialIndex::getRow(Ogre::Real y) const {
+  Ogre::Real row = std::floor((y - bounds.min.y) / cellSize.y);
+  if (row <= 0) return 0;
+  return std::min((size_t)row, rows - 1);
+}
+
+}  // namespace openhoi
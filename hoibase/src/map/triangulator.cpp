@@ -0,0 +1,16 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include "hoibase/map/triangulator.hpp"
+
+namespace openhoi {
+
+// Appends a vertex in map coordinates out of the provided longitude and
+// latitude
+void Triangulator::appendVertex(std::vector<Ogre::Real>& vertices, double x,
+                                double y) {
+  vertices.push_back((Ogre::Real)(x / 180));
+  vertices.push_back((Ogre::Real)(y / 85));
+  vertices.push_back(0);
+}
+
+}  // namespace openhoi
@@ -0,0 +1,107 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <hoibase/file/asset_archive.hpp>
+#include <hoibase/file/asset_archive_builder.hpp>
+#include <hoibase/file/file_access.hpp>
+#include <string>
+#include <vector>
+
+namespace openhoi {
+
+// Test packing an asset directory into an archive and reading it back
+TEST(Hoibase, FileAssetArchive) {
+  filesystem::path root =
+      FileAccess::getTempDirectory() / "openhoi_asset_archive_test";
+  filesystem::remove_all(root);
+  filesystem::create_directories(root / "graphics" / "flags");
+  std::string compressible(1 << 16, 'a');
+  std::string incompressible = "xyz";
+  auto writeFile = [&root](filesystem::path name, std::string const& content) {
+    std::ofstream ofs(root / name, std::ios::binary);
+    ofs << content;
+  };
+  writeFile("graphics/flags/ger.png", compressible);
+  writeFile("graphics/logo.png", incompressible);
+  writeFile("empty.txt", "");
+
+  // The archive inside the asset root is not packed into itself
+  filesystem::path file = root / OPENHOI_ASSET_ARCHIVE_FILE;
+  ASSERT_TRUE(AssetArchiveBuilder::build(root, file));
+  ASSERT_TRUE(AssetArchiveBuilder::build(root, file));
+  AssetArchive archive(file);
+  ASSERT_TRUE(archive.isOpen());
+  ASSERT_EQ(archive.getEntryCount(), 3u);
+
+  // The index is sorted by name
+  EXPECT_EQ(archive.getName(archive.getEntry(0)), "empty.txt");
+  EXPECT_EQ(archive.getName(archive.getEntry(1)), "graphics/flags/ger.png");
+  EXPECT_EQ(archive.getName(archive.getEntry(2)), "graphics/logo.png");
+
+  // Only entries that get smaller are compressed
+  auto compressed = archive.find("graphics/flags/ger.png");
+  ASSERT_NE(compressed, nullptr);
+  EXPECT_TRUE(compressed->flags & OPENHOI_ASSET_ARCHIVE_ZLIB);
+  EXPECT_LT(compressed->storedSize, compressed->size);
+  EXPECT_EQ(archive.getStoredData(*compressed), nullptr);
+  auto stored = archive.find("graphics/logo.png");
+  ASSERT_NE(stored, nullptr);
+  ASSERT_NE(archive.getStoredData(*stored), nullptr);
+  EXPECT_EQ(memcmp(archive.getStoredData(*stored), incompressible.data(),
+                   incompressible.size()),
+            0);
+  EXPECT_EQ(archive.find("graphics"), nullptr);
+  EXPECT_EQ(archive.find("missing.png"), nullptr);
+
+  std::vector<unsigned char> data;
+  ASSERT_TRUE(archive.read("graphics/flags/ger.png", data));
+  EXPECT_EQ(std::string(data.begin(), data.end()), compressible);
+  ASSERT_TRUE(archive.read("empty.txt", data));
+  EXPECT_TRUE(data.empty());
+  EXPECT_FALSE(archive.read("missing.png", data));
+
+  // Directories are listed with or without their subdirectories
+  EXPECT_EQ(archive.list("graphics", false),
+            std::vector<std::string>({"graphics/logo.png"}));
+  EXPECT_EQ(archive.list("graphics/", true),
+            std::vector<std::string>(
+                {"graphics/flags/ger.png", "graphics/logo.png"}));
+  EXPECT_EQ(archive.list("", false), std::vector<std::string>({"empty.txt"}));
+  EXPECT_TRUE(archive.list("sounds", true).empty());
+
+  // Level 0 stores every entry as is
+  ASSERT_TRUE(AssetArchiveBuilder::build(root, file, 0));
+  EXPECT_FALSE(AssetArchive(file).find("graphics/flags/ger.png")->flags &
+               OPENHOI_ASSET_ARCHIVE_ZLIB);
+
+  // Files that are no archive are rejected
+  EXPECT_FALSE(AssetArchive(root / "graphics" / "logo.png").isOpen());
+  EXPECT_EQ(AssetArchive::open(root / "empty.txt"), nullptr);
+
+  // Archives that could not be opened are not remembered, so they are picked
+  // up once they were built
+  filesystem::path later = root / "later.ohpk";
+  EXPECT_EQ(AssetArchive::open(later), nullptr);
+  ASSERT_TRUE(AssetArchiveBuilder::build(root, later));
+  auto shared = AssetArchive::open(later);
+  ASSERT_NE(shared, nullptr);
+
+  // Opened archives are shared while they are in use, afterwards a rebuilt
+  // archive is opened again
+  EXPECT_EQ(AssetArchive::open(later), shared);
+  size_t entryCount = shared->getEntryCount();
+  shared.reset();
+  writeFile("extra.txt", "extra");
+  ASSERT_TRUE(AssetArchiveBuilder::build(root, later));
+  shared = AssetArchive::open(later);
+  ASSERT_NE(shared, nullptr);
+  EXPECT_EQ(shared->getEntryCount(), entryCount + 1);
+  shared.reset();
+
+  filesystem::remove_all(root);
+}
+
+}  // namespace openhoi
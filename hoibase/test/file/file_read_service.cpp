@@ -0,0 +1,99 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <hoibase/file/file_access.hpp>
+#include <hoibase/file/file_read_service.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openhoi {
+
+// Test reading files asynchronously through futures and callbacks
+TEST(Hoibase, FileReadService) {
+  filesystem::path path =
+      FileAccess::getTempDirectory() / "openhoi_file_read_service_test.bin";
+  std::string content(1 << 16, 'r');
+  {
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << content;
+  }
+  filesystem::path missing =
+      FileAccess::getTempDirectory() / "openhoi_file_read_service_missing.bin";
+  filesystem::remove(missing);
+
+  FileReadService service(2);
+
+  // Futures receive the file or nullptr if it cannot be read
+  auto file = service.read(path, FileReadPriority::High).get();
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(file->getSize(), content.size());
+  EXPECT_EQ(memcmp(file->getData(), content.data(), content.size()), 0);
+  EXPECT_EQ(service.read(missing).get(), nullptr);
+
+  // Callbacks are only invoked on dispatch
+  size_t size = 0;
+  bool missingRead = false;
+  service.read(path, [&size](std::unique_ptr<MappedFile> file) {
+    if (file) size = file->getSize();
+  });
+  service.read(
+      missing,
+      [&missingRead](std::unique_ptr<MappedFile> file) {
+        missingRead = file == nullptr;
+      },
+      FileReadPriority::Low);
+  while (service.getPendingCount() > 0) std::this_thread::yield();
+  EXPECT_EQ(size, 0u);
+  EXPECT_EQ(service.dispatch(), 2u);
+  EXPECT_EQ(size, content.size());
+  EXPECT_TRUE(missingRead);
+  EXPECT_EQ(service.dispatch(), 0u);
+
+  file.reset();
+  filesystem::remove(path);
+}
+
+// Test that queued reads are started by priority first and in the order they
+// were queued second
+TEST(Hoibase, FileReadServicePriority) {
+  filesystem::path path = FileAccess::getTempDirectory() /
+                          "openhoi_file_read_service_priority_test.bin";
+  {
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << "priority";
+  }
+
+  // Queue all reads while the only I/O thread is paused, so that none of them
+  // is started before the others were queued
+  FileReadService service(1);
+  service.pause();
+  std::vector<std::string> order;
+  auto queue = [&](std::string name, FileReadPriority priority) {
+    service.read(
+        path,
+        [&order, name](std::unique_ptr<MappedFile>) { order.push_back(name); },
+        priority);
+  };
+  queue("low1", FileReadPriority::Low);
+  queue("normal1", FileReadPriority::Normal);
+  queue("high1", FileReadPriority::High);
+  queue("low2", FileReadPriority::Low);
+  queue("normal2", FileReadPriority::Normal);
+  queue("high2", FileReadPriority::High);
+  EXPECT_EQ(service.getPendingCount(), 6u);
+
+  // A single I/O thread finishes the reads in the order it started them
+  service.resume();
+  while (service.getPendingCount() > 0) std::this_thread::yield();
+  EXPECT_EQ(service.dispatch(), 6u);
+  EXPECT_EQ(order, std::vector<std::string>({"high1", "high2", "normal1",
+                                             "normal2", "low1", "low2"}));
+
+  filesystem::remove(path);
+}
+
+}  // namespace openhoi
@@ -0,0 +1,40 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <hoibase/file/file_access.hpp>
+#include <hoibase/file/file_watcher.hpp>
+
+namespace openhoi {
+
+// Test that writing and replacing a watched file is noticed
+TEST(Hoibase, FileWatcher) {
+  filesystem::path path =
+      FileAccess::getTempDirectory() / "openhoi_file_watcher_test.txt";
+  filesystem::path other =
+      FileAccess::getTempDirectory() / "openhoi_file_watcher_other.txt";
+  filesystem::remove(path);
+
+  FileWatcher watcher(path);
+  EXPECT_EQ(watcher.getPath(), path);
+  EXPECT_FALSE(watcher.poll());
+
+  // Create the file
+  { std::ofstream(path) << "first"; }
+  EXPECT_TRUE(watcher.poll());
+  EXPECT_FALSE(watcher.poll());
+
+  // Writing other files in the same directory is ignored
+  { std::ofstream(other) << "other"; }
+  EXPECT_FALSE(watcher.poll());
+
+  // Replace the file by renaming another file over it, like editors do
+  filesystem::rename(other, path);
+  EXPECT_TRUE(watcher.poll());
+  EXPECT_FALSE(watcher.poll());
+
+  filesystem::remove(path);
+}
+
+}  // namespace openhoi
@@ -0,0 +1,63 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <hoibase/file/file_access.hpp>
+#include <hoibase/file/mapped_file.hpp>
+
+namespace openhoi {
+
+// Test mapping a file into memory
+TEST(Hoibase, FileMappedFile) {
+  filesystem::path path =
+      FileAccess::getTempDirectory() / "openhoi_mapped_file_test.bin";
+  std::string content = "openhoi mapped file content";
+  {
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << content;
+  }
+
+  {
+    MappedFile file(path);
+    ASSERT_TRUE(file.isOpen());
+    ASSERT_EQ(file.getSize(), content.size());
+    EXPECT_EQ(memcmp(file.getData(), content.data(), content.size()), 0);
+  }
+
+  filesystem::remove(path);
+
+  MappedFile missing(path);
+  EXPECT_FALSE(missing.isOpen());
+  EXPECT_EQ(missing.getData(), nullptr);
+}
+
+// Test mapping a file through the file access with access pattern hints
+TEST(Hoibase, FileMapFile) {
+  filesystem::path path =
+      FileAccess::getTempDirectory() / "openhoi_map_file_test.bin";
+  std::string content(1 << 16, 'x');
+  {
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << content;
+  }
+
+  auto file = FileAccess::mapFile(path, MappedFileAccess::Random);
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(file->getSize(), content.size());
+  EXPECT_EQ(memcmp(file->getData(), content.data(), content.size()), 0);
+
+  // Changing the access pattern keeps the mapping intact
+  file->advise(MappedFileAccess::Sequential);
+  EXPECT_EQ(file->getData()[content.size() - 1], 'x');
+  file.reset();
+
+  // Empty and missing files cannot be mapped
+  { std::ofstream ofs(path, std::ios::binary | std::ios::trunc); }
+  EXPECT_EQ(FileAccess::mapFile(path), nullptr);
+  filesystem::remove(path);
+  EXPECT_EQ(FileAccess::mapFile(path), nullptr);
+}
+
+}  // namespace openhoi
@@ -0,0 +1,45 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <hoibase/helper/monotonic_arena.hpp>
+
+namespace openhoi {
+
+// Test that the arena serves aligned allocations out of few blocks
+TEST(Hoibase, HelperMonotonicArena) {
+  MonotonicArena arena(1024);
+  EXPECT_EQ(arena.getBlockCount(), 0u);
+
+  // Small allocations share one block and keep their alignment
+  char* c = arena.allocate<char>(3);
+  double* d = arena.allocate<double>(4);
+  EXPECT_EQ((uintptr_t)d % alignof(double), 0u);
+  EXPECT_GE((char*)d, c + 3);
+  for (int i = 0; i < 4; i++) d[i] = i;
+  EXPECT_EQ(arena.getBlockCount(), 1u);
+  EXPECT_EQ(arena.getAllocatedSize(), 3 + 4 * sizeof(double));
+
+  // Allocations that are larger than a block get their own block
+  uint32_t* large = arena.allocate<uint32_t>(1000);
+  large[999] = 42;
+  EXPECT_EQ(arena.getBlockCount(), 2u);
+  EXPECT_GE(arena.getCapacity(), 1024 + 1000 * sizeof(uint32_t));
+
+  // Reserved memory is served from a single block
+  arena.reserve(4096);
+  size_t blocks = arena.getBlockCount();
+  arena.allocate<char>(2048);
+  arena.allocate<char>(2048);
+  EXPECT_EQ(arena.getBlockCount(), blocks);
+
+  // Moving the arena keeps the memory in place
+  MonotonicArena moved(std::move(arena));
+  EXPECT_EQ(d[3], 3.0);
+  EXPECT_EQ(large[999], 42u);
+  EXPECT_EQ(moved.getBlockCount(), blocks);
+  EXPECT_EQ(arena.getBlockCount(), 0u);
+}
+
+}  // namespace openhoi
@@ -0,0 +1,59 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <hoibase/map/adjacency_graph.hpp>
+
+namespace openhoi {
+
+// Adds a square province with the provided lower left corner and side length
+static ProvinceHandle addSquare(ProvinceStore& store, std::string id,
+                                Ogre::Real x, Ogre::Real y, Ogre::Real size,
+                                std::vector<Ogre::Vector2> const* hole) {
+  auto outer = std::vector<Ogre::Vector2>();
+  outer.push_back(Ogre::Vector2(x, y));
+  outer.push_back(Ogre::Vector2(x + size, y));
+  outer.push_back(Ogre::Vector2(x + size, y + size));
+  outer.push_back(Ogre::Vector2(x, y + size));
+  std::vector<ArrayView<Ogre::Vector2>> rings = {outer};
+  if (hole) rings.push_back(*hole);
+  return store.add(std::move(id), rings, Ogre::Vector2(0, 0));
+}
+
+// Test that provinces sharing border edges become neighbours
+TEST(Hoibase, MapAdjacencyGraph) {
+  // A 2x2 grid of squares, where the lower left one has a hole that is filled
+  // by a lake province. The island far away has no neighbours
+  auto hole = std::vector<Ogre::Vector2>();
+  hole.push_back(Ogre::Vector2(0.25f, 0.25f));
+  hole.push_back(Ogre::Vector2(0.25f, 0.75f));
+  hole.push_back(Ogre::Vector2(0.75f, 0.75f));
+  hole.push_back(Ogre::Vector2(0.75f, 0.25f));
+
+  ProvinceStore store;
+  ProvinceHandle lowerLeft = addSquare(store, "LL", 0, 0, 1, &hole);
+  ProvinceHandle lowerRight = addSquare(store, "LR", 1, 0, 1, nullptr);
+  ProvinceHandle upperLeft = addSquare(store, "UL", 0, 1, 1, nullptr);
+  ProvinceHandle upperRight = addSquare(store, "UR", 1, 1, 1, nullptr);
+  ProvinceHandle lake = addSquare(store, "LK", 0.25f, 0.25f, 0.5f, nullptr);
+  ProvinceHandle island = addSquare(store, "IS", 10, 10, 1, nullptr);
+
+  AdjacencyGraph graph(store);
+  ASSERT_EQ(graph.size(), 6u);
+  EXPECT_EQ(graph.getEdgeCount(), 5u);
+
+  auto neighbours = graph.getNeighbours(lowerLeft);
+  ASSERT_EQ(neighbours.size(), 3u);
+  EXPECT_EQ(neighbours[0], lowerRight);
+  EXPECT_EQ(neighbours[1], upperLeft);
+  EXPECT_EQ(neighbours[2], lake);
+
+  // Provinces touching in a single corner are no neighbours
+  EXPECT_TRUE(graph.areNeighbours(upperRight, upperLeft));
+  EXPECT_TRUE(graph.areNeighbours(upperLeft, upperRight));
+  EXPECT_FALSE(graph.areNeighbours(upperRight, lowerLeft));
+  EXPECT_FALSE(graph.areNeighbours(lowerRight, upperLeft));
+  EXPECT_TRUE(graph.getNeighbours(island).empty());
+}
+
+}  // namespace openhoi
@@ -0,0 +1,137 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <hoibase/map/ear_clip_triangulator.hpp>
+
+#include "test_rings.hpp"
+
+namespace openhoi {
+
+namespace {
+
+// Gets the area covered by the triangles in longitude and latitude. Returns a
+// negative value if any triangle is clockwise
+double getCoveredArea(std::vector<Ogre::Real> const& triangles) {
+  double sum = 0;
+  for (size_t i = 0; i + 8 < triangles.size(); i += 9) {
+    double area = ((triangles[i + 3] - triangles[i]) *
+                       (triangles[i + 7] - triangles[i + 1]) -
+                   (triangles[i + 6] - triangles[i]) *
+                       (triangles[i + 4] - triangles[i + 1])) *
+                  180 * 85 / 2;
+    if (area < 0) return -1;
+    sum += area;
+  }
+  return sum;
+}
+
+// Creates an axis-aligned square ring
+std::vector<Ogre::Vector2> createSquare(Ogre::Real x, Ogre::Real y,
+                                        Ogre::Real size, bool clockwise) {
+  std::vector<Ogre::Vector2> ring = {
+      Ogre::Vector2(x, y), Ogre::Vector2(x + size, y),
+      Ogre::Vector2(x + size, y + size), Ogre::Vector2(x, y + size)};
+  if (clockwise) std::reverse(ring.begin(), ring.end());
+  return ring;
+}
+
+}  // namespace
+
+// Test that simple rings with holes are clipped into counter-clockwise
+// triangles that cover the rings without their holes
+TEST(Hoibase, MapEarClipTriangulator) {
+  EarClipTriangulator triangulator;
+  EXPECT_EQ(triangulator.getMeshQuality(), MeshQuality::ConstrainedOnly);
+
+  // Squares in both orientations
+  for (bool clockwise : {false, true}) {
+    auto square = createSquare(0, 0, 1, clockwise);
+    std::vector<ArrayView<Ogre::Vector2>> rings = {square};
+    auto triangles = triangulator.triangulate(rings);
+    EXPECT_EQ(triangles.size(), 2 * 9u);
+    EXPECT_NEAR(getCoveredArea(triangles), 1, 1e-4);
+  }
+
+  // Concave L shape with a repeated closing point
+  std::vector<Ogre::Vector2> shape = {
+      Ogre::Vector2(0, 0), Ogre::Vector2(2, 0), Ogre::Vector2(2, 1),
+      Ogre::Vector2(1, 1), Ogre::Vector2(1, 2), Ogre::Vector2(0, 2),
+      Ogre::Vector2(0, 0)};
+  std::vector<ArrayView<Ogre::Vector2>> shapeRings = {shape};
+  auto shapeTriangles = triangulator.triangulate(shapeRings);
+  EXPECT_EQ(shapeTriangles.size(), 4 * 9u);
+  EXPECT_NEAR(getCoveredArea(shapeTriangles), 3, 1e-4);
+
+  // Square with a hole, an island inside of the hole and a separate square
+  auto outer = createSquare(0, 0, 4, false);
+  auto hole = createSquare(1, 1, 2, false);
+  auto island = createSquare(1.5f, 1.5f, 1, true);
+  auto separate = createSquare(10, 0, 1, false);
+  std::vector<ArrayView<Ogre::Vector2>> rings = {hole, island, outer, separate};
+  std::vector<Ogre::Real> triangles;
+  ASSERT_TRUE(EarClipTriangulator::clip(rings, triangles));
+  EXPECT_EQ(triangles.size(), (8 + 2 + 2) * 9u);
+  EXPECT_NEAR(getCoveredArea(triangles), 16 - 4 + 1 + 1, 1e-3);
+}
+
+// Test that self-intersecting rings and rings that intersect each other are
+// handed over to CGAL
+TEST(Hoibase, MapEarClipTriangulatorFallback) {
+  std::vector<Ogre::Vector2> bowtie = {Ogre::Vector2(0, 0), Ogre::Vector2(1, 1),
+                                       Ogre::Vector2(1, 0),
+                                       Ogre::Vector2(0, 1)};
+  std::vector<ArrayView<Ogre::Vector2>> rings = {bowtie};
+
+  std::vector<Ogre::Real> triangles;
+  EXPECT_FALSE(EarClipTriangulator::clip(rings, triangles));
+  EXPECT_EQ(EarClipTriangulator().triangulate(rings),
+            CGALTriangulator(MeshQuality::ConstrainedOnly).triangulate(rings));
+
+  // A hole that crosses its outer ring, where both rings are simple
+  auto outer = createSquare(0, 0, 4, false);
+  auto hole = createSquare(3, 1, 2, true);
+  std::vector<ArrayView<Ogre::Vector2>> crossingRings = {outer, hole};
+  EXPECT_FALSE(EarClipTriangulator::clip(crossingRings, triangles));
+  EXPECT_TRUE(triangles.empty());
+  EXPECT_EQ(
+      EarClipTriangulator().triangulate(crossingRings),
+      CGALTriangulator(MeshQuality::ConstrainedOnly).triangulate(crossingRings));
+}
+
+// Test that ear clipping covers the same area as the CGAL triangulation, where
+// both leave out the holes
+TEST(Hoibase, MapEarClipTriangulatorArea) {
+  auto vec1 = getTestPentagon();
+  auto vec2 = getTestTriangle();
+
+  // Concave star with 7 spikes
+  const double pi = 3.14159265358979323846;
+  auto star = std::vector<Ogre::Vector2>();
+  for (int i = 0; i < 14; i++) {
+    Ogre::Real angle = (Ogre::Real)(i * pi / 7);
+    Ogre::Real radius = i % 2 == 0 ? 10.0f : 4.0f;
+    star.push_back(Ogre::Vector2(50 + radius * std::cos(angle),
+                                 20 + radius * std::sin(angle)));
+  }
+
+  // Square with a hole and an island inside of the hole
+  auto outer = createSquare(70, 40, 20, false);
+  auto hole = createSquare(75, 45, 10, false);
+  auto island = createSquare(78, 48, 3, true);
+
+  std::vector<ArrayView<Ogre::Vector2>> rings = {vec1,  vec2, star,
+                                                 outer, hole, island};
+  std::vector<Ogre::Real> triangles;
+  ASSERT_TRUE(EarClipTriangulator::clip(rings, triangles));
+  EarClipTriangulator earClip;
+  for (int i = 0; i < MeshQualityCount; i++) {
+    CGALTriangulator cgal((MeshQuality)i);
+    EXPECT_NEAR(getCoveredArea(earClip.triangulate(rings)),
+                getCoveredArea(cgal.triangulate(rings)), 1e-2);
+  }
+}
+
+}  // namespace openhoi
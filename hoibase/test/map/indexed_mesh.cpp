@@ -0,0 +1,58 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <hoibase/map/indexed_mesh.hpp>
+
+namespace openhoi {
+
+// Test that the indexed mesh merges repeated vertices
+TEST(Hoibase, MapIndexedMesh) {
+  // A unit square as two triangles
+  std::vector<Ogre::Real> triangles = {0, 0, 0, 1, 0, 0, 1, 1, 0,   // First
+                                       0, 0, 0, 1, 1, 0, 0, 1, 0};  // Second
+
+  auto mesh = IndexedMesh::fromTriangles(triangles);
+
+  ASSERT_EQ(mesh.getVertices().size(), 4u);
+  ASSERT_EQ(mesh.getIndexCount(), 6u);
+  EXPECT_FALSE(mesh.hasWideIndices());
+  EXPECT_EQ(mesh.getIndices16().size(), 6u);
+  EXPECT_TRUE(mesh.getIndices32().empty());
+  EXPECT_EQ(mesh.getIndex(3), mesh.getIndex(0));
+  EXPECT_EQ(mesh.getIndex(4), mesh.getIndex(2));
+  EXPECT_EQ(mesh.getVertices()[mesh.getIndex(5)], Ogre::Vector2(0, 1));
+  EXPECT_EQ(mesh.getMemorySize(), 4 * sizeof(Ogre::Vector2) + 6 * 2);
+  EXPECT_EQ(mesh.toTriangles(), triangles);
+
+  // An empty triangle list results in an empty mesh
+  auto empty = IndexedMesh::fromTriangles(std::vector<Ogre::Real>());
+  EXPECT_TRUE(empty.getVertices().empty());
+  EXPECT_EQ(empty.getIndexCount(), 0u);
+  EXPECT_EQ(empty.getMemorySize(), 0u);
+}
+
+// Test that the indices become 32 bit wide when 16 bit are not enough
+TEST(Hoibase, MapIndexedMeshWideIndices) {
+  // A strip of triangles with 70000 unique vertices
+  const size_t vertexCount = 70000;
+  std::vector<Ogre::Real> triangles;
+  for (size_t i = 0; i + 2 < vertexCount; i++) {
+    for (size_t j = i; j < i + 3; j++) {
+      triangles.push_back((Ogre::Real)(j / 2));
+      triangles.push_back((Ogre::Real)(j % 2));
+      triangles.push_back(0);
+    }
+  }
+
+  auto mesh = IndexedMesh::fromTriangles(triangles);
+
+  EXPECT_EQ(mesh.getVertices().size(), vertexCount);
+  EXPECT_TRUE(mesh.hasWideIndices());
+  EXPECT_TRUE(mesh.getIndices16().empty());
+  EXPECT_EQ(mesh.getIndices32().size(), (vertexCount - 2) * 3);
+  EXPECT_EQ(mesh.getIndex(mesh.getIndexCount() - 1), vertexCount - 1);
+  EXPECT_EQ(mesh.toTriangles(), triangles);
+}
+
+}  // namespace openhoi
@@ -0,0 +1,59 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <hoibase/file/file_access.hpp>
+#include <hoibase/file/mapped_file.hpp>
+#include <hoibase/map/map_compiler.hpp>
+#include <hoibase/map/map_factory.hpp>
+
+namespace openhoi {
+
+// Test that a compiled map loads back into the same provinces
+TEST(Hoibase, MapCompilerRoundTrip) {
+  auto ring1 = std::vector<Ogre::Vector2>();
+  ring1.push_back(Ogre::Vector2(-55.5f, 79.5f));
+  ring1.push_back(Ogre::Vector2(45.1f, 80.77f));
+  ring1.push_back(Ogre::Vector2(45.1f, -80.77f));
+
+  auto ring2 = std::vector<Ogre::Vector2>();
+  ring2.push_back(Ogre::Vector2(1.0f, 1.0f));
+  ring2.push_back(Ogre::Vector2(2.0f, 1.0f));
+  ring2.push_back(Ogre::Vector2(2.0f, 2.0f));
+  ring2.push_back(Ogre::Vector2(1.0f, 2.0f));
+
+  Map map(6378137);
+  map.addProvince(Province("first", {ring1}, Ogre::Vector2(-5.0f, 20.0f)));
+  map.addProvince(Province("second", {ring1, ring2}, Ogre::Vector2(1, 2)));
+
+  filesystem::path path =
+      FileAccess::getTempDirectory() / "openhoi_map_compiler_test.ohmap";
+  ASSERT_TRUE(MapCompiler::compile(map, path));
+
+  {
+    MappedFile file(path);
+    ASSERT_TRUE(file.isOpen());
+    EXPECT_TRUE(MapFactory::isCompiledMap(file.getData(), file.getSize()));
+
+    auto compiled =
+        MapFactory::parseCompiledMap(file.getData(), file.getSize());
+    EXPECT_EQ(compiled->getRadius(), 6378137);
+    auto const& expected = map.getProvinces();
+    auto const& actual = compiled->getProvinces();
+    ASSERT_EQ(actual.size(), 2u);
+    for (ProvinceHandle i = 0; i < expected.size(); i++) {
+      EXPECT_EQ(actual.getID(i), expected.getID(i));
+      EXPECT_EQ(actual.getRingCount(i), expected.getRingCount(i));
+      EXPECT_EQ(std::vector<Ogre::Vector2>(actual.getPoints(i).begin(),
+                                           actual.getPoints(i).end()),
+                std::vector<Ogre::Vector2>(expected.getPoints(i).begin(),
+                                           expected.getPoints(i).end()));
+      EXPECT_FLOAT_EQ(actual.getCenter(i).x, expected.getCenter(i).x);
+      EXPECT_FLOAT_EQ(actual.getCenter(i).y, expected.getCenter(i).y);
+    }
+  }
+
+  filesystem::remove(path);
+}
+
+}  // namespace openhoi
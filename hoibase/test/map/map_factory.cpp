@@ -0,0 +1,178 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <hoibase/map/map_factory.hpp>
+
+namespace openhoi {
+
+// Checks that both stores contain the same provinces with the same rings
+static void assertSameProvinces(ProvinceStore const& expected,
+                                ProvinceStore const& actual) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (ProvinceHandle i = 0; i < expected.size(); i++) {
+    ASSERT_EQ(actual.getID(i), expected.getID(i));
+    ASSERT_EQ(actual.getRingCount(i), expected.getRingCount(i));
+    for (size_t ring = 0; ring < expected.getRingCount(i); ring++) {
+      ASSERT_EQ(actual.getRing(i, ring).size(),
+                expected.getRing(i, ring).size());
+      for (size_t j = 0; j < expected.getRing(i, ring).size(); j++)
+        ASSERT_EQ(actual.getRing(i, ring)[j], expected.getRing(i, ring)[j]);
+    }
+  }
+}
+
+// Test that the streaming GeoJSON reader builds the same provinces as the
+// document parser
+TEST(Hoibase, MapFactoryStreamMatchesDocument) {
+  // Feature collection with a line string, a multi polygon with a hole, a
+  // feature with reordered members and features that have to be skipped
+  char const* geoJSON = R"({
+    "type": "FeatureCollection",
+    "features": [
+      {
+        "type": "Feature",
+        "properties": { "name": "P1" },
+        "geometry": {
+          "type": "LineString",
+          "coordinates": [[0.5, 0.5], [4.5, 0.5], [4.5, 4.5], [0.5, 0.5]]
+        }
+      },
+      {
+        "type": "Feature",
+        "properties": { "name": "P2", "type": "multipolygon" },
+        "geometry": {
+          "type": "MultiPolygon",
+          "coordinates": [
+            [
+              [[10.5, 10.5], [20.5, 10.5], [20.5, 20.5], [10.5, 10.5]],
+              [[12.5, 12.5], [14.5, 12.5], [14.5, 14.5], [12.5, 12.5]]
+            ],
+            [[[30.5, 30.5], [40.5, 30.5], [40.5, 40.5], [30.5, 30.5]]]
+          ]
+        }
+      },
+      {
+        "geometry": {
+          "coordinates": [[1.5, 1.5], [2.5, 1.5], [2, 2], [2.5, 2.5],
+                          [1.5, 1.5]],
+          "type": "LineString"
+        },
+        "properties": { "name": "P3" },
+        "type": "Feature"
+      },
+      {
+        "type": "Feature",
+        "properties": { "name": "P1" },
+        "geometry": {
+          "type": "LineString",
+          "coordinates": [[5.5, 5.5], [6.5, 5.5], [6.5, 6.5], [5.5, 5.5]]
+        }
+      },
+      {
+        "type": "Feature",
+        "properties": null,
+        "geometry": {
+          "type": "LineString",
+          "coordinates": [[5.5, 5.5], [6.5, 5.5], [6.5, 6.5], [5.5, 5.5]]
+        }
+      },
+      {
+        "type": "Feature",
+        "properties": { "name": "P4" },
+        "geometry": {
+          "type": "MultiPolygon",
+          "coordinates": [[[[5.5, 5.5], [6.5, 5.5], [6.5, 6.5], [5.5, 5.5]]]]
+        }
+      }
+    ]
+  })";
+  size_t size = strlen(geoJSON);
+
+  auto document = MapFactory::parseGeoJSON(geoJSON, size);
+  auto stream = MapFactory::streamGeoJSON(geoJSON, size);
+
+  // Both parsers have to build the same provinces
+  auto const& expected = document->getProvinces();
+  auto const& actual = stream->getProvinces();
+  ASSERT_EQ(expected.size(), (size_t)3);
+  assertSameProvinces(expected, actual);
+  ASSERT_EQ(actual.getRing(actual.find("P1"), 0).size(), (size_t)3);
+  ASSERT_EQ(actual.getRingCount(actual.find("P2")), (size_t)3);
+  ASSERT_EQ(actual.getRing(actual.find("P3"), 0).size(), (size_t)3);
+
+  // Invalid documents are rejected
+  char const* invalid = R"({"type": "Feature", "features": []})";
+  ASSERT_ANY_THROW(MapFactory::streamGeoJSON(invalid, strlen(invalid)));
+  char const* truncated = R"({"type": "FeatureCollection", "features": [)";
+  ASSERT_ANY_THROW(MapFactory::streamGeoJSON(truncated, strlen(truncated)));
+}
+
+// Test that both GeoJSON parsers always skip the last element of a ring, even
+// if it is no point, and skip empty rings
+TEST(Hoibase, MapFactoryStreamMatchesDocumentClosingPoint) {
+  // Rings that end with an integer point, a scalar, a single number and an
+  // open point, next to empty rings
+  char const* geoJSON = R"({
+    "type": "FeatureCollection",
+    "features": [
+      {
+        "type": "Feature",
+        "properties": { "name": "P1" },
+        "geometry": {
+          "type": "LineString",
+          "coordinates": [[0.5, 0.5], [4.5, 0.5], [4.5, 4.5], [0, 0]]
+        }
+      },
+      {
+        "type": "Feature",
+        "properties": { "name": "P2" },
+        "geometry": {
+          "type": "LineString",
+          "coordinates": [[0.5, 0.5], [4.5, 0.5], [4.5, 4.5], 1.5]
+        }
+      },
+      {
+        "type": "Feature",
+        "properties": { "name": "P3", "type": "multipolygon" },
+        "geometry": {
+          "type": "MultiPolygon",
+          "coordinates": [
+            [
+              [[10.5, 10.5], [20.5, 10.5], [20.5, 20.5], [10.5]],
+              [],
+              [[12.5, 12.5], [14.5, 12.5], [14.5, 14.5], [13.5, 16.5]]
+            ],
+            [[]]
+          ]
+        }
+      },
+      {
+        "type": "Feature",
+        "properties": { "name": "P4" },
+        "geometry": {
+          "type": "LineString",
+          "coordinates": []
+        }
+      }
+    ]
+  })";
+  size_t size = strlen(geoJSON);
+
+  auto document = MapFactory::parseGeoJSON(geoJSON, size);
+  auto stream = MapFactory::streamGeoJSON(geoJSON, size);
+
+  // Both parsers have to build the same provinces
+  auto const& expected = document->getProvinces();
+  auto const& actual = stream->getProvinces();
+  ASSERT_EQ(expected.size(), (size_t)3);
+  assertSameProvinces(expected, actual);
+  ASSERT_EQ(actual.getRing(actual.find("P1"), 0).size(), (size_t)3);
+  ASSERT_EQ(actual.getRing(actual.find("P2"), 0).size(), (size_t)3);
+  ASSERT_EQ(actual.getRingCount(actual.find("P3")), (size_t)2);
+  ASSERT_EQ(actual.getRing(actual.find("P3"), 0).size(), (size_t)3);
+  ASSERT_EQ(actual.getRing(actual.find("P3"), 1).size(), (size_t)3);
+}
+
+}  // namespace openhoi
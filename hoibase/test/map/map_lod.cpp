@@ -0,0 +1,106 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <hoibase/map/map_lod.hpp>
+
+namespace openhoi {
+
+// Gets the points of the rings that are also part of the provided points,
+// sorted so that they can be compared independent of the ring direction
+static std::vector<std::pair<Ogre::Real, Ogre::Real>> getSharedPoints(
+    ArrayView<ArrayView<Ogre::Vector2>> rings,
+    std::vector<Ogre::Vector2> const& candidates) {
+  std::vector<std::pair<Ogre::Real, Ogre::Real>> result;
+  for (auto const& ring : rings) {
+    for (auto const& point : ring) {
+      if (std::find(candidates.begin(), candidates.end(), point) !=
+          candidates.end())
+        result.push_back({point.x, point.y});
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+// Test that neighbouring provinces simplify their shared border identically
+TEST(Hoibase, MapLOD) {
+  // Zigzag border between a left and a right province
+  auto border = std::vector<Ogre::Vector2>();
+  for (int i = 0; i <= 40; i++) {
+    Ogre::Real offset = (i == 0 || i == 40) ? 0.0f : (i % 2 ? 0.1f : -0.1f);
+    border.push_back(Ogre::Vector2(10.0f + offset, (Ogre::Real)i * 0.25f));
+  }
+
+  // Lake inside of the left province
+  auto lake = std::vector<Ogre::Vector2>();
+  for (int i = 0; i < 32; i++) {
+    Ogre::Real angle = (Ogre::Real)i * 6.2831853f / 32.0f;
+    Ogre::Real radius = 2.0f + (i % 3 ? 0.05f : -0.05f);
+    lake.push_back(Ogre::Vector2(5.0f + radius * std::cos(angle),
+                                 5.0f + radius * std::sin(angle)));
+  }
+  auto hole = std::vector<Ogre::Vector2>(lake.rbegin(), lake.rend());
+
+  // The left province has a wavy coast, the right one is a plain rectangle
+  auto left = std::vector<Ogre::Vector2>(border.begin(), border.end());
+  for (int i = 40; i >= 0; i--) {
+    Ogre::Real offset = std::sin((Ogre::Real)i) * 0.3f;
+    left.push_back(Ogre::Vector2(offset, (Ogre::Real)i * 0.25f));
+  }
+  auto right = std::vector<Ogre::Vector2>(border.rbegin(), border.rend());
+  right.push_back(Ogre::Vector2(20.0f, 0.0f));
+  right.push_back(Ogre::Vector2(20.0f, 10.0f));
+
+  ProvinceStore store;
+  std::vector<ArrayView<Ogre::Vector2>> leftRings = {left, hole};
+  std::vector<ArrayView<Ogre::Vector2>> rightRings = {right};
+  std::vector<ArrayView<Ogre::Vector2>> lakeRings = {lake};
+  ProvinceHandle leftProvince = store.add("L", leftRings, Ogre::Vector2(0, 0));
+  ProvinceHandle rightProvince =
+      store.add("R", rightRings, Ogre::Vector2(0, 0));
+  ProvinceHandle lakeProvince = store.add("K", lakeRings, Ogre::Vector2(0, 0));
+
+  MapLOD lod(store, {0.05f, 0.5f, 5.0f});
+  ASSERT_EQ(lod.getLevelCount(), 4u);
+  EXPECT_EQ(lod.getTolerance(0), 0.0f);
+  EXPECT_EQ(lod.getTolerance(2), 0.5f);
+  EXPECT_EQ(lod.getPointCount(0), store.getPointCount());
+  EXPECT_EQ(lod.getRings(0, leftProvince).size(), 2u);
+
+  for (size_t level = 1; level < lod.getLevelCount(); level++) {
+    // Every level has fewer points than the one before
+    EXPECT_LT(lod.getPointCount(level), lod.getPointCount(level - 1));
+
+    // Both sides of every border keep the same points
+    EXPECT_EQ(getSharedPoints(lod.getRings(level, leftProvince), border),
+              getSharedPoints(lod.getRings(level, rightProvince), border));
+    EXPECT_EQ(getSharedPoints(lod.getRings(level, leftProvince), lake),
+              getSharedPoints(lod.getRings(level, lakeProvince), lake));
+
+    // No ring collapses
+    for (ProvinceHandle province = 0; province < store.size(); province++) {
+      EXPECT_EQ(lod.getRings(level, province).size(),
+                store.getRingCount(province));
+      for (auto const& ring : lod.getRings(level, province))
+        EXPECT_GE(ring.size(), 3u);
+    }
+  }
+
+  // The coarsest level only keeps the border ends and the most distant points
+  EXPECT_EQ(getSharedPoints(lod.getRings(3, rightProvince), border).size(),
+            3u);
+  EXPECT_EQ(lod.getRings(3, rightProvince)[0].size(), 5u);
+
+  // Levels are selected by the size of one pixel in map units
+  EXPECT_EQ(lod.selectLevel(0.01f), 0u);
+  EXPECT_EQ(lod.selectLevel(0.05f), 1u);
+  EXPECT_EQ(lod.selectLevel(1.0f), 2u);
+  EXPECT_EQ(lod.selectLevel(100.0f), 3u);
+  EXPECT_EQ(lod.selectLevel(1000.0f, 1.5707963f, 1000.0f), 2u);
+  EXPECT_EQ(lod.selectLevel(5000.0f, 1.5707963f, 1000.0f), 3u);
+}
+
+}  // namespace openhoi
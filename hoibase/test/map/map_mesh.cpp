@@ -0,0 +1,104 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <hoibase/map/map_mesh.hpp>
+
+namespace openhoi {
+
+// Test that all provinces are packed into one vertex and index buffer
+TEST(Hoibase, MapMesh) {
+  // Two unit squares next to each other, each triangulated into two triangles
+  ProvinceStore store;
+  for (int i = 0; i < 2; i++) {
+    Ogre::Real x = (Ogre::Real)i;
+    auto ring = std::vector<Ogre::Vector2>();
+    ring.push_back(Ogre::Vector2(x, 0.0f));
+    ring.push_back(Ogre::Vector2(x + 1.0f, 0.0f));
+    ring.push_back(Ogre::Vector2(x + 1.0f, 1.0f));
+    ring.push_back(Ogre::Vector2(x, 1.0f));
+    std::vector<ArrayView<Ogre::Vector2>> rings = {ring};
+    ProvinceHandle province =
+        store.add("P" + std::to_string(i), rings, Ogre::Vector2(0, 0));
+    store.setTriangulatedVertices(
+        province, {x, 0, 0, x + 1, 0, 0, x + 1, 1, 0,  // First triangle
+                   x, 0, 0, x + 1, 1, 0, x, 1, 0});    // Second triangle
+  }
+
+  MapMesh mesh(store);
+
+  // Shared vertices of a province are merged, but provinces do not share
+  // vertices, as every vertex carries its province
+  ASSERT_EQ(mesh.getVertices().size(), 8u);
+  ASSERT_EQ(mesh.getIndices().size(), 12u);
+  EXPECT_EQ(mesh.getIndexStart(0), 0u);
+  EXPECT_EQ(mesh.getIndexCount(0), 6u);
+  EXPECT_EQ(mesh.getIndexStart(1), 6u);
+  EXPECT_EQ(mesh.getIndexCount(1), 6u);
+  for (size_t i = 0; i < mesh.getIndices().size(); i++) {
+    auto const& vertex = mesh.getVertices()[mesh.getIndices()[i]];
+    EXPECT_EQ(vertex.province, i < 6 ? 0.0f : 1.0f);
+  }
+
+  // The second triangle of every province reuses two vertices of the first
+  EXPECT_EQ(mesh.getIndices()[3], mesh.getIndices()[0]);
+  EXPECT_EQ(mesh.getIndices()[4], mesh.getIndices()[2]);
+  EXPECT_EQ(mesh.getIndices()[9], mesh.getIndices()[6]);
+
+  EXPECT_EQ(mesh.getBounds().min, Ogre::Vector2(0.0f, 0.0f));
+  EXPECT_EQ(mesh.getBounds().max, Ogre::Vector2(2.0f, 1.0f));
+}
+
+// Test that single provinces are updated in place or moved to the end of the
+// buffers
+TEST(Hoibase, MapMeshUpdate) {
+  ProvinceStore store;
+  auto ring = std::vector<Ogre::Vector2>();
+  ring.push_back(Ogre::Vector2(0.0f, 0.0f));
+  ring.push_back(Ogre::Vector2(1.0f, 0.0f));
+  ring.push_back(Ogre::Vector2(1.0f, 1.0f));
+  ring.push_back(Ogre::Vector2(0.0f, 1.0f));
+  std::vector<ArrayView<Ogre::Vector2>> rings = {ring};
+  for (int i = 0; i < 2; i++) {
+    ProvinceHandle province =
+        store.add("P" + std::to_string(i), rings, Ogre::Vector2(0, 0));
+    store.setTriangulatedVertices(
+        province, {0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 0, 0, 1, 1, 0, 0, 1, 0});
+  }
+
+  MapMesh mesh(store);
+  EXPECT_FALSE(mesh.hasChanges());
+  ASSERT_EQ(mesh.getVertices().size(), 8u);
+  ASSERT_EQ(mesh.getIndices().size(), 12u);
+
+  // A single triangle fits into the old place of the second province, the
+  // rest of its old indices is collapsed
+  store.setTriangulatedVertices(1, {2, 0, 0, 3, 0, 0, 3, 1, 0});
+  mesh.updateProvinces(store, {1});
+  EXPECT_TRUE(mesh.hasChanges());
+  ASSERT_EQ(mesh.getVertices().size(), 8u);
+  ASSERT_EQ(mesh.getIndices().size(), 12u);
+  EXPECT_EQ(mesh.getIndexStart(1), 6u);
+  EXPECT_EQ(mesh.getIndexCount(1), 3u);
+  EXPECT_EQ(mesh.getVertices()[mesh.getIndices()[6]].x, 2.0f);
+  EXPECT_EQ(mesh.getIndices()[9], mesh.getIndices()[10]);
+  EXPECT_EQ(mesh.getIndices()[10], mesh.getIndices()[11]);
+  EXPECT_EQ(mesh.getBounds().max, Ogre::Vector2(3.0f, 1.0f));
+
+  // Three triangles do not fit into the old place of the first province, so
+  // it is moved to the end and its old indices are collapsed
+  store.setTriangulatedVertices(0, {0, 0, 0, 1, 0, 0, 1, 1, 0,  //
+                                    0, 0, 0, 1, 1, 0, 0, 1, 0,  //
+                                    0, 1, 0, 1, 1, 0, 0, 2, 0});
+  mesh.updateProvinces(store, {0});
+  ASSERT_EQ(mesh.getVertices().size(), 13u);
+  ASSERT_EQ(mesh.getIndices().size(), 21u);
+  EXPECT_EQ(mesh.getIndexStart(0), 12u);
+  EXPECT_EQ(mesh.getIndexCount(0), 9u);
+  for (size_t i = 1; i < 6; i++)
+    EXPECT_EQ(mesh.getIndices()[i], mesh.getIndices()[0]);
+  for (size_t i = 12; i < 21; i++)
+    EXPECT_EQ(mesh.getVertices()[mesh.getIndices()[i]].province, 0.0f);
+}
+
+}  // namespace openhoi
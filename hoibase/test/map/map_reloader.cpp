@@ -0,0 +1,106 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <fstream>
+#include <hoibase/file/file_access.hpp>
+#include <hoibase/map/map_factory.hpp>
+#include <hoibase/map/map_reloader.hpp>
+
+namespace openhoi {
+
+// Builds a feature collection with one square province per name, placed at
+// the provided x offsets
+static std::string buildSquares(std::vector<std::string> const& names,
+                                std::vector<int> const& offsets) {
+  std::string geoJSON = R"({"type": "FeatureCollection", "features": [)";
+  for (size_t i = 0; i < names.size(); i++) {
+    std::string x0 = std::to_string(offsets[i]) + ".0";
+    std::string x1 = std::to_string(offsets[i] + 1) + ".0";
+    if (i > 0) geoJSON += ",";
+    geoJSON += R"({"type": "Feature", "properties": {"name": ")" + names[i] +
+               R"("}, "geometry": {"type": "LineString", "coordinates": [[)" +
+               x0 + ", 0.0], [" + x1 + ", 0.0], [" + x1 + ", 1.0], [" + x0 +
+               ", 1.0], [" + x0 + ", 0.0]]}}";
+  }
+  return geoJSON + "]}";
+}
+
+// Test that two versions of a map are compared by province ID
+TEST(Hoibase, MapReloaderDiff) {
+  std::string before = buildSquares({"A", "B", "C"}, {0, 2, 4});
+  std::string after = buildSquares({"A", "B", "D"}, {0, 3, 6});
+  auto current = MapFactory::streamGeoJSON(before.data(), before.size());
+  auto updated = MapFactory::streamGeoJSON(after.data(), after.size());
+
+  MapDiff diff = MapReloader::diff(
+      static_cast<Map const&>(*current).getProvinces(),
+      static_cast<Map const&>(*updated).getProvinces());
+  EXPECT_EQ(diff.added, std::vector<std::string>({"D"}));
+  EXPECT_EQ(diff.changed, std::vector<std::string>({"B"}));
+  EXPECT_EQ(diff.removed, std::vector<std::string>({"C"}));
+}
+
+// Test that reloading a map file only re-triangulates the provinces that
+// changed
+TEST(Hoibase, MapReloader) {
+  filesystem::path path =
+      FileAccess::getTempDirectory() / "openhoi_map_reloader_test.geojson";
+  std::string before = buildSquares({"A", "B", "C"}, {0, 2, 4});
+  { std::ofstream(path) << before; }
+
+  auto map = MapFactory::streamGeoJSON(before.data(), before.size());
+  ProvinceStore const& provinces =
+      static_cast<Map const&>(*map).getProvinces();
+  for (ProvinceHandle i = 0; i < provinces.size(); i++)
+    provinces.getTriangulatedVertices(i);
+
+  // Mark the triangulation of the untouched province, so that a
+  // re-triangulation would be noticed. Modifying provinces without changing
+  // their rings keeps the spatial index
+  EXPECT_EQ(map->getProvinceAt(Ogre::Vector2(4.5f, 0.5f)), provinces.find("C"));
+  SpatialIndex const* index = &map->getSpatialIndex();
+  ProvinceHandle a = provinces.find("A");
+  map->getProvinces().setTriangulatedVertices(a, {1, 2, 0});
+  EXPECT_EQ(&map->getSpatialIndex(), index);
+
+  MapReloader reloader(path.u8string(), *map);
+  EXPECT_TRUE(reloader.poll().empty());
+
+  // Move B, remove C and add D
+  { std::ofstream(path) << buildSquares({"A", "B", "D"}, {0, 3, 6}); }
+  std::vector<ProvinceHandle> handles = reloader.poll();
+  ASSERT_EQ(handles.size(), 3u);
+  ProvinceHandle b = provinces.find("B");
+  ProvinceHandle c = provinces.find("C");
+  ProvinceHandle d = provinces.find("D");
+  ASSERT_NE(d, InvalidProvinceHandle);
+  EXPECT_EQ(d, 3u);
+  EXPECT_NE(std::find(handles.begin(), handles.end(), b), handles.end());
+  EXPECT_NE(std::find(handles.begin(), handles.end(), c), handles.end());
+  EXPECT_NE(std::find(handles.begin(), handles.end(), d), handles.end());
+
+  EXPECT_EQ(provinces.getTriangulatedVertices(a),
+            std::vector<Ogre::Real>({1, 2, 0}));
+  EXPECT_EQ(provinces.getRing(b, 0)[0], Ogre::Vector2(3, 0));
+  EXPECT_FALSE(provinces.getTriangulatedVertices(b).empty());
+  EXPECT_EQ(provinces.getRingCount(c), 0u);
+  EXPECT_TRUE(provinces.getTriangulatedVertices(c).empty());
+  EXPECT_FALSE(provinces.getTriangulatedVertices(d).empty());
+  EXPECT_EQ(provinces.getPointCount(), 3 * 4u);
+
+  // The derived structures were rebuilt
+  EXPECT_EQ(map->getProvinceAt(Ogre::Vector2(3.5f, 0.5f)), b);
+  EXPECT_EQ(map->getProvinceAt(Ogre::Vector2(4.5f, 0.5f)),
+            InvalidProvinceHandle);
+
+  // A broken file leaves the map untouched
+  { std::ofstream(path) << "{\"type\": "; }
+  EXPECT_TRUE(reloader.poll().empty());
+  EXPECT_EQ(provinces.size(), 4u);
+
+  filesystem::remove(path);
+}
+
+}  // namespace openhoi
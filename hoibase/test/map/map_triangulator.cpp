@@ -0,0 +1,43 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <hoibase/map/map_triangulator.hpp>
+
+#include "test_rings.hpp"
+
+namespace openhoi {
+
+// Test that the parallel map triangulation gathers all province vertices
+TEST(Hoibase, MapTriangulatorGathersProvinces) {
+  auto ring1 = getTestPentagon();
+  auto ring2 = getTestTriangle();
+
+  Map map(6378137);
+  map.addProvince(Province("first", {ring1}, Ogre::Vector2(0, 0)));
+  map.addProvince(Province("second", {ring2}, Ogre::Vector2(0, 0)));
+  map.addProvince(Province("both", {ring1, ring2}, Ogre::Vector2(0, 0)));
+
+  auto triangulation = MapTriangulator::triangulate(map, 2);
+
+  EXPECT_EQ(triangulation.getThreadCount(), 2u);
+  ASSERT_EQ(triangulation.getProvinces().size(), 3u);
+
+  size_t expectedOffset = 0;
+  for (auto const& province : triangulation.getProvinces()) {
+    EXPECT_EQ(map.getProvinces().getID(province.handle), province.id);
+    auto expected = map.getProvinces().getTriangulatedVertices(province.handle);
+    EXPECT_EQ(province.offset, expectedOffset);
+    ASSERT_EQ(province.size, expected.size());
+    for (size_t i = 0; i < expected.size(); i++)
+      EXPECT_FLOAT_EQ(triangulation.getVertices().at(province.offset + i),
+                      expected.at(i));
+    expectedOffset += province.size;
+  }
+  EXPECT_EQ(triangulation.getVertices().size(), expectedOffset);
+
+  // There are never more threads than provinces
+  EXPECT_EQ(MapTriangulator::triangulate(map, 8).getThreadCount(), 3u);
+}
+
+}  // namespace openhoi
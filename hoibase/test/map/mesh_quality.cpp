@@ -0,0 +1,25 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <hoibase/map/mesh_quality.hpp>
+
+namespace openhoi {
+
+// Test that the mesh quality presets can be named and parsed back
+TEST(Hoibase, MapMeshQuality) {
+  for (int i = 0; i < MeshQualityCount; i++) {
+    MeshQuality quality = DefaultMeshQuality;
+    EXPECT_TRUE(parseMeshQuality(getMeshQualityName((MeshQuality)i), quality));
+    EXPECT_EQ(quality, (MeshQuality)i);
+  }
+  EXPECT_EQ(getMeshQualityName(MeshQuality::ConstrainedOnly), "constrained");
+  EXPECT_EQ(getMeshQualityName(MeshQuality::RefinedLloyd), "refined-lloyd");
+
+  // Unknown names leave the quality untouched
+  MeshQuality quality = MeshQuality::Refined;
+  EXPECT_FALSE(parseMeshQuality("ultra", quality));
+  EXPECT_EQ(quality, MeshQuality::Refined);
+}
+
+}  // namespace openhoi
@@ -2,7 +2,12 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <hoibase/map/province.hpp>
+#include <hoibase/map/province_store.hpp>
+#include <memory>
+
+#include "test_rings.hpp"
 
 namespace openhoi {
 
@@ -28,17 +33,8 @@ TEST(Hoibase, MapProvinceCtor) {
 
 // The the province triangulation
 TEST(Hoibase, MapProviceTriangulate) {
-  auto vec1 = std::vector<Ogre::Vector2>();
-  vec1.push_back(Ogre::Vector2(-13.18359375f, 62.186013857194226f));
-  vec1.push_back(Ogre::Vector2(-22.587890625f, 50.45750402042058f));
-  vec1.push_back(Ogre::Vector2(14.677734375000002f, 34.95799531086792f));
-  vec1.push_back(Ogre::Vector2(28.388671875f, 52.3755991766591f));
-  vec1.push_back(Ogre::Vector2(9.052734375f, 65.58572002329473f));
-
-  auto vec2 = std::vector<Ogre::Vector2>();
-  vec2.push_back(Ogre::Vector2(26.630859375f, 41.902277040963696f));
-  vec2.push_back(Ogre::Vector2(35.419921875f, 37.85750715625203f));
-  vec2.push_back(Ogre::Vector2(31.289062500000004f, 46.01222384063236f));
+  auto vec1 = getTestPentagon();
+  auto vec2 = getTestTriangle();
 
   auto coords = std::vector<std::vector<Ogre::Vector2>>();
   coords.push_back(vec1);
@@ -89,4 +85,160 @@ TEST(Hoibase, MapProviceTriangulate) {
   EXPECT_FLOAT_EQ(triangles.at(52), 0.502444148f);
 }
 
+// Test that the indexed province mesh merges the vertices that are repeated by
+// the triangulation
+TEST(Hoibase, MapProvinceTriangulateIndexed) {
+  auto vec1 = getTestPentagon();
+  auto vec2 = getTestTriangle();
+
+  auto coords = std::vector<std::vector<Ogre::Vector2>>();
+  coords.push_back(vec1);
+  coords.push_back(vec2);
+
+  Province province("some_province", coords, Ogre::Vector2(0, 0));
+
+  auto const& triangles = province.getTriangulatedVertices();
+  auto const& mesh = province.getIndexedMesh();
+
+  // The province keeps the indexed mesh instead of the triangle list
+  EXPECT_EQ(&province.getIndexedMesh(), &mesh);
+
+  // 6 triangles with 18 corners share 10 unique vertices
+  EXPECT_EQ(mesh.getVertices().size(), 10u);
+  EXPECT_EQ(mesh.getIndexCount(), 18u);
+  EXPECT_FALSE(mesh.hasWideIndices());
+
+  // 10 vertices of 8 bytes and 18 indices of 2 bytes instead of 18 vertices of
+  // 12 bytes
+  EXPECT_EQ(triangles.size() * sizeof(Ogre::Real), 216u);
+  EXPECT_EQ(mesh.getMemorySize(), 116u);
+  EXPECT_EQ(mesh.toTriangles(), triangles);
+}
+
+// Test that all mesh quality presets cover the same area, while only the
+// refined ones insert additional vertices
+TEST(Hoibase, MapProvinceTriangulateQuality) {
+  auto vec = getTestPentagon();
+  std::vector<ArrayView<Ogre::Vector2>> rings = {vec};
+
+  auto area = [](std::vector<Ogre::Real> const& triangles) {
+    double sum = 0;
+    for (size_t i = 0; i + 8 < triangles.size(); i += 9)
+      sum += std::abs((triangles[i + 3] - triangles[i]) *
+                          (triangles[i + 7] - triangles[i + 1]) -
+                      (triangles[i + 6] - triangles[i]) *
+                          (triangles[i + 4] - triangles[i + 1])) /
+             2;
+    return sum;
+  };
+
+  // A pentagon is split into three triangles without additional vertices
+  auto constrained =
+      Province::triangulate(rings, MeshQuality::ConstrainedOnly);
+  EXPECT_EQ(constrained.size(), 27u);
+
+  auto refined = Province::triangulate(rings, MeshQuality::Refined);
+  auto lloyd = Province::triangulate(rings, MeshQuality::RefinedLloyd);
+  EXPECT_GE(refined.size(), constrained.size());
+  EXPECT_EQ(lloyd.size() % 9, 0u);
+  EXPECT_NEAR(area(refined), area(constrained), 1e-5);
+  EXPECT_NEAR(area(lloyd), area(constrained), 1e-5);
+
+  // The default preset is refined+Lloyd
+  EXPECT_EQ(Province::triangulate(rings), lloyd);
+}
+
+// Test that rings which do not span any face are triangulated into nothing
+// with every mesh quality preset
+TEST(Hoibase, MapProvinceTriangulateDegenerate) {
+  std::vector<Ogre::Vector2> collinear = {Ogre::Vector2(0, 0),
+                                          Ogre::Vector2(1, 1),
+                                          Ogre::Vector2(2, 2)};
+  std::vector<Ogre::Vector2> line = {Ogre::Vector2(0, 0), Ogre::Vector2(1, 0)};
+  std::vector<Ogre::Vector2> point = {Ogre::Vector2(0, 0)};
+
+  for (int i = 0; i < MeshQualityCount; i++) {
+    MeshQuality quality = (MeshQuality)i;
+    for (auto const& ring : {collinear, line, point}) {
+      std::vector<ArrayView<Ogre::Vector2>> rings = {ring};
+      EXPECT_TRUE(Province::triangulate(rings, quality).empty());
+    }
+    EXPECT_TRUE(
+        Province::triangulate(ArrayView<ArrayView<Ogre::Vector2>>(), quality)
+            .empty());
+  }
+}
+
+// Triangulator that counts how often it was invoked
+class CountingTriangulator final : public Triangulator {
+ public:
+  std::string getName() const override { return "counting"; }
+
+  MeshQuality getMeshQuality() const override {
+    return MeshQuality::ConstrainedOnly;
+  }
+
+  std::vector<Ogre::Real> triangulate(
+      ArrayView<ArrayView<Ogre::Vector2>> rings) const override {
+    calls++;
+    std::vector<Ogre::Real> vertices;
+    for (size_t i = 0; i < 3; i++)
+      appendVertex(vertices, rings[0][i].x, rings[0][i].y);
+    return vertices;
+  }
+
+  mutable int calls = 0;
+};
+
+// Test that the province triangulation is only rebuilt when required
+TEST(Hoibase, MapProvinceTriangulationCache) {
+  auto vec = getTestPentagon();
+  std::vector<ArrayView<Ogre::Vector2>> rings = {vec};
+
+  auto triangulator = std::make_shared<CountingTriangulator>();
+  ProvinceStore store;
+  store.setTriangulator(triangulator);
+  ProvinceHandle province = store.add("some_province", rings, vec[0]);
+
+  // Repeated accesses reuse the first triangulation
+  auto first = store.getTriangulatedVertices(province);
+  EXPECT_EQ(store.getTriangulatedVertices(province), first);
+  EXPECT_EQ(triangulator->calls, 1);
+
+  // Invalidating the triangulation rebuilds it exactly once
+  store.invalidateTriangulation(province);
+  EXPECT_EQ(store.getTriangulatedVertices(province), first);
+  EXPECT_EQ(store.getTriangulatedVertices(province), first);
+  EXPECT_EQ(triangulator->calls, 2);
+
+  // Changing the rings rebuilds it out of the new rings
+  std::vector<Ogre::Vector2> shifted(vec.begin() + 1, vec.end());
+  std::vector<ArrayView<Ogre::Vector2>> shiftedRings = {shifted};
+  store.setRings(province, shiftedRings);
+  EXPECT_NE(store.getTriangulatedVertices(province), first);
+  EXPECT_EQ(triangulator->calls, 3);
+
+  // A standalone province keeps its triangulation as well, so vertices that
+  // were set are returned until the triangulation is invalidated
+  auto coords = std::vector<std::vector<Ogre::Vector2>>();
+  coords.push_back(vec);
+  Province standalone("some_province", coords, Ogre::Vector2(0, 0));
+  std::vector<Ogre::Real> marker = {1, 2, 0};
+  standalone.setTriangulatedVertices(marker);
+  EXPECT_EQ(standalone.getTriangulatedVertices(), marker);
+  EXPECT_EQ(standalone.getTriangulatedVertices(), marker);
+  standalone.invalidateTriangulation();
+  auto const& rebuilt = standalone.getTriangulatedVertices();
+  EXPECT_NE(rebuilt, marker);
+  EXPECT_EQ(rebuilt.size() % 9, 0u);
+  auto rebuiltCopy = rebuilt;
+
+  // Changing the coordinates drops the triangulation, too
+  vec.resize(3);
+  coords.clear();
+  coords.push_back(vec);
+  standalone.setCoordinates(coords);
+  EXPECT_NE(standalone.getTriangulatedVertices(), rebuiltCopy);
+}
+
 }  // namespace openhoi
\ No newline at end of file
@@ -0,0 +1,69 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <hoibase/map/province_center.hpp>
+
+namespace openhoi {
+
+// Test that the pole of inaccessibility lies inside of concave provinces and
+// outside of their holes
+TEST(Hoibase, MapProvinceCenter) {
+  // Square: the center is the middle
+  std::vector<Ogre::Vector2> square = {
+      Ogre::Vector2(0, 0), Ogre::Vector2(10, 0), Ogre::Vector2(10, 10),
+      Ogre::Vector2(0, 10)};
+  std::vector<ArrayView<Ogre::Vector2>> rings = {square};
+  Ogre::Vector2 center = ProvinceCenter::compute(rings);
+  EXPECT_NEAR(center.x, 5, 0.01);
+  EXPECT_NEAR(center.y, 5, 0.01);
+
+  // L shape: the centroid is close to the inner corner at (5, 5), while the
+  // largest inscribed circle touches both outer sides and the inner corner, so
+  // its center (a, a) satisfies a = sqrt(2) * (5 - a)
+  std::vector<Ogre::Vector2> shape = {
+      Ogre::Vector2(0, 0), Ogre::Vector2(10, 0), Ogre::Vector2(10, 5),
+      Ogre::Vector2(5, 5), Ogre::Vector2(5, 10), Ogre::Vector2(0, 10)};
+  rings = {shape};
+  center = ProvinceCenter::compute(rings);
+  double expected = 5 * std::sqrt(2.0) / (1 + std::sqrt(2.0));
+  EXPECT_NEAR(center.x, expected, 0.05);
+  EXPECT_NEAR(center.y, expected, 0.05);
+
+  // Square with a hole in the middle: the center moves out of the hole
+  std::vector<Ogre::Vector2> hole = {Ogre::Vector2(2, 2), Ogre::Vector2(8, 2),
+                                     Ogre::Vector2(8, 8), Ogre::Vector2(2, 8)};
+  rings = {square, hole};
+  center = ProvinceCenter::compute(rings);
+  EXPECT_TRUE(center.x < 2 || center.x > 8 || center.y < 2 || center.y > 8);
+
+  // Provinces without rings or area
+  EXPECT_EQ(ProvinceCenter::compute(ArrayView<ArrayView<Ogre::Vector2>>()),
+            Ogre::Vector2(0, 0));
+  std::vector<Ogre::Vector2> line = {Ogre::Vector2(0, 0), Ogre::Vector2(4, 0)};
+  rings = {line};
+  EXPECT_EQ(ProvinceCenter::compute(rings), Ogre::Vector2(2, 0));
+}
+
+// Test that the centers of all provinces of a store are computed
+TEST(Hoibase, MapProvinceCenters) {
+  ProvinceStore store;
+  for (int i = 0; i < 100; i++) {
+    Ogre::Real x = (Ogre::Real)(i * 20);
+    std::vector<Ogre::Vector2> ring = {
+        Ogre::Vector2(x, 0), Ogre::Vector2(x + 10, 0),
+        Ogre::Vector2(x + 10, 10), Ogre::Vector2(x, 10)};
+    std::vector<ArrayView<Ogre::Vector2>> rings = {ring};
+    store.add("P" + std::to_string(i), rings, Ogre::Vector2(0, 0));
+  }
+
+  ProvinceCenter::computeCenters(store, 4);
+  for (ProvinceHandle i = 0; i < store.size(); i++) {
+    EXPECT_NEAR(store.getCenter(i).x, i * 20 + 5, 0.01);
+    EXPECT_NEAR(store.getCenter(i).y, 5, 0.01);
+  }
+}
+
+}  // namespace openhoi
@@ -0,0 +1,86 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <hoibase/map/ear_clip_triangulator.hpp>
+#include <hoibase/map/province_store.hpp>
+
+namespace openhoi {
+
+// Test that the province store keeps the rings of all provinces contiguous
+TEST(Hoibase, MapProvinceStore) {
+  auto ring1 = std::vector<Ogre::Vector2>();
+  ring1.push_back(Ogre::Vector2(0.0f, 0.0f));
+  ring1.push_back(Ogre::Vector2(4.0f, 0.0f));
+  ring1.push_back(Ogre::Vector2(4.0f, 4.0f));
+  auto ring2 = std::vector<Ogre::Vector2>();
+  ring2.push_back(Ogre::Vector2(1.0f, 1.0f));
+  ring2.push_back(Ogre::Vector2(2.0f, 1.0f));
+  ring2.push_back(Ogre::Vector2(2.0f, 2.0f));
+  ring2.push_back(Ogre::Vector2(1.0f, 2.0f));
+
+  std::vector<ArrayView<Ogre::Vector2>> rings1 = {ring1};
+  std::vector<ArrayView<Ogre::Vector2>> rings2 = {ring1, ring2};
+
+  ProvinceStore store;
+  EXPECT_TRUE(store.empty());
+  ProvinceHandle first = store.add("first", rings1, Ogre::Vector2(1, 2));
+  ProvinceHandle second = store.add("second", rings2, Ogre::Vector2(3, 4));
+
+  // Handles are dense and the index maps IDs to handles
+  EXPECT_EQ(first, 0u);
+  EXPECT_EQ(second, 1u);
+  ASSERT_EQ(store.size(), 2u);
+  EXPECT_EQ(store.find("first"), first);
+  EXPECT_EQ(store.find("second"), second);
+  EXPECT_EQ(store.find("third"), InvalidProvinceHandle);
+  EXPECT_EQ(store.getID(second), "second");
+  EXPECT_EQ(store.getCenter(second), Ogre::Vector2(3, 4));
+
+  // Rings are views into the arena and the points of one province are
+  // contiguous
+  ASSERT_EQ(store.getRingCount(first), 1u);
+  ASSERT_EQ(store.getRingCount(second), 2u);
+  ASSERT_EQ(store.getRings(second).size(), 2u);
+  ASSERT_EQ(store.getRing(second, 1).size(), ring2.size());
+  for (size_t i = 0; i < ring2.size(); i++)
+    EXPECT_EQ(store.getRing(second, 1)[i], ring2[i]);
+  EXPECT_EQ(store.getPointCount(), 2 * ring1.size() + ring2.size());
+  EXPECT_EQ(store.getPoints(second).begin(), store.getRing(second, 0).begin());
+  EXPECT_EQ(store.getPoints(second).end(), store.getRing(second, 1).end());
+  EXPECT_EQ(store.getRingOffsets(), std::vector<uint32_t>({0, 1, 3}));
+  EXPECT_EQ(store.getRings().size(), 3u);
+
+  // Adding provinces never moves the points of the previous ones
+  auto firstRing = store.getRing(first, 0);
+  for (int i = 0; i < 1000; i++)
+    store.add("more" + std::to_string(i), rings1, Ogre::Vector2(0, 0));
+  EXPECT_EQ(store.getRing(first, 0).begin(), firstRing.begin());
+  EXPECT_EQ(firstRing[2], ring1[2]);
+  EXPECT_EQ(store.getArena().getBlockCount(), 1u);
+
+  // Triangulations are kept per handle as indexed meshes
+  std::vector<Ogre::Real> vertices = {1, 2, 0};
+  store.setTriangulatedVertices(first, vertices);
+  EXPECT_EQ(store.getTriangulatedVertices(first), vertices);
+  EXPECT_EQ(store.getIndexedMesh(first).getVertices().size(), 1u);
+  store.invalidateTriangulation(first);
+  EXPECT_NE(store.getTriangulatedVertices(first), vertices);
+
+  // Changing the mesh quality drops all triangulations
+  EXPECT_EQ(store.getMeshQuality(), DefaultMeshQuality);
+  store.setTriangulatedVertices(first, vertices);
+  store.setMeshQuality(DefaultMeshQuality);
+  EXPECT_EQ(store.getTriangulatedVertices(first), vertices);
+  store.setMeshQuality(MeshQuality::ConstrainedOnly);
+  EXPECT_EQ(store.getMeshQuality(), MeshQuality::ConstrainedOnly);
+  EXPECT_NE(store.getTriangulatedVertices(first), vertices);
+
+  // Changing the triangulator drops all triangulations as well
+  store.setTriangulatedVertices(first, vertices);
+  store.setTriangulator(std::make_shared<EarClipTriangulator>());
+  EXPECT_EQ(store.getTriangulator().getName(), "ear-clipping-constrained");
+  EXPECT_NE(store.getTriangulatedVertices(first), vertices);
+}
+
+}  // namespace openhoi
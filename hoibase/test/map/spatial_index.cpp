@@ -0,0 +1,64 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <hoibase/map/spatial_index.hpp>
+
+namespace openhoi {
+
+// Test picking and rectangle queries of the spatial index
+TEST(Hoibase, MapSpatialIndex) {
+  // Four unit squares in a row, where the last one has a hole in its center
+  ProvinceStore store;
+  for (int i = 0; i < 4; i++) {
+    auto outer = std::vector<Ogre::Vector2>();
+    outer.push_back(Ogre::Vector2((Ogre::Real)i, 0.0f));
+    outer.push_back(Ogre::Vector2((Ogre::Real)i + 1.0f, 0.0f));
+    outer.push_back(Ogre::Vector2((Ogre::Real)i + 1.0f, 1.0f));
+    outer.push_back(Ogre::Vector2((Ogre::Real)i, 1.0f));
+    auto hole = std::vector<Ogre::Vector2>();
+    hole.push_back(Ogre::Vector2((Ogre::Real)i + 0.25f, 0.25f));
+    hole.push_back(Ogre::Vector2((Ogre::Real)i + 0.75f, 0.25f));
+    hole.push_back(Ogre::Vector2((Ogre::Real)i + 0.75f, 0.75f));
+    hole.push_back(Ogre::Vector2((Ogre::Real)i + 0.25f, 0.75f));
+
+    std::vector<ArrayView<Ogre::Vector2>> rings = {outer};
+    if (i == 3) rings.push_back(hole);
+    store.add("P" + std::to_string(i), rings, Ogre::Vector2(0, 0));
+  }
+
+  SpatialIndex index(store);
+  EXPECT_EQ(index.getBounds().min, Ogre::Vector2(0.0f, 0.0f));
+  EXPECT_EQ(index.getBounds().max, Ogre::Vector2(4.0f, 1.0f));
+  EXPECT_EQ(index.getBounds(2).min, Ogre::Vector2(2.0f, 0.0f));
+
+  // Points inside, outside and inside of the hole
+  EXPECT_EQ(index.pick(Ogre::Vector2(0.5f, 0.5f)), 0u);
+  EXPECT_EQ(index.pick(Ogre::Vector2(2.1f, 0.9f)), 2u);
+  EXPECT_EQ(index.pick(Ogre::Vector2(3.1f, 0.5f)), 3u);
+  EXPECT_EQ(index.pick(Ogre::Vector2(3.5f, 0.5f)), InvalidProvinceHandle);
+  EXPECT_EQ(index.pick(Ogre::Vector2(-1.0f, 0.5f)), InvalidProvinceHandle);
+  EXPECT_EQ(index.pick(Ogre::Vector2(1.5f, 2.0f)), InvalidProvinceHandle);
+
+  // Every province is reported once, even if it spans multiple cells
+  SpatialIndex coarse(store, 1);
+  SpatialIndex fine(store, 64);
+  for (SpatialIndex const* grid : {&index, &coarse, &fine}) {
+    auto result = grid->query(Ogre::Vector2(0.5f, 0.2f),
+                              Ogre::Vector2(2.5f, 0.4f));
+    std::sort(result.begin(), result.end());
+    EXPECT_EQ(result, std::vector<ProvinceHandle>({0, 1, 2}));
+
+    result = grid->query(Ogre::Vector2(-10.0f, -10.0f),
+                         Ogre::Vector2(10.0f, 10.0f));
+    std::sort(result.begin(), result.end());
+    EXPECT_EQ(result, std::vector<ProvinceHandle>({0, 1, 2, 3}));
+
+    EXPECT_TRUE(
+        grid->query(Ogre::Vector2(5.0f, 0.0f), Ogre::Vector2(6.0f, 1.0f))
+            .empty());
+  }
+}
+
+}  // namespace openhoi
@@ -0,0 +1,28 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#pragma once
+
+#include <Ogre.h>
+
+#include <vector>
+
+namespace openhoi {
+
+// Gets the pentagon that is used as province ring by the map tests
+inline std::vector<Ogre::Vector2> getTestPentagon() {
+  return {Ogre::Vector2(-13.18359375f, 62.186013857194226f),
+          Ogre::Vector2(-22.587890625f, 50.45750402042058f),
+          Ogre::Vector2(14.677734375000002f, 34.95799531086792f),
+          Ogre::Vector2(28.388671875f, 52.3755991766591f),
+          Ogre::Vector2(9.052734375f, 65.58572002329473f)};
+}
+
+// Gets the triangle that is used as second province ring next to the test
+// pentagon by the map tests
+inline std::vector<Ogre::Vector2> getTestTriangle() {
+  return {Ogre::Vector2(26.630859375f, 41.902277040963696f),
+          Ogre::Vector2(35.419921875f, 37.85750715625203f),
+          Ogre::Vector2(31.289062500000004f, 46.01222384063236f)};
+}
+
+}  // namespace openhoi
@@ -0,0 +1,85 @@
+// Copyright 2020 the openhoi authors. See COPYING.md for legal info.
+
+#include <boost/program_options.hpp>
+#include <hoibase/file/mapped_file.hpp>
+#include <hoibase/map/map_compiler.hpp>
+#include <hoibase/map/map_factory.hpp>
+#include <hoibase/map/province_center.hpp>
+#include <hoibase/openhoi.hpp>
+#include <iostream>
+
+#define TITLE OPENHOI_GAME_NAME " map compiler v" OPENHOI_GAME_VERSION
+
+namespace po = boost::program_options;
+
+using namespace openhoi;
+
+// Main entry point of program
+int main(int argc, const char* argv[]) {
+  // Print out header
+  std::cout << TITLE << std::endl;
+  std::cout << "Copyright (c) the openhoi authors" << std::endl;
+  std::cout << OPENHOI_GIT_URL << std::endl << std::endl;
+
+  // Parse program options
+  filesystem::path inputFile, outputFile;
+  po::options_description desc("Options");
+  desc.add_options()("help", "Produce help message")(
+      "input", po::value<filesystem::path>(&inputFile)->required(),
+      "Path to the GeoJSON map file")(
+      "output", po::value<filesystem::path>(&outputFile),
+      "Path to the compiled map file (defaults to the input file with the "
+      "extension '.ohmap')");
+  po::positional_options_description positional;
+  positional.add("input", 1).add("output", 1);
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv)
+                  .options(desc)
+                  .positional(positional)
+                  .run(),
+              vm);
+    if (vm.count("help")) {
+      std::cout << desc << std::endl;
+      return EXIT_SUCCESS;
+    }
+    po::notify(vm);
+  } catch (po::error const& e) {
+    std::cerr << e.what() << std::endl << std::endl << desc << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (outputFile.empty()) {
+    outputFile = inputFile;
+    outputFile.replace_extension(".ohmap");
+  }
+
+  // Parse the GeoJSON map file
+  std::unique_ptr<Map> map;
+  try {
+    MappedFile file(inputFile, MappedFileAccess::Sequential);
+    if (!file.isOpen()) {
+      std::cerr << "Unable to read map file '" << inputFile.u8string() << "'"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    map = MapFactory::streamGeoJSON(
+        reinterpret_cast<const char*>(file.getData()), file.getSize());
+  } catch (std::exception const& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Compute the province centers, so that loading the compiled map skips it
+  ProvinceCenter::computeCenters(map->getProvinces());
+
+  // Write the compiled map file
+  if (!MapCompiler::compile(*map, outputFile)) {
+    std::cerr << "Unable to write compiled map file '"
+              << outputFile.u8string() << "'" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Compiled " << map->getProvinces().size() << " provinces into '"
+            << outputFile.u8string() << "'" << std::endl;
+  return EXIT_SUCCESS;
+}